@@ -0,0 +1,33 @@
+cmake_minimum_required(VERSION 3.10)
+
+include(ExternalProject)
+
+find_package(Threads REQUIRED)
+
+set(source_dir ${CMAKE_BINARY_DIR}/googlebenchmark-src)
+set(build_dir ${CMAKE_BINARY_DIR}/googlebenchmark-build)
+set(work_dir ${CMAKE_BINARY_DIR}/googlebenchmark-workspace)
+
+EXTERNALPROJECT_ADD(
+  googlebenchmark
+  GIT_REPOSITORY    https://github.com/google/benchmark.git
+  GIT_TAG           main
+  PATCH_COMMAND     ""
+  PREFIX            ${work_dir}
+  SOURCE_DIR        ${source_dir}
+  BINARY_DIR        ${build_dir}
+  CMAKE_ARGS        -D CMAKE_INSTALL_PREFIX=${work_dir}
+                    -D CMAKE_BUILD_TYPE=Release
+                    -D BENCHMARK_ENABLE_TESTING=OFF
+                    -D BENCHMARK_ENABLE_GTEST_TESTS=OFF
+  UPDATE_COMMAND    ""
+  INSTALL_COMMAND   ""
+)
+
+include_directories(${source_dir}/include)
+link_directories(${build_dir}/src)
+
+# robot libraries are shared with main project when built as its part
+if(NOT TARGET libhttp)
+  include(${CMAKE_CURRENT_LIST_DIR}/../../cmake/dependencies.cmake)
+endif()
@@ -0,0 +1,22 @@
+cmake_minimum_required(VERSION 3.10)
+
+set(CMAKE_CXX_FLAGS_RELEASE "${CMAKE_CXX_FLAGS_RELEASE} \
+  -Ofast \
+  -flto"
+)
+
+set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} \
+-Wall \
+-Wextra \
+-Wconversion \
+-Wnon-virtual-dtor \
+-Wpointer-arith \
+-Wcast-qual \
+-Wno-sign-conversion \
+-Woverloaded-virtual \
+-Wpointer-arith \
+-Wcast-qual \
+-Wno-strict-aliasing"
+#   -pedantic \
+#   -Wshadow \
+)
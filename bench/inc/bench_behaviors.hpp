@@ -0,0 +1,64 @@
+#include "mockarm.hpp"
+#include "mockrobot.hpp"
+#include "robot/interfaces/roarmm2.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stop_token>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+// Dance behavior on mocked robot from its start until given number of
+// setpoints is streamed, its stop and return to base pose included
+static void BM_DanceIteration(benchmark::State& state)
+{
+    static constexpr uint64_t dancesetpoints = 32;
+    auto arm = std::make_shared<MockArm>();
+    auto robot = getmockasyncrobot(arm);
+    uint64_t requests{}, setpoints{};
+    for (auto _ : state)
+    {
+        auto startrequests = arm->getrequests();
+        auto startsetpoints = arm->getsetpoints();
+        std::stop_source stop;
+        auto done = robot->danceasync(stop.get_token(), {});
+        while (arm->getsetpoints() - startsetpoints < dancesetpoints &&
+               done.wait_for(1ms) != std::future_status::ready)
+        {}
+        stop.request_stop();
+        benchmark::DoNotOptimize(done.get());
+        requests += arm->getrequests() - startrequests;
+        setpoints += arm->getsetpoints() - startsetpoints;
+    }
+    state.counters["requests"] = benchmark::Counter(
+        (double)requests, benchmark::Counter::kAvgIterations);
+    state.counters["setpoints"] = benchmark::Counter(
+        (double)setpoints, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_DanceIteration)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Shakehand behavior on mocked robot, hand pushes resting arm and holds
+// gripper, so greeting is completed
+static void BM_ShakehandDetection(benchmark::State& state)
+{
+    auto arm = std::make_shared<MockArm>(true);
+    auto robot = getmockasyncrobot(arm);
+    uint64_t requests{}, greeted{};
+    for (auto _ : state)
+    {
+        auto startrequests = arm->getrequests();
+        greeted += robot->shakehandasync({}, {}).get() ? 1 : 0;
+        requests += arm->getrequests() - startrequests;
+    }
+    state.counters["requests"] = benchmark::Counter(
+        (double)requests, benchmark::Counter::kAvgIterations);
+    state.counters["greeted"] = benchmark::Counter(
+        (double)greeted, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ShakehandDetection)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+#include "http/interfaces/http.hpp"
+#include "robot/commands.hpp"
+
+#include "benchmark/benchmark.h"
+
+using namespace robot::roarmm2;
+
+// Command built as generic http input map, before typed commands
+static void BM_CommandMapBuild(benchmark::State& state)
+{
+    int32_t angle{};
+    for (auto _ : state)
+    {
+        http::inputtype in{{"T", 121},
+                           {"joint", 4},
+                           {"angle", angle++ % 180},
+                           {"spd", 50},
+                           {"acc", 10}};
+        benchmark::DoNotOptimize(in);
+    }
+}
+BENCHMARK(BM_CommandMapBuild);
+
+static void BM_CommandEncode(benchmark::State& state)
+{
+    command::Encoder encoder;
+    int32_t angle{};
+    for (auto _ : state)
+    {
+        auto json = encoder.encode(command::MoveJoint{
+            .joint = 4, .angle = angle++ % 180, .spd = 50, .acc = 10});
+        benchmark::DoNotOptimize(json.data());
+    }
+}
+BENCHMARK(BM_CommandEncode);
+
+static void BM_CommandPoseMapBuild(benchmark::State& state)
+{
+    double t{};
+    for (auto _ : state)
+    {
+        http::inputtype in{{"T", 1041}, {"x", 175}, {"y", 235},
+                           {"z", 325},  {"t", t}};
+        t += 0.001;
+        benchmark::DoNotOptimize(in);
+    }
+}
+BENCHMARK(BM_CommandPoseMapBuild);
+
+static void BM_CommandPoseEncode(benchmark::State& state)
+{
+    command::Encoder encoder;
+    double t{};
+    for (auto _ : state)
+    {
+        auto json = encoder.encode(
+            command::MoveXYZTDirect{.x = 175, .y = 235, .z = 325, .t = t});
+        t += 0.001;
+        benchmark::DoNotOptimize(json.data());
+    }
+}
+BENCHMARK(BM_CommandPoseEncode);
+
+static void BM_CommandFeedbackMapBuild(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        http::inputtype in{{"T", 105}};
+        benchmark::DoNotOptimize(in);
+    }
+}
+BENCHMARK(BM_CommandFeedbackMapBuild);
+
+static void BM_CommandFeedbackPreserialized(benchmark::State& state)
+{
+    command::Encoder encoder;
+    for (auto _ : state)
+    {
+        auto json = encoder.encode(command::Feedback{});
+        benchmark::DoNotOptimize(json.data());
+    }
+}
+BENCHMARK(BM_CommandFeedbackPreserialized);
@@ -0,0 +1,24 @@
+#include "robot/feedbackdecoder.hpp"
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+using namespace robot::roarmm2;
+
+static void BM_FeedbackDecode(benchmark::State& state)
+{
+    const std::string response{
+        "{\"T\":1051,\"x\":309.6,\"y\":-0.57,\"z\":239.34,"
+        "\"b\":-0.0015,\"s\":-0.0046,\"e\":1.5661,\"t\":3.1416,"
+        "\"torB\":0,\"torS\":-64,\"torE\":12,\"torH\":0}"};
+    servofeedback_t feedback{};
+    for (auto _ : state)
+    {
+        auto error = decode(response, feedback);
+        benchmark::DoNotOptimize(error);
+        benchmark::DoNotOptimize(feedback);
+    }
+    state.SetBytesProcessed((int64_t)(state.iterations() * response.size()));
+}
+BENCHMARK(BM_FeedbackDecode);
@@ -0,0 +1,143 @@
+#include "http/interfaces/http.hpp"
+#include "mockrobot.hpp"
+#include "robot/commands.hpp"
+#include "robot/fleet.hpp"
+#include "robot/interfaces/roarmm2.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+using namespace robot;
+
+// Local mock of arm controller, answers after fixed network latency
+class MockController : public http::HttpIf
+{
+  public:
+    bool get(const http::inputtype&, http::outputtype&) override
+    {
+        return false;
+    }
+
+    bool get(const http::inputtype&, std::string&) override
+    {
+        return false;
+    }
+
+    bool get(const std::string& in, std::string& out) override
+    {
+        std::this_thread::sleep_for(latency);
+        out = in == "{\"T\":105}"
+                  ? "{\"T\":1051,\"x\":309.6,\"y\":-0.57,\"z\":239.34,"
+                    "\"b\":-0.0015,\"s\":-0.0046,\"e\":1.5661,\"t\":3.1416,"
+                    "\"torB\":0,\"torS\":-64,\"torE\":12,\"torH\":0}"
+                  : "{}";
+        return true;
+    }
+
+    std::string info() override
+    {
+        return "mock";
+    }
+
+  private:
+    static constexpr auto latency = std::chrono::milliseconds(2);
+};
+
+static std::vector<arm_t> getmockarms(int64_t num)
+{
+    std::vector<arm_t> arms;
+    for (int64_t idx{}; idx < num; idx++)
+    {
+        arms.push_back(
+            {"arm" + std::to_string(idx), std::make_shared<MockController>()});
+    }
+    return arms;
+}
+
+static void BM_FleetBroadcast(benchmark::State& state)
+{
+    Fleet fleet(getmockarms(state.range(0)), (uint32_t)state.range(1));
+    auto json = roarmm2::command::tojson(roarmm2::command::SetLed{.led = 10});
+    for (auto _ : state)
+    {
+        for (auto& resp : fleet.broadcast(json))
+        {
+            benchmark::DoNotOptimize(resp.get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FleetBroadcast)
+    ->ArgsProduct({{8, 32, 64}, {1, 8, 32}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_FleetTelemetry(benchmark::State& state)
+{
+    Fleet fleet(getmockarms(state.range(0)), (uint32_t)state.range(1));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(fleet.sampletelemetry());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FleetTelemetry)
+    ->ArgsProduct({{8, 32, 64}, {8, 32}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static double getthreads()
+{
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.starts_with("Threads:"))
+        {
+            return std::stod(line.substr(8));
+        }
+    }
+    return 0.;
+}
+
+// Servos read by robots of all arms at once, robots share one runtime, so
+// threads added per arm are only ones talking to it
+static void BM_FleetRobots(benchmark::State& state)
+{
+    auto arms = (uint32_t)state.range(0);
+    auto threads = getthreads();
+    auto runtime = std::make_shared<roarmm2::Runtime>(arms);
+    Fleet fleet(getmockarms(arms), 8,
+                [runtime](std::shared_ptr<http::HttpIf> httpIf) {
+                    return RobotFactory::create<roarmm2::Robot>(
+                        httpIf, nullptr, std::make_shared<SinkLog>(),
+                        runtime);
+                });
+    std::vector<std::shared_ptr<RobotIf>> robots;
+    for (size_t arm{}; arm < fleet.size(); arm++)
+    {
+        robots.push_back(fleet.getrobot(arm));
+    }
+    for (auto _ : state)
+    {
+        std::vector<std::jthread> readers;
+        for (auto& robot : robots)
+        {
+            readers.emplace_back([robot]() {
+                benchmark::DoNotOptimize(robot->readservosinfo(false));
+            });
+        }
+    }
+    state.counters["threads_per_arm"] = (getthreads() - threads) / arms;
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FleetRobots)
+    ->Arg(8)
+    ->Arg(32)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
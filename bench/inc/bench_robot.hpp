@@ -0,0 +1,60 @@
+#include "mockrobot.hpp"
+#include "robot/ttstexts.hpp"
+
+#include "benchmark/benchmark.h"
+
+using namespace robot;
+
+// Map request and getstrfromhttp formatting of its response
+static void BM_RobotWifiInfo(benchmark::State& state)
+{
+    auto robot = getmockrobot();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(robot->readwifiinfo(false));
+    }
+}
+BENCHMARK(BM_RobotWifiInfo);
+
+static void BM_RobotServosInfo(benchmark::State& state)
+{
+    auto robot = getmockrobot();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(robot->readservosinfo(false));
+    }
+}
+BENCHMARK(BM_RobotServosInfo);
+
+// Gripper travel with seteoat convergence loop polling feedback
+static void BM_RobotEoatConvergence(benchmark::State& state)
+{
+    auto robot = getmockrobot();
+    bool open{};
+    for (auto _ : state)
+    {
+        open = !open;
+        benchmark::DoNotOptimize(open ? robot->openeoat(false)
+                                      : robot->closeeoat(false));
+    }
+}
+BENCHMARK(BM_RobotEoatConvergence)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_TtsTextLookup(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (auto what = (int32_t)task::initiatating;
+             what <= (int32_t)task::nothingtodo; what++)
+        {
+            for (auto lang : {tts::language::polish, tts::language::english,
+                              tts::language::german})
+            {
+                benchmark::DoNotOptimize(getttstext((task)what, lang));
+            }
+        }
+    }
+}
+BENCHMARK(BM_TtsTextLookup);
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <numbers>
+#include <string>
+#include <string_view>
+
+// In-process mock of arm controller, arm and gripper follow their setpoints
+// with limited speed and feedback reflects current state; with hand enabled
+// it pushes resting arm back and forth and holds gripper from closing
+class MockArm : public http::HttpIf
+{
+  public:
+    explicit MockArm(bool hand = false) : hand{hand}
+    {}
+
+    bool get(const http::inputtype& in, http::outputtype& out) override
+    {
+        switch (std::get<int32_t>(in.at("T")))
+        {
+            case 405:
+                out = {{"ip", std::string{"192.168.4.1"}},
+                       {"rssi", -42.},
+                       {"ssid", std::string{"RoArm-M2"}},
+                       {"mode", 3.}};
+                return true;
+            case 302:
+                out = {{"mac", std::string{"a0:b7:65:00:00:01"}},
+                       {"version", std::string{"0.85"}}};
+                return true;
+        }
+        return false;
+    }
+
+    bool get(const http::inputtype&, std::string& out) override
+    {
+        out = "{}";
+        return true;
+    }
+
+    bool get(const std::string& in, std::string& out) override
+    {
+        std::lock_guard lock(mtx);
+        requests++;
+        switch ((int32_t)getvalue(in, "\"T\":"))
+        {
+            case 105:
+                out = getfeedback();
+                return true;
+            case 100:
+                moveto(basepos, std::numbers::pi);
+                break;
+            case 1041:
+                setpoints++;
+                [[fallthrough]];
+            case 104:
+                moveto({getvalue(in, "\"x\":"), getvalue(in, "\"y\":"),
+                        getvalue(in, "\"z\":")},
+                       getvalue(in, "\"t\":"));
+                break;
+            case 121:
+                if (getvalue(in, "\"joint\":") == 4)
+                {
+                    grip(getvalue(in, "\"angle\":") * std::numbers::pi / 180.);
+                }
+                break;
+        }
+        out = "{}";
+        return true;
+    }
+
+    std::string info() override
+    {
+        return "mock arm";
+    }
+
+    uint64_t getrequests() const
+    {
+        return requests;
+    }
+
+    uint64_t getsetpoints() const
+    {
+        return setpoints;
+    }
+
+  private:
+    using clock = std::chrono::steady_clock;
+    using position_t = std::array<double, 3>;
+    static constexpr double armspeed = 1000.;   // mm/s
+    static constexpr double gripperspeed = 20.; // rad/s
+    static constexpr position_t basepos{310., 0., 240.};
+    static constexpr auto handdelay = std::chrono::milliseconds(1000);
+    static constexpr auto handphase = std::chrono::milliseconds(500);
+    static constexpr double handpush = 20.;       // mm
+    static constexpr double handgrip = 150. * std::numbers::pi / 180.;
+    const bool hand;
+    std::mutex mtx;
+    std::atomic<uint64_t> requests{}, setpoints{};
+    position_t posfrom{175., 235., 325.}, posto{posfrom};
+    double gripfrom{std::numbers::pi}, gripto{std::numbers::pi};
+    clock::time_point movestart, gripstart;
+
+    static double getvalue(std::string_view json, std::string_view key)
+    {
+        double value{};
+        if (auto pos = json.find(key); pos != std::string_view::npos)
+        {
+            auto begin = json.data() + pos + key.size();
+            std::from_chars(begin, json.data() + json.size(), value);
+        }
+        return value;
+    }
+
+    static double follow(double from, double to, double speed,
+                         clock::time_point start)
+    {
+        auto elapsed =
+            std::chrono::duration<double>(clock::now() - start).count();
+        auto distance = to - from;
+        auto travel = std::min(std::abs(distance), speed * elapsed);
+        return from + std::copysign(travel, distance);
+    }
+
+    // hand is at resting arm only, it leaves once arm is moved away
+    bool ishandheld() const
+    {
+        return hand && clock::now() - movestart > handdelay;
+    }
+
+    position_t getposition() const
+    {
+        auto distance = std::sqrt(std::pow(posto[0] - posfrom[0], 2) +
+                                  std::pow(posto[1] - posfrom[1], 2) +
+                                  std::pow(posto[2] - posfrom[2], 2));
+        auto ratio =
+            distance > 0. ? follow(0., distance, armspeed, movestart) / distance
+                          : 1.;
+        position_t position;
+        std::ranges::transform(posfrom, posto, position.begin(),
+                               [ratio](double from, double to) {
+                                   return from + (to - from) * ratio;
+                               });
+        auto rest = clock::now() - movestart - handdelay;
+        if (ishandheld() && (rest / handphase) % 2 == 0)
+        {
+            position[0] += handpush;
+            position[1] += handpush;
+        }
+        return position;
+    }
+
+    double getgripper() const
+    {
+        auto angle = follow(gripfrom, gripto, gripperspeed, gripstart);
+        return ishandheld() ? std::min(angle, handgrip) : angle;
+    }
+
+    void moveto(const position_t& position, double gripper)
+    {
+        posfrom = getposition();
+        posto = position;
+        movestart = clock::now();
+        grip(gripper);
+    }
+
+    void grip(double angle)
+    {
+        gripfrom = getgripper();
+        gripto = angle;
+        gripstart = clock::now();
+    }
+
+    std::string getfeedback() const
+    {
+        const auto [x, y, z] = getposition();
+        std::array<char, 256> json;
+        auto size = std::snprintf(
+            json.data(), json.size(),
+            "{\"T\":1051,\"x\":%.2f,\"y\":%.2f,\"z\":%.2f,\"b\":0.93,"
+            "\"s\":0.12,\"e\":1.71,\"t\":%.4f,\"torB\":0,\"torS\":-64,"
+            "\"torE\":12,\"torH\":0}",
+            x, y, z, getgripper());
+        return {json.data(), (size_t)size};
+    }
+};
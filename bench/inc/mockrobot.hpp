@@ -0,0 +1,40 @@
+#pragma once
+
+#include "log/interfaces/logging.hpp"
+#include "mockarm.hpp"
+#include "robot/factory.hpp"
+#include "robot/interfaces/roarmm2.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+
+// Log that drops messages, so they are still formatted as with real one
+class SinkLog : public logging::LogIf
+{
+  public:
+    void log(logging::type, const std::string& module,
+             const std::string& msg) override
+    {
+        benchmark::DoNotOptimize(module.data());
+        benchmark::DoNotOptimize(msg.data());
+    }
+};
+
+// Complete robot talking to mocked arm, without voice
+static std::shared_ptr<robot::RobotIf>
+    getmockrobot(std::shared_ptr<MockArm> arm = std::make_shared<MockArm>())
+{
+    return robot::RobotFactory::create<robot::roarmm2::Robot>(
+        std::move(arm), nullptr, std::make_shared<SinkLog>());
+}
+
+// The same robot driven through asynchronous interface
+static std::shared_ptr<robot::RobotAsyncIf> getmockasyncrobot(
+    std::shared_ptr<MockArm> arm = std::make_shared<MockArm>())
+{
+    return robot::RobotFactory::createasync<robot::roarmm2::Robot>(
+        std::move(arm), nullptr, std::make_shared<SinkLog>());
+}
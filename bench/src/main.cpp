@@ -0,0 +1,15 @@
+#include "bench_behaviors.hpp"
+#include "bench_commands.hpp"
+#include "bench_feedback.hpp"
+#include "bench_fleet.hpp"
+#include "bench_robot.hpp"
+
+#include "benchmark/benchmark.h"
+
+int main(int argc, char** argv)
+{
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "robot/speechcache.hpp"
+
+#include <span>
+#include <stop_token>
+#include <vector>
+
+namespace robot::audio
+{
+
+// Phrase synthesized by cloud text to speech as linear pcm wave, the same
+// service backend speaks with, access token is taken from gcloud
+bool synthesize(const phrase_t&, std::vector<char>&);
+// Wave played on default output, player is ended once stop is requested
+bool play(std::span<const char>, std::stop_token);
+
+} // namespace robot::audio
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "robot/ledeffects.hpp"
+#include "robot/trajectory.hpp"
+#include "robot/ttstexts.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace robot
+{
+
+enum class opcode : uint8_t
+{
+    move,
+    glide,
+    base,
+    say,
+    sing,
+    speechwait,
+    hush,
+    led,
+    ledwait,
+    wait,
+    until,
+    grip,
+    branch,
+    jump,
+    loop,
+    repeat,
+    next,
+    choose,
+    start,
+    stop,
+    succeed,
+    finish
+};
+
+// Poses are in millimeters and degrees, times in milliseconds, target is
+// absolute position of instruction to jump to
+struct instruction_t
+{
+    opcode op;
+    uint8_t variant{};
+    uint16_t target{};
+    std::array<int32_t, 5> args{};
+};
+
+// Behaviors compiled once from script into single instruction stream,
+// statements of a behavior are one per line:
+//   move x y z t [speed]    sent directly when no speed is given
+//   glide x y z t time      trajectory streamed from previous pose
+//   base                    init pose
+//   say cue / sing cue      speech queued, song one is skipped on stop
+//   speechwait count        until at most count utterances are queued
+//   hush                    drops queued song
+//   led off / led fade|pulse|breathe from to time
+//   ledwait                 until led effect finishes, ends on stop and
+//                           at once when effect is pulse or breathe
+//   wait time               ends early on stop
+//   until hand|arrived      hand moved or arm settled at previous pose
+//   grip open|close
+//   if / ifnot / else / end on outcome of last glide, until or grip
+//   loop / repeat count / end, both leave on stop, break leaves earlier
+//   choose / end            runs one random statement, never same twice
+//   start name / stop name  runs other behavior alongside, stop waits it
+//   succeed                 behavior ends with success
+// behaviors are enclosed in "behavior name" and "end", # starts comment
+class Program
+{
+  public:
+    explicit Program(std::string_view);
+
+    // position where named behavior starts
+    std::optional<size_t> find(std::string_view) const;
+    const instruction_t& at(size_t) const;
+    size_t size() const;
+    // counters each running behavior keeps for its repeats and choices
+    size_t slots() const;
+
+  private:
+    std::vector<instruction_t> code;
+    std::vector<std::pair<std::string, uint16_t>> entries;
+    uint16_t counters{};
+};
+
+// Gives outcome of action once it is done, actions are polled so no one
+// blocks the scheduler and behaviors running on it
+using pollfunc = std::function<std::optional<bool>()>;
+
+pollfunc topoll(bool);
+pollfunc topoll(std::future<bool>);
+
+// Actions start without blocking, behavior goes on once they are done
+struct actions_t
+{
+    std::function<bool()> isstopped;
+    std::function<pollfunc(const waypoint_t&, uint32_t)> move;
+    std::function<pollfunc(const std::optional<waypoint_t>&, const waypoint_t&,
+                           std::chrono::milliseconds, std::stop_token)>
+        glide;
+    std::function<pollfunc()> base;
+    std::function<pollfunc(task)> say;
+    std::function<pollfunc(task)> sing;
+    std::function<void()> hush;
+    // empty effect switches led off
+    std::function<pollfunc(effect_t)> light;
+    std::function<pollfunc()> lightwait;
+    std::function<pollfunc(const waypoint_t&)> arrival;
+    std::function<pollfunc(std::stop_token)> hand;
+    std::function<pollfunc(bool close)> grip;
+};
+
+struct schedulerstats_t
+{
+    uint64_t runs;
+    uint64_t instructions;
+    uint64_t slices;
+    size_t maxactive;
+};
+
+// Executes behaviors of program cooperatively on its single thread, each
+// one runs until it has to wait and then yields to others, pending
+// actions are polled every tick; attached functions are called every tick
+// as well until they return false, so periodic work needs no thread
+class Scheduler
+{
+  public:
+    using tickfunc = std::function<bool()>;
+
+    Scheduler(std::shared_ptr<const Program>, std::chrono::milliseconds);
+    ~Scheduler();
+
+    std::future<bool> run(std::string_view, actions_t);
+    void attach(tickfunc);
+    schedulerstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+
+namespace robot
+{
+
+// Behaviors shipped with the arm, written in script compiled by Program
+std::string_view getbehaviorscript();
+// Behaviors backing single motions of asynchronous interface, compiled
+// along with any loaded script, so it must not define them again
+std::string_view getcallscript();
+
+} // namespace robot
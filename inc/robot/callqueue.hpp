@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace robot
+{
+
+struct callqueuestats_t
+{
+    uint64_t started;
+    uint64_t cancelled;
+    uint64_t rejected;
+    size_t maxpending;
+};
+
+// Calls run one after another, next one is started on tick of shared thread
+// the queue is attached to once running one ended, so no thread waits for
+// them; calls stopped while queued end as failed without being started
+class CallQueue
+{
+  public:
+    // called every tick until it returns false
+    using tickfunc = std::function<bool()>;
+    using attachfunc = std::function<void(tickfunc)>;
+
+    struct call_t
+    {
+        std::function<std::future<bool>()> start;
+        std::function<bool()> isstopped;
+        // given outcome of started call before its future is set
+        std::function<void(bool)> finish{};
+    };
+
+    CallQueue(attachfunc, size_t depth);
+    ~CallQueue();
+
+    // Future holds exception when depth calls are already waiting
+    std::future<bool> push(call_t);
+    callqueuestats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
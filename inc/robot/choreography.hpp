@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace robot
+{
+
+enum class cuetype
+{
+    motion,
+    led,
+    speech
+};
+
+// Cue is due at given time since start of the show
+struct cue_t
+{
+    std::chrono::milliseconds at;
+    size_t arm;
+    cuetype type;
+    std::string payload;
+};
+
+struct cueskew_t
+{
+    uint64_t cues;
+    uint64_t failed;
+    std::chrono::microseconds sumskew;
+    std::chrono::microseconds maxskew;
+    // one way latency of every cue type
+    std::array<std::chrono::microseconds, 3> latencies;
+};
+
+struct choreoreport_t
+{
+    std::vector<cueskew_t> arms;
+    // largest difference between arms for cues due at the same time
+    std::chrono::microseconds maxspread;
+};
+
+// Plays timeline of cues against monotonic clock, each cue is dispatched
+// ahead of time by measured latency of its arm and type, cue is assumed to
+// take effect half way through its dispatch round trip; cue types of every
+// arm are played independently, so slow speech does not hold motion back
+class Choreography
+{
+  public:
+    using dispatchfunc = std::function<bool(const cue_t&)>;
+
+    Choreography(dispatchfunc, size_t arms);
+    ~Choreography();
+
+    // Latency of probe type is measured on all arms
+    void calibrate(const cue_t& probe, uint32_t samples);
+    choreoreport_t run(const std::vector<cue_t>&, std::stop_token = {});
+    std::chrono::microseconds getlatency(size_t arm, cuetype) const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+
+namespace robot
+{
+
+struct response_t
+{
+    bool ok;
+    std::string body;
+};
+
+// Commands sharing ordering key are executed in order of sending, others
+// are spread over lanes, each lane keeps one request in flight; lanes call
+// interface concurrently, so client that is not thread safe is to be given
+// through PooledHttp
+class CommandChannel
+{
+  public:
+    using request_t = std::variant<http::inputtype, std::string>;
+    using orderkey_t = std::optional<uint32_t>;
+    using donefunc = std::function<void(const response_t&)>;
+
+    CommandChannel(std::shared_ptr<http::HttpIf>, uint32_t lanes);
+    ~CommandChannel();
+
+    std::future<response_t> send(const http::inputtype&, orderkey_t = {});
+    std::future<response_t> send(const std::string&, orderkey_t = {});
+    void send(const http::inputtype&, orderkey_t, donefunc);
+    void send(const std::string&, orderkey_t, donefunc);
+    void flush();
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
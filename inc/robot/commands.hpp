@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace robot::roarmm2::command
+{
+
+template <typename M>
+struct field_t
+{
+    std::string_view name;
+    M member;
+};
+
+template <typename M>
+field_t(std::string_view, M) -> field_t<M>;
+
+struct MoveInit
+{
+    static constexpr int32_t type{100};
+    static constexpr std::tuple<> fields{};
+};
+
+struct MoveXYZT
+{
+    static constexpr int32_t type{104};
+    int32_t x, y, z;
+    double t, spd;
+    static constexpr std::tuple fields{
+        field_t{"x", &MoveXYZT::x}, field_t{"y", &MoveXYZT::y},
+        field_t{"z", &MoveXYZT::z}, field_t{"t", &MoveXYZT::t},
+        field_t{"spd", &MoveXYZT::spd}};
+};
+
+struct MoveXYZTDirect
+{
+    static constexpr int32_t type{1041};
+    int32_t x, y, z;
+    double t;
+    static constexpr std::tuple fields{
+        field_t{"x", &MoveXYZTDirect::x}, field_t{"y", &MoveXYZTDirect::y},
+        field_t{"z", &MoveXYZTDirect::z}, field_t{"t", &MoveXYZTDirect::t}};
+};
+
+struct Feedback
+{
+    static constexpr int32_t type{105};
+    static constexpr std::tuple<> fields{};
+};
+
+struct SetLed
+{
+    static constexpr int32_t type{114};
+    int32_t led;
+    static constexpr std::tuple fields{field_t{"led", &SetLed::led}};
+};
+
+struct MoveJoint
+{
+    static constexpr int32_t type{121};
+    int32_t joint, angle, spd, acc;
+    static constexpr std::tuple fields{
+        field_t{"joint", &MoveJoint::joint},
+        field_t{"angle", &MoveJoint::angle}, field_t{"spd", &MoveJoint::spd},
+        field_t{"acc", &MoveJoint::acc}};
+};
+
+struct Torque
+{
+    static constexpr int32_t type{210};
+    int32_t cmd;
+    static constexpr std::tuple fields{field_t{"cmd", &Torque::cmd}};
+};
+
+struct DeviceInfo
+{
+    static constexpr int32_t type{302};
+    static constexpr std::tuple<> fields{};
+};
+
+struct WifiInfo
+{
+    static constexpr int32_t type{405};
+    static constexpr std::tuple<> fields{};
+};
+
+template <typename C>
+concept command = requires {
+    C::type;
+    C::fields;
+};
+
+template <typename C>
+concept constcommand =
+    command<C> &&
+    std::tuple_size_v<std::remove_cv_t<decltype(C::fields)>> == 0;
+
+// Commands without fields are serialized once at compile time
+template <int32_t type>
+constexpr auto serialize()
+{
+    constexpr auto digits = []() {
+        size_t num{1};
+        for (auto value = type; value >= 10; value /= 10)
+            num++;
+        return num;
+    }();
+    constexpr std::string_view prefix{"{\"T\":"};
+    std::array<char, prefix.size() + digits + 1> json{};
+    auto it = std::ranges::copy(prefix, json.begin()).out;
+    for (auto value = type, idx = (int32_t)digits - 1; idx >= 0;
+         value /= 10, idx--)
+    {
+        *(it + idx) = (char)('0' + value % 10);
+    }
+    json.back() = '}';
+    return json;
+}
+
+template <constcommand C>
+inline constexpr auto serialized = serialize<C::type>();
+
+template <constcommand C>
+constexpr std::string_view getjson()
+{
+    return {serialized<C>.data(), serialized<C>.size()};
+}
+
+// Encodes commands into its own fixed buffer, no allocation is done,
+// returned view is valid until next encoding
+class Encoder
+{
+  public:
+    template <command C>
+    std::string_view encode(const C& cmd)
+    {
+        if constexpr (constcommand<C>)
+        {
+            return getjson<C>();
+        }
+        else
+        {
+            size = 0;
+            appendtext("{\"T\":");
+            appendvalue(C::type);
+            std::apply(
+                [this, &cmd](const auto&... field) {
+                    ((appendtext(",\""), appendtext(field.name),
+                      appendtext("\":"), appendvalue(cmd.*(field.member))),
+                     ...);
+                },
+                C::fields);
+            appendtext("}");
+            return {buffer.data(), size};
+        }
+    }
+
+  private:
+    std::array<char, 256> buffer;
+    size_t size{};
+
+    void appendtext(std::string_view text)
+    {
+        std::ranges::copy(text, buffer.begin() + size);
+        size += text.size();
+    }
+
+    template <typename T>
+    void appendvalue(T value)
+    {
+        auto result = std::to_chars(buffer.data() + size,
+                                    buffer.data() + buffer.size(), value);
+        size = (size_t)(result.ptr - buffer.data());
+    }
+};
+
+template <command C>
+std::string tojson(const C& cmd)
+{
+    Encoder encoder;
+    return std::string{encoder.encode(cmd)};
+}
+
+} // namespace robot::roarmm2::command
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace robot
+{
+
+enum class convergence
+{
+    reached,
+    withinmargin,
+    stalled,
+    timedout
+};
+
+struct convparams_t
+{
+    std::chrono::milliseconds deadline;
+    double margin;
+    std::chrono::milliseconds mininterval;
+    std::chrono::milliseconds maxinterval;
+    double backoff;
+    double stallvelocity;
+    uint32_t stallsamples;
+    // stall is not detected until movement is seen or this time passes,
+    // as motion may start late after command was queued
+    std::chrono::milliseconds startgrace;
+};
+
+struct convresult_t
+{
+    convergence status;
+    double position;
+    std::chrono::milliseconds elapsed;
+    uint32_t polls;
+};
+
+// Polls position until setpoint is reached, movement stalls or deadline
+// expires, interval between polls adapts to the observed velocity
+convresult_t waitconverged(const std::function<double()>&, double setpoint,
+                           const convparams_t&);
+
+} // namespace robot
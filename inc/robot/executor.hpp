@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace robot
+{
+
+enum class workqueue
+{
+    lighting,
+    telemetry,
+    motion,
+    sensing
+};
+
+struct queueconfig_t
+{
+    workqueue name;
+    uint32_t workers;
+    size_t depth;
+};
+
+struct queuestats_t
+{
+    uint64_t executed;
+    uint64_t rejected;
+    size_t maxpending;
+    std::chrono::microseconds sumlatency;
+    std::chrono::microseconds maxlatency;
+};
+
+// Runs jobs on persistent workers of named queues, jobs of a queue with
+// single worker are executed in order, jobs over queue depth are rejected
+class Executor
+{
+  public:
+    using job_t = std::function<void()>;
+
+    explicit Executor(std::span<const queueconfig_t>);
+    ~Executor();
+
+    bool post(workqueue, job_t);
+    queuestats_t getstats(workqueue) const;
+
+    // Rejected job gives future holding exception
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(workqueue name, F&& func)
+    {
+        using result_t = std::invoke_result_t<F>;
+        auto job = std::make_shared<std::packaged_task<result_t()>>(
+            std::forward<F>(func));
+        auto result = job->get_future();
+        if (!post(name, [job]() { (*job)(); }))
+        {
+            std::promise<result_t> rejected;
+            rejected.set_exception(std::make_exception_ptr(
+                std::runtime_error("Executor queue is full")));
+            return rejected.get_future();
+        }
+        return result;
+    }
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -3,9 +3,11 @@
 #include "http/interfaces/http.hpp"
 #include "log/interfaces/logging.hpp"
 #include "robot/interfaces/robot.hpp"
+#include "robot/interfaces/robotasync.hpp"
 #include "tts/interfaces/texttovoice.hpp"
 
 #include <memory>
+#include <utility>
 
 namespace robot
 {
@@ -13,13 +15,26 @@ namespace robot
 class RobotFactory
 {
   public:
-    template <typename T>
+    // Arguments after interfaces are specific to robot type
+    template <typename T, typename... Args>
     static std::shared_ptr<RobotIf>
         create(std::shared_ptr<http::HttpIf> httpIf,
                std::shared_ptr<tts::TextToVoiceIf> ttsIf,
-               std::shared_ptr<logging::LogIf> logIf)
+               std::shared_ptr<logging::LogIf> logIf, Args&&... args)
     {
-        return std::shared_ptr<T>(new T(httpIf, ttsIf, logIf));
+        return std::shared_ptr<T>(
+            new T(httpIf, ttsIf, logIf, std::forward<Args>(args)...));
+    }
+
+    // Robot driven by futures instead of menu, for types implementing both
+    template <typename T, typename... Args>
+    static std::shared_ptr<RobotAsyncIf>
+        createasync(std::shared_ptr<http::HttpIf> httpIf,
+                    std::shared_ptr<tts::TextToVoiceIf> ttsIf,
+                    std::shared_ptr<logging::LogIf> logIf, Args&&... args)
+    {
+        return std::shared_ptr<T>(
+            new T(httpIf, ttsIf, logIf, std::forward<Args>(args)...));
     }
 };
 
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "robot/feedbackdecoder.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace robot
+{
+
+struct snapshot_t
+{
+    uint64_t version;
+    std::chrono::steady_clock::time_point timestamp;
+    roarmm2::servofeedback_t data;
+};
+
+// Samples feedback only on demand on thread of reader that finds no sample
+// in flight, so no thread is held per arm; readers arriving while a sample
+// is taken share it, given period bounds their waiting
+class Feedback
+{
+  public:
+    using readfunc = std::function<bool(roarmm2::servofeedback_t&)>;
+
+    Feedback(readfunc, std::chrono::milliseconds);
+    ~Feedback();
+
+    // Returns snapshot not older than given age, otherwise waits for the next
+    // sample, nullptr is returned if no valid sample could be collected
+    std::shared_ptr<const snapshot_t> get(std::chrono::milliseconds);
+    std::shared_ptr<const snapshot_t> getlatest() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
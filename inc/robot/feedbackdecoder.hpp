@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string_view>
+
+namespace robot::roarmm2
+{
+
+// Servo feedback as reported for T=105: end point position [mm], joint
+// angles [rad] and joint loads
+struct servofeedback_t
+{
+    double x, y, z;
+    double b, s, e, t;
+    double torb, tors, tore, torh;
+};
+
+enum class decodeerror
+{
+    none,
+    empty,
+    malformed,
+    badvalue,
+    missingfield
+};
+
+// Decodes response body in a single pass without intermediate containers
+decodeerror decode(std::string_view, servofeedback_t&);
+
+} // namespace robot::roarmm2
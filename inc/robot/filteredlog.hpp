@@ -0,0 +1,38 @@
+#pragma once
+
+#include "log/interfaces/logging.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace robot
+{
+
+struct logstats_t
+{
+    uint64_t written;
+    uint64_t filtered;
+    uint64_t dropped;
+};
+
+// Passes messages of given level and more severe ones to sink, with queue
+// depth given they are written by own thread, so callers never wait for
+// console or disk, messages over depth are dropped and reported later
+class FilteredLog : public logging::LogIf
+{
+  public:
+    FilteredLog(std::shared_ptr<logging::LogIf>, logging::type,
+                size_t queuedepth);
+    ~FilteredLog();
+
+    void log(logging::type, const std::string&, const std::string&) override;
+    bool isenabled(logging::type) const;
+    logstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+#include "robot/choreography.hpp"
+#include "robot/commandchannel.hpp"
+#include "robot/feedbackdecoder.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace robot
+{
+
+class RobotIf;
+
+struct arm_t
+{
+    std::string name;
+    std::shared_ptr<http::HttpIf> httpIf;
+};
+
+struct armtelemetry_t
+{
+    std::string name;
+    uint64_t requests;
+    uint64_t failures;
+    std::chrono::microseconds sumlatency;
+    std::chrono::microseconds maxlatency;
+    std::optional<roarmm2::servofeedback_t> feedback;
+    std::chrono::steady_clock::time_point updated;
+};
+
+// Drives many arms from shared pool of io workers, commands of each arm
+// are executed in order of sending, different arms are served in parallel
+class Fleet
+{
+  public:
+    using robotfactory =
+        std::function<std::shared_ptr<RobotIf>(std::shared_ptr<http::HttpIf>)>;
+    using speakfunc = std::function<bool(size_t arm, const std::string&)>;
+
+    Fleet(const std::vector<arm_t>&, uint32_t ioworkers,
+          robotfactory = nullptr);
+    ~Fleet();
+
+    size_t size() const;
+    std::future<response_t> send(size_t arm, const std::string&);
+    std::vector<std::future<response_t>> broadcast(const std::string&);
+    // Reads feedback of all arms, returns number of arms updated
+    size_t sampletelemetry();
+    std::vector<armtelemetry_t> gettelemetry() const;
+    // Robot for behaviors of given arm, created on first use, its requests
+    // are served in order with commands sent to the arm, on its own thread
+    // when arm is idle and by fleet workers otherwise, so it must not
+    // outlive the fleet; factory is to give robots one shared runtime
+    std::shared_ptr<RobotIf> getrobot(size_t arm);
+    // Latency of commands to every arm measured by feedback reads
+    void calibrate(uint32_t samples);
+    // Plays show on arms, motion and led cues carry commands sent to their
+    // arm and speech cues are given to speak function; latencies measured
+    // are kept for next shows
+    choreoreport_t play(const std::vector<cue_t>&, speakfunc = nullptr,
+                        std::stop_token = {});
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -1,10 +1,37 @@
 #pragma once
 
+#include <array>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace robothelpers
 {
 
 std::string gettimestr();
 
+inline void appendone(std::string& buffer, std::string_view text)
+{
+    buffer += text;
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+inline void appendone(std::string& buffer, T value)
+{
+    std::array<char, 32> digits;
+    auto end = std::to_chars(digits.data(), digits.data() + digits.size(),
+                             value)
+                   .ptr;
+    buffer.append(digits.data(), end);
 }
+
+// Appends texts and numbers to given buffer without temporary strings
+template <typename... Args>
+inline void append(std::string& buffer, const Args&... args)
+{
+    (appendone(buffer, args), ...);
+}
+
+} // namespace robothelpers
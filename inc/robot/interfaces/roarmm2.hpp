@@ -1,6 +1,7 @@
 #pragma once
 
 #include "robot/factory.hpp"
+#include "robot/interfaces/robotasync.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -8,13 +9,31 @@
 namespace robot::roarmm2
 {
 
-class Robot : public RobotIf
+// Threads robots given the same runtime share: executor workers and
+// scheduler running behaviors and led effects of all of them; workers of
+// queues waiting on arms are added per robot, so arms do not wait for each
+// other, and the rest is created once
+class Runtime
+{
+  public:
+    explicit Runtime(uint32_t robots = 1);
+    ~Runtime();
+
+  private:
+    friend class Robot;
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+class Robot : public RobotIf, public RobotAsyncIf
 {
   public:
     ~Robot();
 
     bool readwifiinfo(bool) override;
     bool readservosinfo(bool) override;
+    bool readrequeststats(bool) override;
+    bool dumprequeststats(bool) override;
     bool settorqueunlocked(bool) override;
     bool settorquelocked(bool) override;
     bool openeoat(bool) override;
@@ -31,6 +50,8 @@ class Robot : public RobotIf
     bool shakehand(bool) override;
     bool dance(bool) override;
     bool enlight(bool) override;
+    bool teach(bool) override;
+    bool replay(bool, double scale) override;
     bool engage() override;
     bool disengage() override;
 
@@ -41,10 +62,20 @@ class Robot : public RobotIf
 
     std::string conninfo() override;
 
+    std::future<bool> openeoatasync(std::stop_token, progressfunc) override;
+    std::future<bool> closeeoatasync(std::stop_token, progressfunc) override;
+    std::future<bool> movebaseasync(std::stop_token, progressfunc) override;
+    std::future<bool> moveparkedasync(std::stop_token, progressfunc) override;
+
+    std::future<bool> shakehandasync(std::stop_token, progressfunc) override;
+    std::future<bool> danceasync(std::stop_token, progressfunc) override;
+    std::future<bool> enlightasync(std::stop_token, progressfunc) override;
+
   private:
     friend class robot::RobotFactory;
     Robot(std::shared_ptr<http::HttpIf>, std::shared_ptr<tts::TextToVoiceIf>,
-          std::shared_ptr<logging::LogIf>);
+          std::shared_ptr<logging::LogIf>,
+          std::shared_ptr<Runtime> = nullptr);
     struct Handler;
     std::unique_ptr<Handler> handler;
 };
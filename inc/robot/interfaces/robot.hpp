@@ -16,6 +16,8 @@ class RobotIf
 
     virtual bool readwifiinfo(bool) = 0;
     virtual bool readservosinfo(bool) = 0;
+    virtual bool readrequeststats(bool) = 0;
+    virtual bool dumprequeststats(bool) = 0;
     virtual bool settorqueunlocked(bool) = 0;
     virtual bool settorquelocked(bool) = 0;
     virtual bool openeoat(bool) = 0;
@@ -32,6 +34,8 @@ class RobotIf
     virtual bool shakehand(bool) = 0;
     virtual bool dance(bool) = 0;
     virtual bool enlight(bool) = 0;
+    virtual bool teach(bool) = 0;
+    virtual bool replay(bool, double scale) = 0;
     virtual bool engage() = 0;
     virtual bool disengage() = 0;
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "robot/ttstexts.hpp"
+
+#include <functional>
+#include <future>
+#include <stop_token>
+
+namespace robot
+{
+
+// Progress is reported with stage of the behavior being announced
+using progressfunc = std::function<void(task)>;
+
+class RobotAsyncIf
+{
+  public:
+    virtual ~RobotAsyncIf() = default;
+
+    virtual std::future<bool> openeoatasync(std::stop_token,
+                                            progressfunc) = 0;
+    virtual std::future<bool> closeeoatasync(std::stop_token,
+                                             progressfunc) = 0;
+    virtual std::future<bool> movebaseasync(std::stop_token,
+                                            progressfunc) = 0;
+    virtual std::future<bool> moveparkedasync(std::stop_token,
+                                              progressfunc) = 0;
+
+    virtual std::future<bool> shakehandasync(std::stop_token,
+                                             progressfunc) = 0;
+    virtual std::future<bool> danceasync(std::stop_token, progressfunc) = 0;
+    virtual std::future<bool> enlightasync(std::stop_token, progressfunc) = 0;
+};
+
+} // namespace robot
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "robot/trajectory.hpp"
+
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+namespace robot::roarmm2
+{
+
+struct jointlimits_t
+{
+    double min;
+    double max;
+};
+
+// RoArm-M2 geometry in millimeters, upper arm is built of two sections
+// with an offset, so it is tilted from shoulder axis, limits in radians
+struct model_t
+{
+    double upperarm;
+    double upperarmoffset;
+    double forearm;
+    std::array<jointlimits_t, 4> limits;
+};
+
+inline constexpr model_t model{
+    .upperarm = 236.82,
+    .upperarmoffset = 30.,
+    .forearm = 280.15,
+    .limits = {{{-std::numbers::pi, std::numbers::pi},
+                {-std::numbers::pi / 2, std::numbers::pi / 2},
+                {-std::numbers::pi / 4, std::numbers::pi},
+                {std::numbers::pi / 4, std::numbers::pi}}}};
+
+// Joint angles in radians: base, shoulder, elbow, hand, shoulder is zero
+// when upper arm is vertical and elbow is right angle when forearm is
+// horizontal with upright upper arm
+using joints_t = std::array<double, 4>;
+
+struct posebatch_t
+{
+    std::vector<double> x, y, z, t;
+};
+
+struct jointbatch_t
+{
+    std::vector<double> base, shoulder, elbow, hand;
+};
+
+waypoint_t forward(const joints_t&);
+bool inverse(const waypoint_t&, joints_t&);
+bool iswithinlimits(const joints_t&);
+
+// Batch versions work on structure of arrays to let loops vectorize,
+// validity of each pose is stored in mask, number of valid poses returned
+void forward(const jointbatch_t&, posebatch_t&);
+size_t inverse(const posebatch_t&, jointbatch_t&, std::vector<uint8_t>& valid);
+
+} // namespace robot::roarmm2
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace robot
+{
+
+// Effect gives led level for time elapsed since its start, empty value
+// when effect is finished
+using effect_t =
+    std::function<std::optional<uint8_t>(std::chrono::milliseconds)>;
+
+namespace ledeffect
+{
+effect_t fade(uint8_t from, uint8_t to, std::chrono::milliseconds duration);
+effect_t pulse(uint8_t min, uint8_t max, std::chrono::milliseconds period);
+effect_t breathe(uint8_t min, uint8_t max, std::chrono::milliseconds period);
+} // namespace ledeffect
+
+struct ledstats_t
+{
+    uint64_t frames;
+    uint64_t writes;
+    uint64_t dropped;
+};
+
+// Effect frames are computed on tick of shared thread the engine is
+// attached to while effect runs, so no thread is held per led; write only
+// starts sending level and frame is dropped when it is not taken
+class LedEngine
+{
+  public:
+    using writefunc = std::function<bool(uint8_t)>;
+    // called every tick until it returns false
+    using tickfunc = std::function<bool()>;
+    using attachfunc = std::function<void(tickfunc)>;
+
+    LedEngine(writefunc, std::chrono::milliseconds, attachfunc);
+    ~LedEngine();
+
+    void run(effect_t);
+    void stop();
+    void wait();
+    // false when effect is still running after given time
+    bool wait(std::chrono::milliseconds);
+    ledstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace robot
+{
+
+using position_t = std::array<double, 3>;
+
+struct motionparams_t
+{
+    std::chrono::milliseconds period;
+    double deadband;
+    std::chrono::milliseconds latencytarget;
+};
+
+struct motionresult_t
+{
+    bool detected;
+    std::chrono::milliseconds latency;
+    uint32_t samples;
+    std::chrono::microseconds cputime;
+};
+
+// Samples position on a fixed clock until its moving average leaves the
+// deadband around the initial position or stop condition is met, averaging
+// window is derived from trigger latency target
+motionresult_t detectmotion(const std::function<position_t()>&,
+                            const std::function<bool()>& stop,
+                            const motionparams_t&);
+
+} // namespace robot
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace robot
+{
+
+// Each request gets client of its own for its whole duration, clients are
+// made by factory when all existing ones are busy and reused afterwards, so
+// ones that are not thread safe can serve concurrent command lanes; once
+// pool is full requests wait for client to be released
+class PooledHttp : public http::HttpIf
+{
+  public:
+    using factoryfunc = std::function<std::shared_ptr<http::HttpIf>()>;
+
+    PooledHttp(factoryfunc, uint32_t size);
+    ~PooledHttp();
+
+    bool get(const http::inputtype&, http::outputtype&) override;
+    bool get(const http::inputtype&, std::string&) override;
+    bool get(const std::string&, std::string&) override;
+    std::string info() override;
+
+    uint32_t getclients() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace robot
+{
+
+// Log-linear histogram of latencies in microseconds, values are counted
+// in buckets of relative width below 1/32, recording is lock free
+class LatencyHistogram
+{
+  public:
+    void record(std::chrono::microseconds);
+    uint64_t count() const;
+    std::chrono::microseconds mean() const;
+    std::chrono::microseconds max() const;
+    // highest latency of given percent of requests
+    std::chrono::microseconds percentile(double) const;
+
+  private:
+    static constexpr uint32_t subbits = 5;
+    static constexpr uint32_t maxbits = 36;
+    static constexpr size_t buckets = (maxbits - subbits + 1) << subbits;
+
+    std::array<std::atomic<uint64_t>, buckets> counts{};
+    std::atomic<uint64_t> total{};
+    std::atomic<uint64_t> sum{};
+    std::atomic<uint64_t> maximum{};
+};
+
+// Robot activity requests are accounted to
+enum class activity
+{
+    other,
+    dance,
+    shakehand,
+    enlight,
+    gripper
+};
+
+// Activity requests sent by calling thread are accounted to, work handed
+// over to other threads carries activity of the thread handing it over
+activity getactivity();
+
+// Sets activity of calling thread while in scope, unless the thread already
+// runs another one, scopes restore activity they found
+class ActivityScope
+{
+  public:
+    explicit ActivityScope(activity);
+    ~ActivityScope();
+    ActivityScope(const ActivityScope&) = delete;
+    ActivityScope& operator=(const ActivityScope&) = delete;
+
+  private:
+    const activity prev;
+};
+
+// Callable run with activity of thread that created it
+template <typename F>
+auto withactivity(F&& func)
+{
+    return [current = getactivity(),
+            func = std::forward<F>(func)](auto&&... args) mutable {
+        ActivityScope scope(current);
+        return func(std::forward<decltype(args)>(args)...);
+    };
+}
+
+struct commandstats_t
+{
+    int32_t type;
+    uint64_t requests;
+    uint64_t failures;
+    uint64_t bytessent;
+    uint64_t bytesreceived;
+    std::chrono::microseconds mean;
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+    std::chrono::microseconds max;
+};
+
+struct requestreport_t
+{
+    // commands not requested are skipped, unknown type is reported as -1
+    std::vector<commandstats_t> commands;
+    std::array<uint64_t, 5> activities;
+};
+
+// Decorator of arm connection measuring every request by its command type
+// and accounting it to activity of thread sending it
+class MeteredHttp : public http::HttpIf
+{
+  public:
+    explicit MeteredHttp(std::shared_ptr<http::HttpIf>);
+    ~MeteredHttp();
+
+    bool get(const http::inputtype&, http::outputtype&) override;
+    bool get(const http::inputtype&, std::string&) override;
+    bool get(const std::string&, std::string&) override;
+    std::string info() override;
+
+    requestreport_t getreport() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
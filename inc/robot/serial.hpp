@@ -0,0 +1,43 @@
+#pragma once
+
+#include "http/interfaces/http.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace robot
+{
+
+struct serialconfig_t
+{
+    uint32_t baud;
+    // longest wait for first line of response
+    std::chrono::milliseconds timeout;
+    // wait for data line after arm echoed command back
+    std::chrono::milliseconds replygap;
+};
+
+// Speaks json commands of http interface to arm attached over serial line,
+// each command is one line and first line coming back that is not its echo
+// is the response, echo alone acknowledges commands not returning data
+// and ends request of known ones at once
+class SerialHttp : public http::HttpIf
+{
+  public:
+    SerialHttp(const std::filesystem::path&, const serialconfig_t&);
+    ~SerialHttp();
+
+    bool get(const http::inputtype&, http::outputtype&) override;
+    bool get(const http::inputtype&, std::string&) override;
+    bool get(const std::string&, std::string&) override;
+    std::string info() override;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
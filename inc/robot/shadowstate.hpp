@@ -0,0 +1,65 @@
+#pragma once
+
+#include "robot/feedbackdecoder.hpp"
+#include "robot/kinematics.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace robot
+{
+
+// parts of state touched by commands
+enum class shadowpart
+{
+    led,
+    torque,
+    joints
+};
+
+struct shadowstats_t
+{
+    uint64_t sent;
+    uint64_t elided;
+    // targets dropped because feedback showed arm elsewhere
+    uint64_t dropped;
+};
+
+// Mirrors state last commanded to actuators: led level, torque lock and
+// joint targets, gripper being the hand joint. Setters return whether
+// command changes anything and has to be sent, otherwise it is elided.
+// Joint targets are kept only while feedback of settled joint confirms
+// them within tolerance, joint is settled once it stops moving after its
+// settle time. Joints of unlocked arm are not tracked as it can be moved
+// by hand
+class ShadowState
+{
+  public:
+    ShadowState(double tolerance, std::chrono::milliseconds settle);
+    ~ShadowState();
+
+    bool setled(uint8_t);
+    bool settorque(bool locked);
+    bool setjoints(const roarmm2::joints_t&);
+    bool setjoint(size_t, double);
+    bool setpose(const waypoint_t&);
+    // pose streamed to arm, it is always sent to keep rate of the stream
+    void trackpose(const waypoint_t&);
+    // command failed or its effect is unknown, nothing is elided until
+    // state is commanded again, only parts the command touched are affected
+    void invalidate();
+    void invalidate(shadowpart);
+    void invalidatejoint(size_t);
+    void confirm(const roarmm2::servofeedback_t&);
+
+    std::optional<uint8_t> getled() const;
+    shadowstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
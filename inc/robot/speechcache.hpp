@@ -0,0 +1,89 @@
+#pragma once
+
+#include "tts/interfaces/texttovoice.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace robot
+{
+
+struct phrase_t
+{
+    std::string text;
+    tts::voice_t voice;
+};
+
+struct speechstats_t
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t entries;
+    uint64_t bytes;
+};
+
+// Keeps synthesized audio of phrases in memory mapped file, so repeated
+// phrases are played locally without going to synthesis backend
+class SpeechCache
+{
+  public:
+    using synthfunc = std::function<bool(const phrase_t&, std::vector<char>&)>;
+    // Playing is expected to end early once stop is requested
+    using playfunc =
+        std::function<bool(std::span<const char>, std::stop_token)>;
+
+    SpeechCache(const std::filesystem::path&, synthfunc, playfunc);
+    ~SpeechCache();
+
+    // Synthesizes missing phrases in parallel, calling thread being one of
+    // workers, returns number of new entries
+    size_t fill(const std::vector<phrase_t>&, uint32_t workers,
+                std::stop_token = {});
+    bool contains(const phrase_t&) const;
+    bool speak(const phrase_t&, std::stop_token = {});
+    speechstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+// Speaks through cache, backend is used for voice settings and as fallback
+class CachedTextToVoice : public tts::TextToVoiceIf
+{
+  public:
+    CachedTextToVoice(std::shared_ptr<tts::TextToVoiceIf>,
+                      std::shared_ptr<SpeechCache>, uint32_t workers);
+    ~CachedTextToVoice();
+
+    void speak(const std::string&) override;
+    tts::voice_t getvoice() override;
+    void setvoice(const tts::voice_t&) override;
+    // Synthesizes text for current voice ahead of speaking it, on calling
+    // thread
+    void prepare(const std::string&);
+    // Interrupts phrase spoken by this instance only, backend used as
+    // fallback can be stopped by its process wide kill
+    void stop();
+
+  private:
+    std::shared_ptr<tts::TextToVoiceIf> backend;
+    std::shared_ptr<SpeechCache> cache;
+    const uint32_t workers;
+    std::mutex mtx;
+    std::stop_source playing;
+    bool fallback{};
+    std::jthread prefiller;
+
+    void prefill();
+};
+
+} // namespace robot
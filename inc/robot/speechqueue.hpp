@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace robot
+{
+
+// Higher priority goes ahead of queued and interrupts playing utterances
+enum class speechpriority
+{
+    song,
+    status
+};
+
+struct speechqueuestats_t
+{
+    uint64_t spoken;
+    uint64_t cancelled;
+    uint64_t preempted;
+    uint64_t unprepared;
+    uint64_t gaps;
+    std::chrono::microseconds sumgap;
+    std::chrono::microseconds maxgap;
+};
+
+// Utterances are spoken in order of priority and arrival, upcoming ones are
+// prepared (synthesized) while current one is playing
+class SpeechQueue
+{
+  public:
+    using preparefunc = std::function<void(const std::string&)>;
+    using speakfunc = std::function<void(const std::string&)>;
+    using stopfunc = std::function<void()>;
+
+    SpeechQueue(preparefunc, speakfunc, stopfunc, uint32_t lookahead);
+    ~SpeechQueue();
+
+    // Future is set to false if utterance was cancelled or interrupted
+    std::future<bool> push(const std::string&, speechpriority);
+    // Drops queued and interrupts playing utterances up to given priority
+    void cancel(speechpriority);
+    void wait();
+    speechqueuestats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "robot/kinematics.hpp"
+#include "robot/trajectory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace robot
+{
+
+// Joint samples taken at fixed period, first one is stored as is and
+// following ones as deltas from previous, so a still or slowly moving arm
+// takes a byte per joint. Loaded recording is mapped, not read
+class Recording
+{
+  public:
+    explicit Recording(std::chrono::microseconds);
+    explicit Recording(const std::filesystem::path&);
+    Recording(Recording&&) noexcept;
+    Recording& operator=(Recording&&) noexcept;
+    ~Recording();
+
+    void append(const roarmm2::joints_t&);
+    void save(const std::filesystem::path&) const;
+
+    std::chrono::microseconds period() const;
+    size_t size() const;
+    size_t bytes() const;
+    std::vector<roarmm2::joints_t> decode() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+struct teachstats_t
+{
+    uint64_t samples;
+    // feedback not read in time or not read at all
+    uint64_t missed;
+    // samples lost as ring was full
+    uint64_t overruns;
+};
+
+// Samples joints at fixed rate from own thread into lock-free ring, which
+// is drained into recording by another one, so sampling never waits
+class Recorder
+{
+  public:
+    using readfunc = std::function<bool(roarmm2::joints_t&)>;
+
+    Recorder(readfunc, std::chrono::milliseconds);
+    ~Recorder();
+
+    void start();
+    Recording stop();
+    teachstats_t getstats() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+// Arm positions for every step of replay, recording is played scale times
+// faster, joints are interpolated linearly between samples
+std::vector<waypoint_t> resample(const Recording&, std::chrono::milliseconds,
+                                 double scale);
+
+} // namespace robot
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace robot::tracing
+{
+
+struct tracestats_t
+{
+    uint64_t events;
+    uint64_t dropped;
+};
+
+inline std::atomic<bool> active{false};
+
+// Spans recorded until stop are written to file as Chrome trace events,
+// each thread gets its own track
+bool start(const std::filesystem::path&);
+tracestats_t stop();
+// Name shown for track of calling thread
+void setthreadname(const std::string&);
+// Names and categories are expected to be string literals
+void record(const char* name, const char* category,
+            std::chrono::steady_clock::time_point, int64_t arg,
+            bool hasarg);
+
+// Scope measured as complete event, when tracing is not active only its
+// flag is checked
+class Span
+{
+  public:
+    Span(const char* name, const char* category) :
+        name{name}, category{category}
+    {
+        if (active.load(std::memory_order_relaxed))
+        {
+            begin = std::chrono::steady_clock::now();
+        }
+    }
+
+    Span(const char* name, const char* category, int64_t arg) :
+        Span(name, category)
+    {
+        this->arg = arg;
+        hasarg = true;
+    }
+
+    ~Span()
+    {
+        if (begin != std::chrono::steady_clock::time_point{})
+        {
+            record(name, category, begin, arg, hasarg);
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+  private:
+    const char* const name;
+    const char* const category;
+    std::chrono::steady_clock::time_point begin{};
+    int64_t arg{};
+    bool hasarg{};
+};
+
+} // namespace robot::tracing
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stop_token>
+#include <vector>
+
+namespace robot
+{
+
+// Cartesian position with end of arm tool angle: x, y, z, t
+using waypoint_t = std::array<double, 4>;
+
+enum class interpolation
+{
+    minimumjerk,
+    linear
+};
+
+// Profile through given waypoints, each segment lasts given time, minimum
+// jerk one comes to rest at every waypoint, linear one passes dense
+// waypoints without stopping
+class Trajectory
+{
+  public:
+    Trajectory(const std::vector<waypoint_t>&, std::chrono::milliseconds,
+               interpolation = interpolation::minimumjerk);
+
+    waypoint_t sample(std::chrono::duration<double>) const;
+    std::chrono::milliseconds duration() const;
+
+  private:
+    std::vector<waypoint_t> waypoints;
+    std::chrono::milliseconds segment;
+    interpolation profile;
+};
+
+struct streamstats_t
+{
+    uint64_t setpoints;
+    uint64_t missed;
+    std::chrono::microseconds maxjitter;
+    std::chrono::microseconds sumjitter;
+};
+
+// Sends trajectory setpoints at fixed rate from its own timer thread
+class Streamer
+{
+  public:
+    using sendfunc = std::function<void(const waypoint_t&)>;
+
+    Streamer(sendfunc, std::chrono::milliseconds);
+    ~Streamer();
+
+    std::future<streamstats_t> run(const Trajectory&, std::stop_token);
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace robot
@@ -2,7 +2,10 @@
 
 #include "tts/interfaces/texttovoice.hpp"
 
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace robot
 {
@@ -29,9 +32,14 @@ enum class task
     voicechangeend,
     langchangestart,
     langchangeend,
+    eoatopened,
+    eoatclosed,
     nothingtodo
 };
 
 std::string getttstext(task, tts::language);
+std::vector<std::string> getttstexts(tts::language);
+// Task named as in enumeration, used by behavior scripts
+std::optional<task> gettask(std::string_view);
 
 } // namespace robot
@@ -0,0 +1,4 @@
+cmake_minimum_required(VERSION 3.10)
+
+find_package(Threads REQUIRED)
+find_package(Boost COMPONENTS program_options REQUIRED)
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "robot/kinematics.hpp"
+
+#include <array>
+#include <chrono>
+#include <memory>
+
+namespace sim
+{
+
+using joints_t = robot::roarmm2::joints_t;
+
+// Servo limits per joint: base, shoulder, elbow, hand, radians based
+struct dynamics_t
+{
+    joints_t maxspeed;
+    joints_t maxaccel;
+    std::chrono::microseconds step;
+};
+
+struct armstate_t
+{
+    joints_t position;
+    joints_t velocity;
+    joints_t acceleration;
+    bool locked;
+};
+
+// Joints follow their targets with trapezoidal velocity profile, model is
+// integrated in fixed steps up to the moment its state is requested
+class ArmModel
+{
+  public:
+    ArmModel(const dynamics_t&, const joints_t&);
+    ~ArmModel();
+
+    // speed is given as fraction of joints limits
+    void move(const joints_t&, double);
+    // zero speed or acceleration stands for joint limit
+    void move(size_t, double, double, double);
+    void settorque(bool);
+    armstate_t getstate();
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace sim
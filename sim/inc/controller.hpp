@@ -0,0 +1,28 @@
+#pragma once
+
+#include "armmodel.hpp"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sim
+{
+
+// RoArm-M2 controller answering json commands: 100, 104, 1041, 105, 114,
+// 121, 210, 302, 405, unsupported ones are not answered
+class Controller
+{
+  public:
+    explicit Controller(std::shared_ptr<ArmModel>);
+    ~Controller();
+
+    std::optional<std::string> handle(std::string_view);
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace sim
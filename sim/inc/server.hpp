@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sim
+{
+
+// Each response is delayed by latency with uniformly distributed jitter
+// added in both directions
+struct serverconfig_t
+{
+    std::string address;
+    uint16_t port;
+    std::chrono::microseconds latency;
+    std::chrono::microseconds jitter;
+};
+
+// Minimal HTTP/1.1 endpoint serving json commands given as json parameter
+// of /js path or as request body, connections are kept alive
+class Server
+{
+  public:
+    using requestfunc =
+        std::function<std::optional<std::string>(std::string_view)>;
+
+    Server(const serverconfig_t&, requestfunc);
+    ~Server();
+
+    uint16_t getport() const;
+
+  private:
+    struct Handler;
+    std::unique_ptr<Handler> handler;
+};
+
+} // namespace sim
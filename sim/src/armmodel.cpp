@@ -0,0 +1,192 @@
+#include "armmodel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace sim
+{
+
+struct ArmModel::Handler
+{
+  public:
+    Handler(const dynamics_t& dynamics, const joints_t& initial) :
+        dynamics{dynamics}, last{std::chrono::steady_clock::now()}
+    {
+        if (dynamics.step <= dynamics.step.zero())
+        {
+            throw std::runtime_error("Cannot create arm model");
+        }
+        for (size_t num{}; num < joints.size(); num++)
+        {
+            auto& joint = joints[num];
+            joint.position = joint.target = initial[num];
+            joint.speed = dynamics.maxspeed[num];
+            joint.accel = dynamics.maxaccel[num];
+        }
+    }
+
+    void move(const joints_t& target, double speed)
+    {
+        std::lock_guard lock(mtx);
+        advance();
+        if (locked)
+        {
+            auto factor = std::clamp(speed, 0., 1.);
+            for (size_t num{}; num < joints.size(); num++)
+            {
+                settarget(num, target[num], dynamics.maxspeed[num] * factor,
+                          dynamics.maxaccel[num]);
+            }
+        }
+    }
+
+    void move(size_t joint, double angle, double speed, double accel)
+    {
+        if (joint >= joints.size())
+        {
+            throw std::runtime_error("Joint not present in arm");
+        }
+        std::lock_guard lock(mtx);
+        advance();
+        if (locked)
+        {
+            settarget(joint, angle, speed, accel);
+        }
+    }
+
+    void settorque(bool lock)
+    {
+        std::lock_guard guard(mtx);
+        advance();
+        locked = lock;
+        if (!locked)
+        {
+            // released joints stay where they are
+            std::ranges::for_each(joints, [](auto& joint) {
+                joint.target = joint.position;
+                joint.velocity = joint.acceleration = 0.;
+            });
+        }
+    }
+
+    armstate_t getstate()
+    {
+        std::lock_guard lock(mtx);
+        advance();
+        armstate_t state{};
+        state.locked = locked;
+        for (size_t num{}; num < joints.size(); num++)
+        {
+            state.position[num] = joints[num].position;
+            state.velocity[num] = joints[num].velocity;
+            state.acceleration[num] = joints[num].acceleration;
+        }
+        return state;
+    }
+
+  private:
+    struct joint_t
+    {
+        double position;
+        double velocity;
+        double acceleration;
+        double target;
+        double speed;
+        double accel;
+    };
+
+    const dynamics_t dynamics;
+    std::mutex mtx;
+    std::array<joint_t, 4> joints{};
+    std::chrono::steady_clock::time_point last;
+    bool locked{true};
+
+    void settarget(size_t num, double angle, double speed, double accel)
+    {
+        const auto& limits = robot::roarmm2::model.limits[num];
+        auto& joint = joints[num];
+        joint.target = std::clamp(angle, limits.min, limits.max);
+        joint.speed = speed > 0. ? std::min(speed, dynamics.maxspeed[num])
+                                 : dynamics.maxspeed[num];
+        joint.accel = accel > 0. ? std::min(accel, dynamics.maxaccel[num])
+                                 : dynamics.maxaccel[num];
+    }
+
+    bool issettled() const
+    {
+        return std::ranges::all_of(joints, [](const auto& joint) {
+            return joint.position == joint.target && joint.velocity == 0.;
+        });
+    }
+
+    void advance()
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (issettled())
+        {
+            // nothing moves, so idle time is not integrated
+            std::ranges::for_each(
+                joints, [](auto& joint) { joint.acceleration = 0.; });
+            last = now;
+            return;
+        }
+        auto dt = std::chrono::duration<double>(dynamics.step).count();
+        for (; last + dynamics.step <= now; last += dynamics.step)
+        {
+            std::ranges::for_each(joints,
+                                  [dt](auto& joint) { step(joint, dt); });
+        }
+    }
+
+    static void step(joint_t& joint, double dt)
+    {
+        auto distance = joint.target - joint.position;
+        auto maxdv = joint.accel * dt;
+        if (std::abs(distance) <= maxdv * dt &&
+            std::abs(joint.velocity) <= maxdv)
+        {
+            joint.position = joint.target;
+            joint.acceleration = -joint.velocity / dt;
+            joint.velocity = 0.;
+            return;
+        }
+        // fastest velocity still allowing to stop at target
+        auto reachable = std::sqrt(2. * joint.accel * std::abs(distance));
+        auto desired =
+            std::copysign(std::min(joint.speed, reachable), distance);
+        auto dv = std::clamp(desired - joint.velocity, -maxdv, maxdv);
+        joint.velocity += dv;
+        joint.acceleration = dv / dt;
+        joint.position += joint.velocity * dt;
+    }
+};
+
+ArmModel::ArmModel(const dynamics_t& dynamics, const joints_t& initial) :
+    handler{std::make_unique<Handler>(dynamics, initial)}
+{}
+
+ArmModel::~ArmModel() = default;
+
+void ArmModel::move(const joints_t& target, double speed)
+{
+    handler->move(target, speed);
+}
+
+void ArmModel::move(size_t joint, double angle, double speed, double accel)
+{
+    handler->move(joint, angle, speed, accel);
+}
+
+void ArmModel::settorque(bool lock)
+{
+    handler->settorque(lock);
+}
+
+armstate_t ArmModel::getstate()
+{
+    return handler->getstate();
+}
+
+} // namespace sim
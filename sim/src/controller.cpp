@@ -0,0 +1,213 @@
+#include "controller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+
+namespace sim
+{
+
+using namespace robot::roarmm2;
+
+// pose taken on init command, gripper closed
+static constexpr joints_t initialjoints{0., 0., std::numbers::pi / 2,
+                                        std::numbers::pi};
+// load seen on joints while holding arm against gravity and accelerating
+static constexpr joints_t gravityload{0., -180., 90., 0.};
+static constexpr joints_t inertiaload{4., 8., 4., 1.};
+static constexpr std::string_view deviceinfo{
+    "{\"T\":302,\"mac\":\"a0:b7:65:5a:1e:2c\",\"version\":\"sim-1.0\"}"};
+static constexpr std::string_view wifiinfo{
+    "{\"T\":405,\"ip\":\"127.0.0.1\",\"rssi\":-40,\"wifi_mode_on_boot\":3,"
+    "\"sta_ssid\":\"\",\"ap_ssid\":\"RoArm-M2\"}"};
+
+static std::optional<double> getfield(std::string_view json,
+                                      std::string_view name)
+{
+    for (auto pos = json.find(name); pos != std::string_view::npos;
+         pos = json.find(name, pos + 1))
+    {
+        if (!pos || json[pos - 1] != '"' ||
+            json.substr(pos + name.size(), 2) != "\":")
+        {
+            continue;
+        }
+        auto begin = json.data() + pos + name.size() + 2;
+        auto end = json.data() + json.size();
+        begin = std::find_if(begin, end, [](char c) { return c != ' '; });
+        double value{};
+        if (std::from_chars(begin, end, value).ec == std::errc{})
+        {
+            return value;
+        }
+        return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+static double dgrtorad(double dgr)
+{
+    return dgr * std::numbers::pi / 180.;
+}
+
+static void append(std::string& json, std::string_view name, double value,
+                   int32_t precision = 4)
+{
+    std::array<char, 32> buffer{};
+    auto [end, ec] = std::to_chars(buffer.begin(), buffer.end(), value,
+                                   std::chars_format::fixed, precision);
+    json += ",\"";
+    json += name;
+    json += "\":";
+    json.append(buffer.begin(), ec == std::errc{} ? end : buffer.begin());
+}
+
+struct Controller::Handler
+{
+  public:
+    explicit Handler(std::shared_ptr<ArmModel> arm) : arm{arm}
+    {
+        if (!arm)
+        {
+            throw std::runtime_error("Cannot create controller");
+        }
+    }
+
+    std::optional<std::string> handle(std::string_view json)
+    {
+        auto type = getfield(json, "T");
+        if (!type)
+        {
+            return std::nullopt;
+        }
+        switch ((int32_t)*type)
+        {
+            case 100:
+                arm->move(initialjoints, 1.);
+                return "{}";
+            case 104:
+                return movetopos(json, getfield(json, "spd").value_or(0.));
+            case 1041:
+                return movetopos(json, std::nullopt);
+            case 105:
+                return getfeedback();
+            case 114:
+                if (auto value = getfield(json, "led"))
+                {
+                    std::lock_guard lock(mtx);
+                    led = std::clamp((int32_t)*value, 0, 255);
+                    return "{}";
+                }
+                return std::nullopt;
+            case 121:
+                return movejoint(json);
+            case 210:
+                if (auto cmd = getfield(json, "cmd"))
+                {
+                    arm->settorque(*cmd != 0.);
+                    return "{}";
+                }
+                return std::nullopt;
+            case 302:
+                return std::string{deviceinfo};
+            case 405:
+                return std::string{wifiinfo};
+        }
+        return std::nullopt;
+    }
+
+  private:
+    const std::shared_ptr<ArmModel> arm;
+    std::mutex mtx;
+    int32_t led{};
+
+    // spd of interpolated move is percentage of servos speed, direct
+    // move goes with full speed
+    std::optional<std::string> movetopos(std::string_view json,
+                                         std::optional<double> spd)
+    {
+        auto x = getfield(json, "x"), y = getfield(json, "y"),
+             z = getfield(json, "z"), t = getfield(json, "t");
+        if (!x || !y || !z || !t)
+        {
+            return std::nullopt;
+        }
+        joints_t target{};
+        if (!inverse({*x, *y, *z, *t}, target))
+        {
+            // unreachable pose is ignored by controller
+            return "{}";
+        }
+        arm->move(target, spd && *spd > 0. ? *spd / 100. : 1.);
+        return "{}";
+    }
+
+    // joints are numbered from base, angle in degrees, speed in degrees
+    // per second and acceleration in degrees per second squared
+    std::optional<std::string> movejoint(std::string_view json)
+    {
+        auto joint = getfield(json, "joint"), angle = getfield(json, "angle");
+        if (!joint || !angle || *joint < 1. || *joint > 4.)
+        {
+            return std::nullopt;
+        }
+        arm->move((size_t)*joint - 1, dgrtorad(*angle),
+                  dgrtorad(getfield(json, "spd").value_or(0.)),
+                  dgrtorad(getfield(json, "acc").value_or(0.)));
+        return "{}";
+    }
+
+    std::string getfeedback()
+    {
+        static constexpr std::array<std::string_view, 4> names{"b", "s", "e",
+                                                               "t"};
+        static constexpr std::array<std::string_view, 4> torques{
+            "torB", "torS", "torE", "torH"};
+        auto state = arm->getstate();
+        auto pose = forward(state.position);
+        std::string json{"{\"T\":1051"};
+        append(json, "x", pose[0]);
+        append(json, "y", pose[1]);
+        append(json, "z", pose[2]);
+        for (size_t num{}; num < names.size(); num++)
+        {
+            append(json, names[num], state.position[num]);
+        }
+        for (size_t num{}; num < torques.size(); num++)
+        {
+            append(json, torques[num],
+                   state.locked ? gettorque(state, num) : 0., 0);
+        }
+        json += '}';
+        return json;
+    }
+
+    static double gettorque(const armstate_t& state, size_t num)
+    {
+        const auto& position = state.position;
+        auto gravity = num == 1   ? std::sin(position[1])
+                       : num == 2 ? std::cos(position[1] + position[2])
+                                  : 0.;
+        // zero added to not report negative zero
+        return std::round(gravityload[num] * gravity +
+                          inertiaload[num] * state.acceleration[num]) +
+               0.;
+    }
+};
+
+Controller::Controller(std::shared_ptr<ArmModel> arm) :
+    handler{std::make_unique<Handler>(arm)}
+{}
+
+Controller::~Controller() = default;
+
+std::optional<std::string> Controller::handle(std::string_view json)
+{
+    return handler->handle(json);
+}
+
+} // namespace sim
@@ -0,0 +1,87 @@
+#include "armmodel.hpp"
+#include "controller.hpp"
+#include "server.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <csignal>
+#include <iostream>
+#include <numbers>
+
+int main(int argc, char* argv[])
+{
+    using namespace std::chrono_literals;
+    sim::serverconfig_t config{"0.0.0.0", 80, 0us, 0us};
+    [argc, argv, &config]() {
+        boost::program_options::options_description desc("Allowed options");
+        desc.add_options()("help,h", "produce help message")(
+            "address,a", boost::program_options::value<std::string>(),
+            "address to listen on, default all interfaces")(
+            "port,p", boost::program_options::value<uint16_t>(),
+            "port to listen on, default 80")(
+            "latency,l", boost::program_options::value<uint32_t>(),
+            "response latency in microseconds, default 0")(
+            "jitter,j", boost::program_options::value<uint32_t>(),
+            "latency jitter in microseconds, default 0");
+
+        boost::program_options::variables_map vm;
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+
+        if (vm.contains("help"))
+        {
+            std::cout << desc;
+            exit(0);
+        }
+
+        config.address = vm.contains("address")
+                             ? vm.at("address").as<std::string>()
+                             : config.address;
+        config.port =
+            vm.contains("port") ? vm.at("port").as<uint16_t>() : config.port;
+        config.latency = vm.contains("latency")
+                             ? std::chrono::microseconds{vm.at("latency")
+                                                             .as<uint32_t>()}
+                             : config.latency;
+        config.jitter =
+            vm.contains("jitter")
+                ? std::chrono::microseconds{vm.at("jitter").as<uint32_t>()}
+                : config.jitter;
+    }();
+
+    try
+    {
+        // joint speeds and accelerations of RoArm-M2 servos
+        static constexpr sim::dynamics_t dynamics{
+            .maxspeed = {3., 2., 3., 6.},
+            .maxaccel = {10., 6., 10., 30.},
+            .step = 1ms};
+        static constexpr sim::joints_t initial{0., 0., std::numbers::pi / 2,
+                                               std::numbers::pi};
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        auto arm = std::make_shared<sim::ArmModel>(dynamics, initial);
+        auto controller = std::make_shared<sim::Controller>(arm);
+        sim::Server server(config, [controller](std::string_view json) {
+            return controller->handle(json);
+        });
+        std::cout << "Simulating arm on " << config.address << ":"
+                  << server.getport() << ", latency/jitter "
+                  << config.latency.count() << "/" << config.jitter.count()
+                  << " us\n";
+
+        int32_t signal{};
+        sigwait(&signals, &signal);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,359 @@
+#include "server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <list>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace sim
+{
+
+// how often blocked sockets check for shutdown
+static constexpr int32_t pollperiodms = 100;
+static constexpr size_t maxrequestsize = 64 * 1024;
+
+static std::string urldecode(std::string_view text)
+{
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t pos{}; pos < text.size(); pos++)
+    {
+        if (text[pos] == '%' && pos + 2 < text.size())
+        {
+            uint8_t value{};
+            auto begin = text.data() + pos + 1;
+            if (std::from_chars(begin, begin + 2, value, 16).ptr == begin + 2)
+            {
+                decoded += (char)value;
+                pos += 2;
+                continue;
+            }
+        }
+        decoded += text[pos] == '+' ? ' ' : text[pos];
+    }
+    return decoded;
+}
+
+static bool iequal(std::string_view first, std::string_view second)
+{
+    return std::ranges::equal(first, second, [](char a, char b) {
+        return std::tolower((unsigned char)a) == std::tolower((unsigned char)b);
+    });
+}
+
+struct request_t
+{
+    std::string method;
+    std::string target;
+    std::string body;
+    bool keepalive;
+};
+
+struct Server::Handler
+{
+  public:
+    Handler(const serverconfig_t& config, requestfunc process) :
+        config{config}, process{process}
+    {
+        if (!process || config.jitter < config.jitter.zero() ||
+            config.latency < config.latency.zero())
+        {
+            throw std::runtime_error("Cannot create simulator server");
+        }
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot create server socket");
+        }
+        int32_t enable{1};
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (::inet_pton(AF_INET, config.address.c_str(), &addr.sin_addr) != 1 ||
+            ::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+            ::listen(fd, SOMAXCONN) < 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot listen on " + config.address +
+                                     ":" + std::to_string(config.port));
+        }
+        socklen_t size{sizeof(addr)};
+        ::getsockname(fd, (sockaddr*)&addr, &size);
+        port = ntohs(addr.sin_port);
+        acceptor = std::jthread([this](std::stop_token stoken) {
+            acceptconnections(stoken);
+        });
+    }
+
+    ~Handler()
+    {
+        acceptor.request_stop();
+        acceptor.join();
+        connections.clear();
+        ::close(fd);
+    }
+
+    uint16_t getport() const
+    {
+        return port;
+    }
+
+  private:
+    struct Connection
+    {
+        int32_t fd;
+        std::atomic<bool> finished;
+        std::jthread thread;
+
+        ~Connection()
+        {
+            if (thread.joinable())
+            {
+                thread.request_stop();
+                thread.join();
+            }
+            ::close(fd);
+        }
+    };
+
+    const serverconfig_t config;
+    const requestfunc process;
+    int32_t fd{-1};
+    uint16_t port{};
+    std::list<std::unique_ptr<Connection>> connections;
+    std::jthread acceptor;
+
+    static bool waitreadable(int32_t sock, std::stop_token stoken)
+    {
+        pollfd pfd{.fd = sock, .events = POLLIN, .revents = 0};
+        while (!stoken.stop_requested())
+        {
+            auto ret = ::poll(&pfd, 1, pollperiodms);
+            if (ret > 0)
+            {
+                return true;
+            }
+            if (ret < 0 && errno != EINTR)
+            {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void acceptconnections(std::stop_token stoken)
+    {
+        while (waitreadable(fd, stoken))
+        {
+            auto sock = ::accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+            // finished connections are reaped on next accept
+            connections.remove_if([](const auto& connection) {
+                return connection->finished.load();
+            });
+            if (sock < 0)
+            {
+                continue;
+            }
+            int32_t enable{1};
+            ::setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &enable,
+                         sizeof(enable));
+            auto& connection = connections.emplace_back(
+                std::make_unique<Connection>(sock, false));
+            connection->thread = std::jthread(
+                [this, conn = connection.get()](std::stop_token stoken) {
+                    serve(conn->fd, stoken);
+                    conn->finished = true;
+                });
+        }
+    }
+
+    void serve(int32_t sock, std::stop_token stoken)
+    {
+        std::string buffer;
+        request_t request{};
+        while (readrequest(sock, buffer, request, stoken))
+        {
+            auto json = request.method == "GET" ? getjsonparam(request.target)
+                                                : request.body;
+            auto response = process(json);
+            delay();
+            if (!writeresponse(sock, response, request.keepalive) ||
+                !request.keepalive)
+            {
+                break;
+            }
+        }
+        // descriptor is released when connection is reaped
+        ::shutdown(sock, SHUT_RDWR);
+    }
+
+    bool readrequest(int32_t sock, std::string& buffer, request_t& request,
+                     std::stop_token stoken) const
+    {
+        auto end = buffer.find("\r\n\r\n");
+        while (end == std::string::npos)
+        {
+            if (!readsome(sock, buffer, stoken))
+            {
+                return false;
+            }
+            end = buffer.find("\r\n\r\n");
+        }
+        std::string_view head{buffer.data(), end};
+        auto linelen = head.find("\r\n");
+        std::string_view line = head.substr(0, linelen);
+        auto first = line.find(' '), second = line.rfind(' ');
+        if (first == std::string_view::npos || first == second)
+        {
+            return false;
+        }
+        request.method = line.substr(0, first);
+        request.target = line.substr(first + 1, second - first - 1);
+        request.keepalive = line.substr(second + 1) != "HTTP/1.0";
+
+        size_t bodysize{};
+        while (linelen != std::string_view::npos)
+        {
+            head.remove_prefix(linelen + 2);
+            linelen = head.find("\r\n");
+            auto header = head.substr(0, linelen);
+            auto colon = header.find(':');
+            if (colon == std::string_view::npos)
+            {
+                continue;
+            }
+            auto name = header.substr(0, colon);
+            auto value = header.substr(colon + 1);
+            value.remove_prefix(std::min(value.find_first_not_of(' '),
+                                         value.size()));
+            if (iequal(name, "Content-Length"))
+            {
+                std::from_chars(value.data(), value.data() + value.size(),
+                                bodysize);
+            }
+            else if (iequal(name, "Connection"))
+            {
+                request.keepalive = !iequal(value, "close");
+            }
+        }
+
+        auto total = end + 4 + bodysize;
+        if (total > maxrequestsize)
+        {
+            return false;
+        }
+        while (buffer.size() < total)
+        {
+            if (!readsome(sock, buffer, stoken))
+            {
+                return false;
+            }
+        }
+        request.body = buffer.substr(end + 4, bodysize);
+        buffer.erase(0, total);
+        return true;
+    }
+
+    static bool readsome(int32_t sock, std::string& buffer,
+                         std::stop_token stoken)
+    {
+        std::array<char, 4096> chunk;
+        if (buffer.size() > maxrequestsize || !waitreadable(sock, stoken))
+        {
+            return false;
+        }
+        auto size = ::recv(sock, chunk.data(), chunk.size(), 0);
+        if (size <= 0)
+        {
+            return false;
+        }
+        buffer.append(chunk.data(), (size_t)size);
+        return true;
+    }
+
+    static std::string getjsonparam(std::string_view target)
+    {
+        auto query = target.find('?');
+        while (query != std::string_view::npos)
+        {
+            target.remove_prefix(query + 1);
+            if (target.starts_with("json="))
+            {
+                return urldecode(target.substr(5, target.find('&') - 5));
+            }
+            query = target.find('&');
+        }
+        return {};
+    }
+
+    void delay() const
+    {
+        using namespace std::chrono;
+        thread_local std::mt19937 generator{std::random_device{}()};
+        auto latency = config.latency;
+        if (config.jitter > config.jitter.zero())
+        {
+            std::uniform_int_distribution<int64_t> jitter(
+                -config.jitter.count(), config.jitter.count());
+            latency += microseconds{jitter(generator)};
+        }
+        if (latency > latency.zero())
+        {
+            std::this_thread::sleep_for(latency);
+        }
+    }
+
+    static bool writeresponse(int32_t sock,
+                              const std::optional<std::string>& body,
+                              bool keepalive)
+    {
+        std::string response{body ? "HTTP/1.1 200 OK\r\n"
+                                  : "HTTP/1.1 400 Bad Request\r\n"};
+        response += "Content-Type: application/json\r\nContent-Length: " +
+                    std::to_string(body ? body->size() : 0) + "\r\n";
+        response += keepalive ? "Connection: keep-alive\r\n\r\n"
+                              : "Connection: close\r\n\r\n";
+        if (body)
+        {
+            response += *body;
+        }
+        std::string_view remaining{response};
+        while (!remaining.empty())
+        {
+            auto sent = ::send(sock, remaining.data(), remaining.size(),
+                               MSG_NOSIGNAL);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            remaining.remove_prefix((size_t)sent);
+        }
+        return true;
+    }
+};
+
+Server::Server(const serverconfig_t& config, requestfunc process) :
+    handler{std::make_unique<Handler>(config, process)}
+{}
+
+Server::~Server() = default;
+
+uint16_t Server::getport() const
+{
+    return handler->getport();
+}
+
+} // namespace sim
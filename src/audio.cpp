@@ -0,0 +1,295 @@
+#include "robot/audio.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace robot::audio
+{
+
+static constexpr const char* synthurl =
+    "https://texttospeech.googleapis.com/v1/text:synthesize";
+// access tokens are valid for an hour, renewed well before
+static constexpr auto tokenlifetime = std::chrono::minutes(30);
+static constexpr size_t playchunk = 4096;
+static constexpr auto stoppoll = std::chrono::milliseconds(20);
+
+struct child_t
+{
+    pid_t pid;
+    int in;
+    int out;
+};
+
+static std::optional<child_t> spawn(std::vector<std::string> args)
+{
+    std::array<int, 2> in{}, out{};
+    if (::pipe2(in.data(), O_CLOEXEC))
+    {
+        return std::nullopt;
+    }
+    if (::pipe2(out.data(), O_CLOEXEC))
+    {
+        ::close(in[0]);
+        ::close(in[1]);
+        return std::nullopt;
+    }
+    posix_spawn_file_actions_t actions;
+    ::posix_spawn_file_actions_init(&actions);
+    ::posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+    ::posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+    std::vector<char*> argv;
+    std::ranges::transform(args, std::back_inserter(argv),
+                           [](auto& arg) { return arg.data(); });
+    argv.push_back(nullptr);
+    pid_t pid{};
+    auto failed = ::posix_spawnp(&pid, argv[0], &actions, nullptr,
+                                 argv.data(), environ);
+    ::posix_spawn_file_actions_destroy(&actions);
+    ::close(in[0]);
+    ::close(out[1]);
+    if (failed)
+    {
+        ::close(in[1]);
+        ::close(out[0]);
+        return std::nullopt;
+    }
+    return child_t{pid, in[1], out[0]};
+}
+
+// child is ended when stop is requested before it exits by itself
+static bool finish(child_t& child, std::stop_token stoken = {})
+{
+    if (child.in >= 0)
+    {
+        ::close(child.in);
+    }
+    ::close(child.out);
+    int status{};
+    if (stoken.stop_possible())
+    {
+        pid_t pid{};
+        while ((pid = ::waitpid(child.pid, &status, WNOHANG)) == 0 &&
+               !stoken.stop_requested())
+        {
+            std::this_thread::sleep_for(stoppoll);
+        }
+        if (pid == 0)
+        {
+            ::kill(child.pid, SIGTERM);
+        }
+        else if (pid > 0)
+        {
+            return WIFEXITED(status) && !WEXITSTATUS(status);
+        }
+    }
+    while (::waitpid(child.pid, &status, 0) < 0 && errno == EINTR)
+    {}
+    return WIFEXITED(status) && !WEXITSTATUS(status);
+}
+
+static bool writeall(int fd, std::span<const char> data)
+{
+    while (!data.empty())
+    {
+        auto num = ::write(fd, data.data(), data.size());
+        if (num < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (num <= 0)
+        {
+            return false;
+        }
+        data = data.subspan((size_t)num);
+    }
+    return true;
+}
+
+// program is given whole input before its output is read, as tools used
+// read their input completely first
+static bool run(std::vector<std::string> args, std::string_view input,
+                std::string& output)
+{
+    auto child = spawn(std::move(args));
+    if (!child)
+    {
+        return false;
+    }
+    auto written = writeall(child->in, input);
+    ::close(child->in);
+    child->in = -1;
+    std::array<char, 4096> chunk;
+    for (ssize_t num{};
+         (num = ::read(child->out, chunk.data(), chunk.size())) != 0;)
+    {
+        if (num > 0)
+        {
+            output.append(chunk.data(), (size_t)num);
+        }
+        else if (errno != EINTR)
+        {
+            break;
+        }
+    }
+    return finish(*child) && written;
+}
+
+static std::optional<std::string> gettoken()
+{
+    static std::mutex mtx;
+    static std::string token;
+    static std::chrono::steady_clock::time_point expiry;
+    std::lock_guard lock(mtx);
+    if (token.empty() || std::chrono::steady_clock::now() >= expiry)
+    {
+        std::string output;
+        if (!run({"gcloud", "auth", "print-access-token"}, {}, output))
+        {
+            return std::nullopt;
+        }
+        output.erase(output.find_last_not_of(" \r\n") + 1);
+        token = output;
+        expiry = std::chrono::steady_clock::now() + tokenlifetime;
+    }
+    return token;
+}
+
+static void appendjson(std::string& json, std::string_view text)
+{
+    json += '"';
+    std::ranges::for_each(text, [&json](char c) {
+        if (c == '"' || c == '\\')
+        {
+            (json += '\\') += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            json += ' ';
+        }
+        else
+        {
+            json += c;
+        }
+    });
+    json += '"';
+}
+
+static std::string getrequest(const phrase_t& phrase)
+{
+    const auto& [lang, gender, rate] = phrase.voice;
+    static constexpr auto codes = std::to_array<const char*>(
+        {"pl-PL", "en-US", "de-DE"});
+    std::string json{"{\"input\":{\"text\":"};
+    appendjson(json, phrase.text);
+    json += "},\"voice\":{\"languageCode\":\"";
+    json += codes.at((size_t)lang);
+    json += "\",\"ssmlGender\":\"";
+    json += gender == tts::gender::male ? "MALE" : "FEMALE";
+    json += "\"},\"audioConfig\":{\"audioEncoding\":\"LINEAR16\","
+            "\"speakingRate\":";
+    json += std::to_string(rate);
+    return json += "}}";
+}
+
+static bool decodebase64(std::string_view text, std::vector<char>& data)
+{
+    static constexpr std::string_view alphabet{
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+    uint32_t bits{}, count{};
+    for (auto c : text)
+    {
+        if (c == '=')
+        {
+            break;
+        }
+        auto value = alphabet.find(c);
+        if (value == std::string_view::npos)
+        {
+            return false;
+        }
+        bits = (bits << 6) | (uint32_t)value;
+        if ((count += 6) >= 8)
+        {
+            count -= 8;
+            data.push_back((char)((bits >> count) & 0xff));
+        }
+    }
+    return !data.empty();
+}
+
+bool synthesize(const phrase_t& phrase, std::vector<char>& audio)
+{
+    auto token = gettoken();
+    std::string response;
+    if (!token || !run({"curl", "-sf", "-X", "POST", "-H",
+                        "Authorization: Bearer " + *token, "-H",
+                        "Content-Type: application/json; charset=utf-8",
+                        "--data-binary", "@-", synthurl},
+                       getrequest(phrase), response))
+    {
+        return false;
+    }
+    static constexpr std::string_view key{"\"audioContent\""};
+    auto pos = response.find(key);
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    auto begin = response.find('"', pos + key.size());
+    auto end = response.find('"', begin + 1);
+    if (begin == std::string::npos || end == std::string::npos)
+    {
+        return false;
+    }
+    return decodebase64(
+        std::string_view{response}.substr(begin + 1, end - begin - 1),
+        audio);
+}
+
+bool play(std::span<const char> audio, std::stop_token stoken)
+{
+    auto child = spawn({"aplay", "-q", "-"});
+    if (!child)
+    {
+        return false;
+    }
+    // written in chunks and waited for, player is ended once stop is seen
+    while (!audio.empty() && !stoken.stop_requested())
+    {
+        pollfd pfd{child->in, POLLOUT, 0};
+        if (::poll(&pfd, 1, (int)stoppoll.count()) <= 0)
+        {
+            continue;
+        }
+        auto chunk = audio.first(std::min(audio.size(), playchunk));
+        if (!writeall(child->in, chunk))
+        {
+            break;
+        }
+        audio = audio.subspan(chunk.size());
+    }
+    if (stoken.stop_requested())
+    {
+        ::kill(child->pid, SIGTERM);
+    }
+    return finish(*child, stoken) && !stoken.stop_requested();
+}
+
+} // namespace robot::audio
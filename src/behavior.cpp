@@ -0,0 +1,1007 @@
+#include "robot/behavior.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+using namespace std::chrono_literals;
+
+// instructions one behavior may execute before it has to yield
+static constexpr uint32_t slicebudget = 256;
+
+enum class blockkind
+{
+    behavior,
+    loop,
+    repeat,
+    branch,
+    otherwise,
+    choose
+};
+
+enum class ledkind : uint8_t
+{
+    off,
+    fade,
+    pulse,
+    breathe
+};
+
+enum class untilkind : uint8_t
+{
+    hand,
+    arrived
+};
+
+struct compiled_t
+{
+    std::vector<instruction_t> code;
+    std::vector<std::pair<std::string, uint16_t>> entries;
+    uint16_t counters;
+};
+
+class Compiler
+{
+  public:
+    explicit Compiler(std::string_view script) : script{script}
+    {}
+
+    compiled_t compile()
+    {
+        size_t begin{};
+        while (begin <= script.size())
+        {
+            auto end = std::min(script.find('\n', begin), script.size());
+            auto line = script.substr(begin, end - begin);
+            line = line.substr(0, line.find('#'));
+            lineno++;
+            if (auto words = split(line); !words.empty())
+            {
+                statement(words.front(), std::span(words).subspan(1));
+            }
+            begin = end + 1;
+        }
+        if (!blocks.empty())
+        {
+            fail("missing end of behavior");
+        }
+        resolve();
+        return std::move(result);
+    }
+
+  private:
+    using args_t = std::span<const std::string_view>;
+
+    struct block_t
+    {
+        blockkind kind;
+        size_t head;
+        std::vector<size_t> exits{};
+        uint32_t statements{};
+    };
+
+    struct reference_t
+    {
+        size_t instruction;
+        std::string_view name;
+        uint32_t lineno;
+    };
+
+    const std::string_view script;
+    uint32_t lineno{};
+    compiled_t result{};
+    std::vector<block_t> blocks;
+    std::vector<reference_t> references;
+
+    [[noreturn]] void fail(const std::string& what) const
+    {
+        fail(what, lineno);
+    }
+
+    [[noreturn]] static void fail(const std::string& what, uint32_t lineno)
+    {
+        throw std::runtime_error("Behavior script line " +
+                                 std::to_string(lineno) + ": " + what);
+    }
+
+    static std::vector<std::string_view> split(std::string_view line)
+    {
+        static constexpr std::string_view blanks{" \t\r"};
+        std::vector<std::string_view> words;
+        size_t begin{};
+        while ((begin = line.find_first_not_of(blanks, begin)) !=
+               std::string_view::npos)
+        {
+            auto end = std::min(line.find_first_of(blanks, begin), line.size());
+            words.push_back(line.substr(begin, end - begin));
+            begin = end;
+        }
+        return words;
+    }
+
+    int32_t number(std::string_view word, int32_t min = INT32_MIN,
+                   int32_t max = INT32_MAX) const
+    {
+        int32_t value{};
+        auto [end, error] =
+            std::from_chars(word.data(), word.data() + word.size(), value);
+        if (error != std::errc{} || end != word.data() + word.size())
+        {
+            fail("invalid number '" + std::string(word) + "'");
+        }
+        if (value < min || value > max)
+        {
+            fail("number '" + std::string(word) + "' out of range");
+        }
+        return value;
+    }
+
+    void expect(args_t args, size_t min, size_t max) const
+    {
+        if (args.size() < min || args.size() > max)
+        {
+            fail("wrong number of arguments");
+        }
+    }
+
+    void expect(args_t args, size_t count) const
+    {
+        expect(args, count, count);
+    }
+
+    size_t emit(const instruction_t& instruction)
+    {
+        if (result.code.size() >= UINT16_MAX)
+        {
+            fail("behaviors too long");
+        }
+        result.code.push_back(instruction);
+        return result.code.size() - 1;
+    }
+
+    uint16_t here() const
+    {
+        return (uint16_t)result.code.size();
+    }
+
+    uint16_t slot()
+    {
+        return result.counters++;
+    }
+
+    void statement(std::string_view keyword, args_t args)
+    {
+        if (blocks.empty())
+        {
+            if (keyword != "behavior")
+            {
+                fail("statement outside of behavior");
+            }
+            open(args);
+            return;
+        }
+        if (keyword == "end")
+        {
+            expect(args, 0);
+            close();
+            return;
+        }
+        if (keyword == "else")
+        {
+            expect(args, 0);
+            otherwise();
+            return;
+        }
+
+        if (keyword == "behavior")
+        {
+            fail("behaviors cannot be nested");
+        }
+        bool opening = keyword == "loop" || keyword == "repeat" ||
+                       keyword == "if" || keyword == "ifnot" ||
+                       keyword == "choose";
+        if (blocks.back().kind == blockkind::choose)
+        {
+            if (opening)
+            {
+                fail("only single statements can be chosen");
+            }
+            simple(keyword, args);
+            auto& choice = blocks.back();
+            choice.statements++;
+            choice.exits.push_back(emit({.op = opcode::jump}));
+            return;
+        }
+        if (keyword == "loop")
+        {
+            expect(args, 0);
+            begin(blockkind::loop, emit({.op = opcode::loop}));
+        }
+        else if (keyword == "repeat")
+        {
+            expect(args, 1);
+            begin(blockkind::repeat,
+                  emit({.op = opcode::repeat,
+                        .args = {number(args[0], 0), slot()}}));
+        }
+        else if (keyword == "if" || keyword == "ifnot")
+        {
+            expect(args, 0);
+            begin(blockkind::branch,
+                  emit({.op = opcode::branch,
+                        .variant = (uint8_t)(keyword == "ifnot")}));
+        }
+        else if (keyword == "choose")
+        {
+            expect(args, 0);
+            begin(blockkind::choose,
+                  emit({.op = opcode::choose, .args = {0, slot()}}));
+        }
+        else
+        {
+            simple(keyword, args);
+        }
+    }
+
+    void open(args_t args)
+    {
+        expect(args, 1);
+        if (std::ranges::find(result.entries, args[0],
+                              &std::pair<std::string, uint16_t>::first) !=
+            result.entries.end())
+        {
+            fail("behavior " + std::string(args[0]) + " already defined");
+        }
+        result.entries.emplace_back(args[0], here());
+        begin(blockkind::behavior, here());
+    }
+
+    void begin(blockkind kind, size_t head)
+    {
+        blocks.push_back({.kind = kind, .head = head});
+    }
+
+    void close()
+    {
+        auto block = std::move(blocks.back());
+        blocks.pop_back();
+        auto& code = result.code;
+        switch (block.kind)
+        {
+            case blockkind::behavior:
+                emit({.op = opcode::finish});
+                break;
+            case blockkind::loop:
+                emit({.op = opcode::jump, .target = (uint16_t)block.head});
+                code[block.head].target = here();
+                break;
+            case blockkind::repeat:
+                emit({.op = opcode::next,
+                      .target = (uint16_t)(block.head + 1),
+                      .args = {0, code[block.head].args[1]}});
+                code[block.head].target = here();
+                break;
+            case blockkind::branch:
+            case blockkind::otherwise:
+                code[block.head].target = here();
+                break;
+            case blockkind::choose:
+                if (!block.statements)
+                {
+                    fail("nothing to choose from");
+                }
+                code[block.head].args[0] = (int32_t)block.statements;
+                break;
+        }
+        std::ranges::for_each(block.exits, [this](auto exit) {
+            result.code[exit].target = here();
+        });
+    }
+
+    void otherwise()
+    {
+        if (blocks.back().kind != blockkind::branch)
+        {
+            fail("else without if");
+        }
+        auto& block = blocks.back();
+        auto skip = emit({.op = opcode::jump});
+        result.code[block.head].target = here();
+        block.kind = blockkind::otherwise;
+        block.head = skip;
+    }
+
+    void leave()
+    {
+        auto loop = std::ranges::find_if(
+            blocks.rbegin(), blocks.rend(), [](const auto& block) {
+                return block.kind == blockkind::loop ||
+                       block.kind == blockkind::repeat ||
+                       block.kind == blockkind::behavior;
+            });
+        if (loop->kind == blockkind::behavior)
+        {
+            fail("break outside of loop");
+        }
+        loop->exits.push_back(emit({.op = opcode::jump}));
+    }
+
+    void pose(args_t args, instruction_t& instruction) const
+    {
+        for (size_t num{}; num < 4; num++)
+        {
+            instruction.args[num] = number(args[num]);
+        }
+    }
+
+    void simple(std::string_view keyword, args_t args)
+    {
+        instruction_t instruction{};
+        if (keyword == "move")
+        {
+            expect(args, 4, 5);
+            instruction.op = opcode::move;
+            pose(args, instruction);
+            instruction.args[4] = args.size() > 4 ? number(args[4], 1) : 0;
+        }
+        else if (keyword == "glide")
+        {
+            expect(args, 5);
+            instruction.op = opcode::glide;
+            pose(args, instruction);
+            instruction.args[4] = number(args[4], 1);
+        }
+        else if (keyword == "base" || keyword == "hush" ||
+                 keyword == "ledwait" || keyword == "succeed")
+        {
+            expect(args, 0);
+            instruction.op = keyword == "base"      ? opcode::base
+                             : keyword == "hush"    ? opcode::hush
+                             : keyword == "ledwait" ? opcode::ledwait
+                                                    : opcode::succeed;
+        }
+        else if (keyword == "say" || keyword == "sing")
+        {
+            expect(args, 1);
+            auto cue = gettask(args[0]);
+            if (!cue)
+            {
+                fail("unknown cue " + std::string(args[0]));
+            }
+            instruction.op = keyword == "say" ? opcode::say : opcode::sing;
+            instruction.args[0] = (int32_t)*cue;
+        }
+        else if (keyword == "speechwait" || keyword == "wait")
+        {
+            expect(args, 1);
+            instruction.op =
+                keyword == "wait" ? opcode::wait : opcode::speechwait;
+            instruction.args[0] = number(args[0], 0);
+        }
+        else if (keyword == "led")
+        {
+            instruction.op = opcode::led;
+            light(args, instruction);
+        }
+        else if (keyword == "until")
+        {
+            expect(args, 1);
+            instruction.op = opcode::until;
+            if (args[0] == "hand")
+                instruction.variant = (uint8_t)untilkind::hand;
+            else if (args[0] == "arrived")
+                instruction.variant = (uint8_t)untilkind::arrived;
+            else
+                fail("unknown condition " + std::string(args[0]));
+        }
+        else if (keyword == "grip")
+        {
+            expect(args, 1);
+            if (args[0] != "open" && args[0] != "close")
+            {
+                fail("gripper can only open or close");
+            }
+            instruction.op = opcode::grip;
+            instruction.variant = (uint8_t)(args[0] == "close");
+        }
+        else if (keyword == "start" || keyword == "stop")
+        {
+            expect(args, 1);
+            instruction.op =
+                keyword == "start" ? opcode::start : opcode::stop;
+            references.push_back({here(), args[0], lineno});
+        }
+        else if (keyword == "break")
+        {
+            expect(args, 0);
+            leave();
+            return;
+        }
+        else
+        {
+            fail("unknown statement " + std::string(keyword));
+        }
+        emit(instruction);
+    }
+
+    void light(args_t args, instruction_t& instruction) const
+    {
+        if (args.size() == 1 && args[0] == "off")
+        {
+            instruction.variant = (uint8_t)ledkind::off;
+            return;
+        }
+        expect(args, 4);
+        if (args[0] == "fade")
+            instruction.variant = (uint8_t)ledkind::fade;
+        else if (args[0] == "pulse")
+            instruction.variant = (uint8_t)ledkind::pulse;
+        else if (args[0] == "breathe")
+            instruction.variant = (uint8_t)ledkind::breathe;
+        else
+            fail("unknown led effect " + std::string(args[0]));
+        instruction.args[0] = number(args[1], 0, UINT8_MAX);
+        instruction.args[1] = number(args[2], 0, UINT8_MAX);
+        instruction.args[2] = number(args[3], 1);
+    }
+
+    void resolve()
+    {
+        std::ranges::for_each(references, [this](const auto& reference) {
+            auto entry = std::ranges::find(
+                result.entries, reference.name,
+                &std::pair<std::string, uint16_t>::first);
+            if (entry == result.entries.end())
+            {
+                fail("unknown behavior " + std::string(reference.name),
+                     reference.lineno);
+            }
+            result.code[reference.instruction].args[0] = entry->second;
+        });
+    }
+};
+
+Program::Program(std::string_view script)
+{
+    auto compiled = Compiler(script).compile();
+    code = std::move(compiled.code);
+    entries = std::move(compiled.entries);
+    counters = compiled.counters;
+}
+
+std::optional<size_t> Program::find(std::string_view name) const
+{
+    auto entry = std::ranges::find(entries, name,
+                                   &std::pair<std::string, uint16_t>::first);
+    if (entry != entries.end())
+    {
+        return entry->second;
+    }
+    return std::nullopt;
+}
+
+const instruction_t& Program::at(size_t pos) const
+{
+    return code.at(pos);
+}
+
+size_t Program::size() const
+{
+    return code.size();
+}
+
+size_t Program::slots() const
+{
+    return counters;
+}
+
+pollfunc topoll(bool outcome)
+{
+    return [outcome]() -> std::optional<bool> { return outcome; };
+}
+
+pollfunc topoll(std::future<bool> future)
+{
+    if (!future.valid())
+    {
+        return topoll(true);
+    }
+    auto shared = std::make_shared<std::future<bool>>(std::move(future));
+    return [shared]() -> std::optional<bool> {
+        if (shared->wait_for(0s) != std::future_status::ready)
+        {
+            return std::nullopt;
+        }
+        return shared->get();
+    };
+}
+
+struct Scheduler::Handler
+{
+  public:
+    Handler(std::shared_ptr<const Program> program,
+            std::chrono::milliseconds tick) :
+        program{program}, tick{tick}
+    {
+        if (!this->program)
+        {
+            throw std::runtime_error("Scheduler needs compiled behaviors");
+        }
+        if (tick <= 0ms)
+        {
+            throw std::runtime_error("Scheduler needs positive tick");
+        }
+        thread = std::jthread([this](std::stop_token stoken) {
+            process(stoken);
+        });
+    }
+
+    std::future<bool> run(std::string_view name, actions_t actions)
+    {
+        auto entry = program->find(name);
+        if (!entry)
+        {
+            throw std::runtime_error("Unknown behavior " + std::string(name));
+        }
+        auto instance = std::make_shared<instance_t>(
+            std::move(actions), *entry, program->slots());
+        auto result = instance->result.get_future();
+        {
+            std::lock_guard lock(mtx);
+            incoming.push_back(std::move(instance));
+            stats.runs++;
+        }
+        cv.notify_all();
+        return result;
+    }
+
+    void attach(tickfunc func)
+    {
+        {
+            std::lock_guard lock(mtx);
+            attaching.push_back(std::move(func));
+        }
+        cv.notify_all();
+    }
+
+    schedulerstats_t getstats() const
+    {
+        std::lock_guard lock(mtx);
+        return stats;
+    }
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct instance_t
+    {
+        instance_t(actions_t actions, size_t entry, size_t slots) :
+            actions{std::move(actions)}, entry{entry}, pc{entry},
+            counters(slots)
+        {}
+
+        actions_t actions;
+        const size_t entry;
+        size_t pc;
+        std::vector<int32_t> counters;
+        std::optional<waypoint_t> pose;
+        std::optional<waypoint_t> nextpose;
+        pollfunc pending;
+        // whether outcome of pending action is tested by branches
+        bool deciding{};
+        std::deque<pollfunc> speech;
+        clock::time_point wake{};
+        std::stop_source source;
+        bool stopping{};
+        bool halted{};
+        bool outcome{};
+        bool succeeded{};
+        bool finished{};
+        std::exception_ptr error;
+        const instance_t* parent{};
+        std::vector<std::shared_ptr<instance_t>> children;
+        std::promise<bool> result;
+    };
+
+    const std::shared_ptr<const Program> program;
+    const std::chrono::milliseconds tick;
+    std::mt19937 generator{std::random_device{}()};
+    mutable std::mutex mtx;
+    std::condition_variable_any cv;
+    std::vector<std::shared_ptr<instance_t>> incoming;
+    std::vector<std::shared_ptr<instance_t>> active;
+    std::vector<tickfunc> attaching;
+    std::vector<tickfunc> attached;
+    schedulerstats_t stats{};
+    uint64_t executed{};
+    // effect last set by any behavior, there is single led
+    bool endlesslight{};
+    std::jthread thread;
+
+    void process(std::stop_token stoken)
+    {
+        std::unique_lock lock(mtx);
+        while (!stoken.stop_requested())
+        {
+            std::ranges::move(incoming, std::back_inserter(active));
+            incoming.clear();
+            std::ranges::move(attaching, std::back_inserter(attached));
+            attaching.clear();
+            if (active.empty() && attached.empty())
+            {
+                cv.wait(lock, stoken, [this]() {
+                    return !incoming.empty() || !attaching.empty();
+                });
+                continue;
+            }
+            lock.unlock();
+
+            auto wake = clock::now() + tick;
+            std::erase_if(attached, [](const auto& func) { return !func(); });
+            // behaviors started during slice are stepped in it as well
+            for (size_t num{}; num < active.size(); num++)
+            {
+                auto instance = active[num];
+                step(*instance);
+                if (!instance->finished && !instance->pending &&
+                    instance->wake > clock::now())
+                {
+                    wake = std::min(wake, instance->wake);
+                }
+            }
+            auto running = active.size();
+            std::erase_if(active, [](const auto& instance) {
+                return instance->finished;
+            });
+
+            lock.lock();
+            stats.slices++;
+            stats.instructions += std::exchange(executed, 0);
+            stats.maxactive = std::max(stats.maxactive, running);
+            cv.wait_until(lock, stoken, wake, [this]() {
+                return !incoming.empty() || !attaching.empty();
+            });
+        }
+    }
+
+    bool isstopping(const instance_t& instance) const
+    {
+        // only top behavior polls for stop, so no request is consumed by
+        // behaviors it started
+        if (instance.parent)
+        {
+            return instance.halted || instance.parent->stopping;
+        }
+        return instance.halted ||
+               (instance.actions.isstopped && instance.actions.isstopped());
+    }
+
+    void step(instance_t& instance)
+    {
+        if (!instance.stopping && isstopping(instance))
+        {
+            instance.stopping = true;
+            instance.source.request_stop();
+        }
+        try
+        {
+            if (instance.error)
+            {
+                complete(instance);
+                return;
+            }
+            if (instance.pending && !poll(instance))
+            {
+                return;
+            }
+            if (!instance.stopping && clock::now() < instance.wake)
+            {
+                return;
+            }
+            for (auto budget = slicebudget; budget && execute(instance);
+                 budget--)
+                ;
+        }
+        catch (...)
+        {
+            instance.error = std::current_exception();
+            instance.pending = nullptr;
+            complete(instance);
+        }
+    }
+
+    // pc is advanced unless instruction has to be retried, false is
+    // returned when behavior has to yield
+    bool execute(instance_t& instance)
+    {
+        const auto& instruction = program->at(instance.pc);
+        const auto& args = instruction.args;
+        executed++;
+        switch (instruction.op)
+        {
+            case opcode::move:
+                instance.pose = topose(args);
+                return await(instance,
+                             instance.actions.move(*instance.pose,
+                                                   (uint32_t)args[4]),
+                             false);
+            case opcode::glide:
+                instance.nextpose = topose(args);
+                return await(instance,
+                             instance.actions.glide(
+                                 instance.pose, *instance.nextpose,
+                                 std::chrono::milliseconds(args[4]),
+                                 instance.source.get_token()));
+            case opcode::base:
+                instance.pose.reset();
+                return await(instance, instance.actions.base(), false);
+            case opcode::say:
+                instance.speech.push_back(instance.actions.say((task)args[0]));
+                break;
+            case opcode::sing:
+                if (!instance.stopping)
+                {
+                    instance.speech.push_back(
+                        instance.actions.sing((task)args[0]));
+                }
+                break;
+            case opcode::speechwait:
+                std::erase_if(instance.speech, [](const auto& spoken) {
+                    return spoken().has_value();
+                });
+                if (!instance.stopping &&
+                    instance.speech.size() > (size_t)args[0])
+                {
+                    return false;
+                }
+                break;
+            case opcode::hush:
+                instance.actions.hush();
+                break;
+            case opcode::led:
+                endlesslight = (ledkind)instruction.variant == ledkind::pulse ||
+                               (ledkind)instruction.variant == ledkind::breathe;
+                return await(instance,
+                             instance.actions.light(geteffect(instruction)),
+                             false);
+            case opcode::ledwait:
+                // endless effect would never be waited out
+                if (endlesslight)
+                {
+                    break;
+                }
+                return await(instance,
+                             [&instance, poll = instance.actions.lightwait()]()
+                                 -> std::optional<bool> {
+                                 if (instance.stopping)
+                                 {
+                                     return false;
+                                 }
+                                 return poll();
+                             });
+            case opcode::wait:
+                if (!instance.stopping)
+                {
+                    instance.wake =
+                        clock::now() + std::chrono::milliseconds(args[0]);
+                    instance.pc++;
+                    return false;
+                }
+                break;
+            case opcode::until:
+                if ((untilkind)instruction.variant == untilkind::hand)
+                {
+                    return await(instance, instance.actions.hand(
+                                               instance.source.get_token()));
+                }
+                if (instance.pose)
+                {
+                    return await(instance,
+                                 instance.actions.arrival(*instance.pose));
+                }
+                instance.outcome = false;
+                break;
+            case opcode::grip:
+                return await(instance,
+                             instance.actions.grip(instruction.variant));
+            case opcode::branch:
+                instance.pc = instance.outcome == (bool)instruction.variant
+                                  ? instruction.target
+                                  : instance.pc + 1;
+                return true;
+            case opcode::jump:
+                instance.pc = instruction.target;
+                return true;
+            case opcode::loop:
+                instance.pc =
+                    instance.stopping ? instruction.target : instance.pc + 1;
+                return true;
+            case opcode::repeat:
+                instance.counters[(size_t)args[1]] = args[0];
+                instance.pc = instance.stopping || args[0] <= 0
+                                  ? instruction.target
+                                  : instance.pc + 1;
+                return true;
+            case opcode::next:
+                instance.pc = !instance.stopping &&
+                                      --instance.counters[(size_t)args[1]] > 0
+                                  ? instruction.target
+                                  : instance.pc + 1;
+                return true;
+            case opcode::choose:
+                instance.pc += 1 + 2 * choose(instance, args[0], args[1]);
+                return true;
+            case opcode::start:
+                start(instance, (size_t)args[0]);
+                break;
+            case opcode::stop:
+                std::ranges::for_each(
+                    instance.children, [entry = (size_t)args[0]](auto& child) {
+                        child->halted = child->halted || child->entry == entry;
+                    });
+                if (!reap(instance))
+                {
+                    return false;
+                }
+                break;
+            case opcode::succeed:
+                instance.succeeded = true;
+                break;
+            case opcode::finish:
+                complete(instance);
+                return false;
+        }
+        instance.pc++;
+        return true;
+    }
+
+    // behavior goes on at once when action is already done
+    bool await(instance_t& instance, pollfunc pending, bool deciding = true)
+    {
+        instance.pending = std::move(pending);
+        instance.deciding = deciding;
+        instance.pc++;
+        return poll(instance);
+    }
+
+    bool poll(instance_t& instance)
+    {
+        auto outcome = instance.pending();
+        if (!outcome)
+        {
+            return false;
+        }
+        instance.pending = nullptr;
+        if (instance.deciding)
+        {
+            instance.outcome = *outcome;
+        }
+        if (instance.nextpose && *outcome)
+        {
+            instance.pose = instance.nextpose;
+        }
+        instance.nextpose.reset();
+        return true;
+    }
+
+    size_t choose(instance_t& instance, int32_t count, int32_t slot)
+    {
+        // slot keeps previous choice increased by one, zero when none
+        auto& previous = instance.counters[(size_t)slot];
+        auto exclude = previous > 0 && count > 1;
+        std::uniform_int_distribution<int32_t> rand(0, count - 1 - exclude);
+        auto choice = rand(generator);
+        if (exclude && choice >= previous - 1)
+        {
+            choice++;
+        }
+        previous = choice + 1;
+        return (size_t)choice;
+    }
+
+    void start(instance_t& instance, size_t entry)
+    {
+        auto child = std::make_shared<instance_t>(instance.actions, entry,
+                                                  program->slots());
+        child->parent = &instance;
+        instance.children.push_back(child);
+        active.push_back(std::move(child));
+        std::lock_guard lock(mtx);
+        stats.runs++;
+    }
+
+    // false while some of children is still running
+    bool reap(instance_t& instance)
+    {
+        std::erase_if(instance.children, [&instance](const auto& child) {
+            if (child->finished && child->error && !instance.error)
+            {
+                instance.error = child->error;
+            }
+            return child->finished;
+        });
+        return instance.children.empty();
+    }
+
+    // behavior ends once behaviors it started are finished, their failure
+    // fails it as well
+    void complete(instance_t& instance)
+    {
+        std::ranges::for_each(instance.children,
+                              [](auto& child) { child->halted = true; });
+        if (!reap(instance))
+        {
+            return;
+        }
+        if (instance.error)
+        {
+            instance.result.set_exception(instance.error);
+        }
+        else
+        {
+            instance.result.set_value(instance.succeeded);
+        }
+        instance.finished = true;
+    }
+
+    static waypoint_t topose(const std::array<int32_t, 5>& args)
+    {
+        return {(double)args[0], (double)args[1], (double)args[2],
+                (double)args[3] * M_PI / 180.};
+    }
+
+    static effect_t geteffect(const instruction_t& instruction)
+    {
+        const auto from = (uint8_t)instruction.args[0];
+        const auto to = (uint8_t)instruction.args[1];
+        const auto time = std::chrono::milliseconds(instruction.args[2]);
+        switch ((ledkind)instruction.variant)
+        {
+            case ledkind::off:
+                break;
+            case ledkind::fade:
+                return ledeffect::fade(from, to, time);
+            case ledkind::pulse:
+                return ledeffect::pulse(from, to, time);
+            case ledkind::breathe:
+                return ledeffect::breathe(from, to, time);
+        }
+        return {};
+    }
+};
+
+Scheduler::Scheduler(std::shared_ptr<const Program> program,
+                     std::chrono::milliseconds tick) :
+    handler{std::make_unique<Handler>(program, tick)}
+{}
+
+Scheduler::~Scheduler() = default;
+
+std::future<bool> Scheduler::run(std::string_view name, actions_t actions)
+{
+    return handler->run(name, std::move(actions));
+}
+
+void Scheduler::attach(tickfunc func)
+{
+    handler->attach(std::move(func));
+}
+
+schedulerstats_t Scheduler::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -0,0 +1,142 @@
+#include "robot/behaviorscripts.hpp"
+
+namespace robot
+{
+
+static constexpr std::string_view behaviorscript = R"(
+# poses are x y z in millimeters and tool angle in degrees
+
+behavior shakehand
+    move 175 235 325 145 100
+    say greetstart
+    wait 2000
+    loop
+        until hand
+        ifnot
+            break
+        end
+        grip close
+        # gripper stopped on a hand before it closed
+        ifnot
+            say greetshake
+            repeat 3
+                move 245 310 215 180 150
+                until arrived
+                move 215 280 335 180 150
+                until arrived
+            end
+            move 175 235 325 145 100
+            say greetend
+            wait 1000
+            succeed
+            break
+        end
+        say greetfail
+        move 175 235 325 145 100
+        wait 2000
+    end
+    base
+end
+
+behavior dance
+    move 175 235 325 145 100
+    say dancestart
+    start song
+    led pulse 10 125 1500
+    # trajectories start from base pose, so arm has to be there
+    until arrived
+    loop
+        choose
+            glide -65 145 160 115 800
+            glide -140 320 355 180 800
+            glide 65 35 95 155 800
+            glide 60 110 455 135 800
+            glide 12 400 -75 170 800
+        end
+    end
+    stop song
+    # lights go off while arm is moving back
+    led off
+    move 175 235 325 145 100
+    base
+    succeed
+end
+
+behavior song
+    # next line is queued while current one is sung, so it is
+    # synthesized in advance
+    loop
+        sing songlinefirst
+        speechwait 2
+        sing songlinesecond
+        speechwait 2
+        sing songlinethird
+        speechwait 2
+        sing songlineforth
+        speechwait 2
+    end
+    # drop line that may have been queued while stopping
+    hush
+    say danceend
+end
+
+behavior enlight
+    say enlightstart
+    led off
+    move 175 235 325 145 100
+    move 424 75 168 180
+    led fade 0 120 600
+    ledwait
+    say enlightbreak
+    loop
+        wait 1000
+    end
+    say enlightend
+    led fade 120 0 300
+    ledwait
+    led off
+    base
+    succeed
+end
+)";
+
+static constexpr std::string_view callscript = R"(
+behavior openeoat
+    grip open
+    if
+        succeed
+    end
+end
+
+behavior closeeoat
+    grip close
+    if
+        succeed
+    end
+end
+
+behavior movebase
+    base
+    succeed
+end
+
+behavior moveparked
+    move 80 0 455 145
+    until arrived
+    if
+        succeed
+    end
+end
+)";
+
+std::string_view getbehaviorscript()
+{
+    return behaviorscript;
+}
+
+std::string_view getcallscript()
+{
+    return callscript;
+}
+
+} // namespace robot
@@ -0,0 +1,171 @@
+#include "robot/callqueue.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace robot
+{
+
+using namespace std::chrono_literals;
+
+struct CallQueue::Handler
+{
+  public:
+    Handler(attachfunc attach, size_t depth) :
+        calls{std::make_shared<calls_t>(std::move(attach), depth)}
+    {
+        if (!calls->attach || !depth)
+        {
+            throw std::runtime_error("Cannot create call queue");
+        }
+    }
+
+    std::future<bool> push(call_t call)
+    {
+        auto pending = std::make_shared<pending_t>(std::move(call));
+        auto result = pending->result.get_future();
+        {
+            std::lock_guard lock(calls->mtx);
+            if (calls->waiting.size() >= calls->depth)
+            {
+                calls->stats.rejected++;
+                pending->result.set_exception(std::make_exception_ptr(
+                    std::runtime_error("Call queue is full")));
+                return result;
+            }
+            calls->waiting.push_back(std::move(pending));
+            calls->stats.maxpending =
+                std::max(calls->stats.maxpending, calls->waiting.size());
+            if (std::exchange(calls->running, true))
+            {
+                return result;
+            }
+        }
+        startnext(calls);
+        return result;
+    }
+
+    callqueuestats_t getstats() const
+    {
+        std::lock_guard lock(calls->mtx);
+        return calls->stats;
+    }
+
+  private:
+    struct pending_t
+    {
+        explicit pending_t(call_t call) : call{std::move(call)}
+        {}
+
+        call_t call;
+        std::promise<bool> result;
+    };
+
+    // state is shared with tick, so queue can go while call is running
+    struct calls_t
+    {
+        calls_t(attachfunc attach, size_t depth) :
+            attach{std::move(attach)}, depth{depth}
+        {}
+
+        const attachfunc attach;
+        const size_t depth;
+        std::mutex mtx;
+        std::deque<std::shared_ptr<pending_t>> waiting;
+        bool running{};
+        callqueuestats_t stats{};
+    };
+
+    const std::shared_ptr<calls_t> calls;
+
+    static std::shared_ptr<pending_t> takenext(calls_t& calls)
+    {
+        std::lock_guard lock(calls.mtx);
+        if (calls.waiting.empty())
+        {
+            calls.running = false;
+            return nullptr;
+        }
+        auto pending = std::move(calls.waiting.front());
+        calls.waiting.pop_front();
+        return pending;
+    }
+
+    static void startnext(std::shared_ptr<calls_t> calls)
+    {
+        while (auto pending = takenext(*calls))
+        {
+            if (pending->call.isstopped())
+            {
+                std::lock_guard lock(calls->mtx);
+                calls->stats.cancelled++;
+                pending->result.set_value(false);
+                continue;
+            }
+            std::future<bool> done;
+            try
+            {
+                done = pending->call.start();
+            }
+            catch (...)
+            {
+                pending->result.set_exception(std::current_exception());
+                continue;
+            }
+            {
+                std::lock_guard lock(calls->mtx);
+                calls->stats.started++;
+            }
+            calls->attach([calls, pending,
+                           done = std::make_shared<std::future<bool>>(
+                               std::move(done))]() {
+                if (done->wait_for(0ms) != std::future_status::ready)
+                {
+                    return true;
+                }
+                finish(*pending, *done);
+                startnext(calls);
+                return false;
+            });
+            return;
+        }
+    }
+
+    static void finish(pending_t& pending, std::future<bool>& done)
+    {
+        try
+        {
+            auto outcome = done.get();
+            if (pending.call.finish)
+            {
+                pending.call.finish(outcome);
+            }
+            pending.result.set_value(outcome);
+        }
+        catch (...)
+        {
+            pending.result.set_exception(std::current_exception());
+        }
+    }
+};
+
+CallQueue::CallQueue(attachfunc attach, size_t depth) :
+    handler{std::make_unique<Handler>(std::move(attach), depth)}
+{}
+
+CallQueue::~CallQueue() = default;
+
+std::future<bool> CallQueue::push(call_t call)
+{
+    return handler->push(std::move(call));
+}
+
+callqueuestats_t CallQueue::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -0,0 +1,248 @@
+#include "robot/choreography.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <utility>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+using namespace std::chrono_literals;
+
+// weight of newest sample in latency estimate
+static constexpr double latencyweight = 0.25;
+// time given to arms to get ready before first cue is due
+static constexpr auto startmargin = 20ms;
+
+struct Choreography::Handler
+{
+  public:
+    Handler(dispatchfunc dispatch, size_t arms) :
+        dispatch{dispatch}, latencies(arms)
+    {
+        if (!dispatch || !arms)
+        {
+            throw std::runtime_error("Cannot create choreography");
+        }
+    }
+
+    void calibrate(const cue_t& probe, uint32_t samples)
+    {
+        std::vector<std::jthread> probers;
+        for (size_t arm{}; arm < latencies.size(); arm++)
+        {
+            probers.emplace_back([this, probe, samples, arm]() {
+                auto cue = probe;
+                cue.arm = arm;
+                for (uint32_t num{}; num < samples; num++)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    if (trydispatch(cue))
+                    {
+                        update(arm, cue.type, getoneway(start));
+                    }
+                }
+            });
+        }
+    }
+
+    choreoreport_t run(const std::vector<cue_t>& timeline,
+                       std::stop_token stoken)
+    {
+        using namespace std::chrono;
+        if (std::ranges::any_of(timeline, [this](const auto& cue) {
+                return cue.arm >= latencies.size();
+            }))
+        {
+            throw std::runtime_error("Cue given for arm out of show");
+        }
+
+        // cues of the same arm and type make lane played on its own
+        std::map<std::pair<size_t, cuetype>, std::vector<size_t>> lanes;
+        for (size_t idx{}; idx < timeline.size(); idx++)
+        {
+            lanes[{timeline[idx].arm, timeline[idx].type}].push_back(idx);
+        }
+        std::ranges::for_each(lanes, [&timeline](auto& lane) {
+            std::ranges::stable_sort(lane.second, {}, [&timeline](auto idx) {
+                return timeline[idx].at;
+            });
+        });
+
+        choreoreport_t report{};
+        report.arms.resize(latencies.size());
+        std::vector<steady_clock::time_point> effects(timeline.size());
+        const auto start = steady_clock::now() + getmaxlatency() + startmargin;
+        {
+            std::vector<std::jthread> players;
+            for (const auto& lane : lanes)
+            {
+                players.emplace_back([&]() {
+                    merge(report.arms[lane.first.first],
+                          play(start, timeline, lane.second, effects,
+                               stoken));
+                });
+            }
+        }
+
+        std::map<milliseconds, std::pair<steady_clock::time_point,
+                                         steady_clock::time_point>>
+            slots;
+        for (size_t idx{}; idx < timeline.size(); idx++)
+        {
+            if (effects[idx] == steady_clock::time_point{})
+            {
+                continue;
+            }
+            auto [it, added] = slots.try_emplace(timeline[idx].at,
+                                                 effects[idx], effects[idx]);
+            it->second.first = std::min(it->second.first, effects[idx]);
+            it->second.second = std::max(it->second.second, effects[idx]);
+        }
+        std::ranges::for_each(slots, [&report](const auto& slot) {
+            report.maxspread = std::max(
+                report.maxspread, duration_cast<microseconds>(
+                                      slot.second.second - slot.second.first));
+        });
+        for (size_t arm{}; arm < latencies.size(); arm++)
+        {
+            std::lock_guard lock(mtx);
+            report.arms[arm].latencies = latencies[arm];
+        }
+        return report;
+    }
+
+    std::chrono::microseconds getlatency(size_t arm, cuetype type) const
+    {
+        std::lock_guard lock(mtx);
+        return latencies.at(arm).at((size_t)type);
+    }
+
+  private:
+    const dispatchfunc dispatch;
+    mutable std::mutex mtx;
+    std::vector<std::array<std::chrono::microseconds, 3>> latencies;
+
+    bool trydispatch(const cue_t& cue)
+    {
+        try
+        {
+            return dispatch(cue);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    std::chrono::microseconds
+        getoneway(std::chrono::steady_clock::time_point start) const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - start) /
+               2;
+    }
+
+    void update(size_t arm, cuetype type, std::chrono::microseconds sample)
+    {
+        std::lock_guard lock(mtx);
+        auto& latency = latencies[arm][(size_t)type];
+        latency = latency == latency.zero()
+                      ? sample
+                      : std::chrono::microseconds{(int64_t)(
+                            (double)latency.count() * (1. - latencyweight) +
+                            (double)sample.count() * latencyweight)};
+    }
+
+    std::chrono::microseconds getmaxlatency() const
+    {
+        std::lock_guard lock(mtx);
+        std::chrono::microseconds maxlatency{};
+        std::ranges::for_each(latencies, [&maxlatency](const auto& types) {
+            maxlatency = std::max(maxlatency, std::ranges::max(types));
+        });
+        return maxlatency;
+    }
+
+    void merge(cueskew_t& skew, const cueskew_t& lane)
+    {
+        std::lock_guard lock(mtx);
+        skew.cues += lane.cues;
+        skew.failed += lane.failed;
+        skew.sumskew += lane.sumskew;
+        skew.maxskew = std::max(skew.maxskew, lane.maxskew);
+    }
+
+    cueskew_t play(std::chrono::steady_clock::time_point start,
+                   const std::vector<cue_t>& timeline,
+                   const std::vector<size_t>& cues,
+                   std::vector<std::chrono::steady_clock::time_point>& effects,
+                   std::stop_token stoken)
+    {
+        using namespace std::chrono;
+        cueskew_t skew{};
+        std::mutex waitmtx;
+        std::condition_variable_any waitcv;
+        for (auto idx : cues)
+        {
+            const auto& cue = timeline[idx];
+            auto due = start + cue.at;
+            {
+                std::unique_lock lock(waitmtx);
+                waitcv.wait_until(lock, stoken,
+                                  due - getlatency(cue.arm, cue.type),
+                                  []() { return false; });
+            }
+            if (stoken.stop_requested())
+            {
+                break;
+            }
+
+            auto sent = steady_clock::now();
+            skew.cues++;
+            if (!trydispatch(cue))
+            {
+                skew.failed++;
+                continue;
+            }
+            auto oneway = getoneway(sent);
+            update(cue.arm, cue.type, oneway);
+            effects[idx] = sent + oneway;
+            auto offset = duration_cast<microseconds>(effects[idx] - due);
+            offset = offset < offset.zero() ? -offset : offset;
+            skew.sumskew += offset;
+            skew.maxskew = std::max(skew.maxskew, offset);
+        }
+        return skew;
+    }
+};
+
+Choreography::Choreography(dispatchfunc dispatch, size_t arms) :
+    handler{std::make_unique<Handler>(dispatch, arms)}
+{}
+
+Choreography::~Choreography() = default;
+
+void Choreography::calibrate(const cue_t& probe, uint32_t samples)
+{
+    handler->calibrate(probe, samples);
+}
+
+choreoreport_t Choreography::run(const std::vector<cue_t>& timeline,
+                                 std::stop_token stoken)
+{
+    return handler->run(timeline, stoken);
+}
+
+std::chrono::microseconds Choreography::getlatency(size_t arm,
+                                                  cuetype type) const
+{
+    return handler->getlatency(arm, type);
+}
+
+} // namespace robot
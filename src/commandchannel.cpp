@@ -0,0 +1,199 @@
+#include "robot/commandchannel.hpp"
+
+#include "robot/requeststats.hpp"
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace robot
+{
+
+struct CommandChannel::Handler
+{
+  public:
+    Handler(std::shared_ptr<http::HttpIf> httpIf, uint32_t numoflanes)
+    {
+        if (!httpIf || !numoflanes)
+        {
+            throw std::runtime_error("Cannot create command channel");
+        }
+        std::ranges::generate_n(std::back_inserter(lanes), numoflanes,
+                                [httpIf]() {
+                                    return std::make_unique<Lane>(httpIf);
+                                });
+    }
+
+    void send(request_t&& request, orderkey_t key, donefunc done)
+    {
+        getlane(key).push(std::move(request), done);
+    }
+
+    std::future<response_t> send(request_t&& request, orderkey_t key)
+    {
+        auto promise = std::make_shared<std::promise<response_t>>();
+        auto future = promise->get_future();
+        send(std::move(request), key, [promise](const response_t& resp) {
+            promise->set_value(resp);
+        });
+        return future;
+    }
+
+    void flush()
+    {
+        std::ranges::for_each(lanes, [](auto& lane) { lane->flush(); });
+    }
+
+  private:
+    struct Lane
+    {
+      public:
+        Lane(std::shared_ptr<http::HttpIf> httpIf) :
+            httpIf{httpIf}, worker{[this](std::stop_token stoken) {
+                process(stoken);
+            }}
+        {}
+
+        ~Lane()
+        {
+            worker.request_stop();
+        }
+
+        void push(request_t&& request, donefunc done)
+        {
+            {
+                std::lock_guard lock(mtx);
+                jobs.emplace_back(std::move(request), done, getactivity());
+                pending++;
+            }
+            cv.notify_all();
+        }
+
+        void flush()
+        {
+            std::unique_lock lock(mtx);
+            cv.wait(lock, [this]() { return pending == 0; });
+        }
+
+        size_t getpending() const
+        {
+            std::lock_guard lock(mtx);
+            return pending;
+        }
+
+      private:
+        // request is accounted to activity of its sender
+        struct job_t
+        {
+            request_t request;
+            donefunc done;
+            activity tag;
+        };
+
+        std::shared_ptr<http::HttpIf> httpIf;
+        mutable std::mutex mtx;
+        std::condition_variable_any cv;
+        std::deque<job_t> jobs;
+        size_t pending{};
+        std::jthread worker;
+
+        void process(std::stop_token stoken)
+        {
+            tracing::setthreadname("channel lane");
+            std::unique_lock lock(mtx);
+            while (true)
+            {
+                cv.wait(lock, stoken, [this]() { return !jobs.empty(); });
+                if (jobs.empty())
+                {
+                    // stop requested and nothing left to be sent
+                    break;
+                }
+                auto job = std::move(jobs.front());
+                jobs.pop_front();
+                lock.unlock();
+
+                response_t resp{};
+                ActivityScope scope(job.tag);
+                try
+                {
+                    resp.ok = std::visit(
+                        [this, &resp](const auto& in) {
+                            return httpIf->get(in, resp.body);
+                        },
+                        job.request);
+                }
+                catch (const std::exception& ex)
+                {
+                    resp = {false, ex.what()};
+                }
+                if (job.done)
+                {
+                    job.done(resp);
+                }
+
+                lock.lock();
+                pending--;
+                cv.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<Lane>> lanes;
+
+    Lane& getlane(orderkey_t key)
+    {
+        if (key)
+        {
+            return *lanes.at(*key % lanes.size());
+        }
+        return **std::ranges::min_element(lanes, {}, [](const auto& lane) {
+            return lane->getpending();
+        });
+    }
+};
+
+CommandChannel::CommandChannel(std::shared_ptr<http::HttpIf> httpIf,
+                               uint32_t lanes) :
+    handler{std::make_unique<Handler>(httpIf, lanes)}
+{}
+
+CommandChannel::~CommandChannel() = default;
+
+std::future<response_t> CommandChannel::send(const http::inputtype& in,
+                                             orderkey_t key)
+{
+    return handler->send(in, key);
+}
+
+std::future<response_t> CommandChannel::send(const std::string& json,
+                                             orderkey_t key)
+{
+    return handler->send(json, key);
+}
+
+void CommandChannel::send(const http::inputtype& in, orderkey_t key,
+                          donefunc done)
+{
+    handler->send(in, key, done);
+}
+
+void CommandChannel::send(const std::string& json, orderkey_t key,
+                          donefunc done)
+{
+    handler->send(json, key, done);
+}
+
+void CommandChannel::flush()
+{
+    handler->flush();
+}
+
+} // namespace robot
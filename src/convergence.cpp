@@ -0,0 +1,81 @@
+#include "robot/convergence.hpp"
+
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace robot
+{
+
+convresult_t waitconverged(const std::function<double()>& read,
+                           double setpoint, const convparams_t& params)
+{
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+    const auto deadline = start + params.deadline;
+    const auto graceend = start + params.startgrace;
+    auto interval = duration_cast<duration<double>>(params.mininterval);
+    const auto mininterval = interval;
+    const auto maxinterval =
+        duration_cast<duration<double>>(params.maxinterval);
+
+    auto position = read();
+    auto timestamp = steady_clock::now();
+    uint32_t polls{1}, slowsamples{};
+    bool moving{};
+    auto result = [&](convergence status) -> convresult_t {
+        return {status, position,
+                duration_cast<milliseconds>(steady_clock::now() - start),
+                polls};
+    };
+
+    while (position != setpoint)
+    {
+        auto now = steady_clock::now();
+        if (now >= deadline)
+        {
+            return result(convergence::timedout);
+        }
+        {
+            tracing::Span span("poll sleep", "sleep");
+            std::this_thread::sleep_for(std::min(
+                interval, duration_cast<duration<double>>(deadline - now)));
+        }
+
+        auto prevposition = position;
+        auto prevtimestamp = timestamp;
+        position = read();
+        timestamp = steady_clock::now();
+        polls++;
+
+        auto error = std::abs(setpoint - position);
+        auto dt = duration<double>(timestamp - prevtimestamp).count();
+        auto velocity = dt > 0 ? std::abs(position - prevposition) / dt : 0.;
+        if (velocity > params.stallvelocity)
+        {
+            moving = true;
+            slowsamples = 0;
+            // poll around half of the predicted time to arrival
+            interval = std::clamp(duration<double>(error / velocity / 2),
+                                  mininterval, maxinterval);
+            continue;
+        }
+
+        if (error <= params.margin)
+        {
+            return result(position == setpoint ? convergence::reached
+                                               : convergence::withinmargin);
+        }
+        if ((moving || timestamp >= graceend) &&
+            ++slowsamples >= params.stallsamples)
+        {
+            return result(convergence::stalled);
+        }
+        interval = std::min(interval * params.backoff, maxinterval);
+    }
+    return result(convergence::reached);
+}
+
+} // namespace robot
@@ -44,6 +44,12 @@ struct Display::Handler
              {"get servos position",
               std::bind(&robot::RobotIf::readservosinfo, robotIf, true),
               std::bind(&robot::RobotIf::readservosinfo, robotIf, false)},
+             {"get request stats",
+              std::bind(&robot::RobotIf::readrequeststats, robotIf, true),
+              std::bind(&robot::RobotIf::readrequeststats, robotIf, false)},
+             {"dump request stats",
+              std::bind(&robot::RobotIf::dumprequeststats, robotIf, true),
+              std::bind(&robot::RobotIf::dumprequeststats, robotIf, false)},
              {"unlock torque",
               std::bind(&robot::RobotIf::settorqueunlocked, robotIf, true),
               std::bind(&robot::RobotIf::settorqueunlocked, robotIf, false)},
@@ -62,6 +68,18 @@ struct Display::Handler
               std::bind(&robot::RobotIf::dance, robotIf, false)},
              {"enlight", std::bind(&robot::RobotIf::enlight, robotIf, true),
               std::bind(&robot::RobotIf::enlight, robotIf, false)},
+             {"teach motion",
+              std::bind(&robot::RobotIf::teach, robotIf, true),
+              std::bind(&robot::RobotIf::teach, robotIf, false)},
+             {"replay motion",
+              std::bind(&robot::RobotIf::replay, robotIf, true, 1.),
+              std::bind(&robot::RobotIf::replay, robotIf, false, 1.)},
+             {"replay motion at half speed",
+              std::bind(&robot::RobotIf::replay, robotIf, true, 0.5),
+              std::bind(&robot::RobotIf::replay, robotIf, false, 0.5)},
+             {"replay motion at double speed",
+              std::bind(&robot::RobotIf::replay, robotIf, true, 2.),
+              std::bind(&robot::RobotIf::replay, robotIf, false, 2.)},
              {"move base", std::bind(&robot::RobotIf::movebase, robotIf, true),
               std::bind(&robot::RobotIf::movebase, robotIf, false)},
              {"move left", std::bind(&robot::RobotIf::moveleft, robotIf, true),
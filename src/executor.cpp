@@ -0,0 +1,159 @@
+#include "robot/executor.hpp"
+
+#include "robot/requeststats.hpp"
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace robot
+{
+
+struct Executor::Handler
+{
+  public:
+    Handler(std::span<const queueconfig_t> configs)
+    {
+        std::ranges::for_each(configs, [this](const auto& config) {
+            if (!config.workers || !config.depth || getqueue(config.name))
+            {
+                throw std::runtime_error("Cannot create executor queue");
+            }
+            queues.push_back(std::make_unique<Queue>(config));
+        });
+    }
+
+    bool post(workqueue name, job_t job)
+    {
+        if (auto* queue = getqueue(name))
+        {
+            return queue->push(withactivity(std::move(job)));
+        }
+        return false;
+    }
+
+    queuestats_t getstats(workqueue name) const
+    {
+        if (auto* queue = getqueue(name))
+        {
+            return queue->getstats();
+        }
+        return {};
+    }
+
+  private:
+    struct Queue
+    {
+      public:
+        Queue(const queueconfig_t& config) : config{config}
+        {
+            std::ranges::generate_n(
+                std::back_inserter(workers), config.workers, [this]() {
+                    return std::jthread(
+                        [this](std::stop_token stoken) { process(stoken); });
+                });
+        }
+
+        ~Queue()
+        {
+            std::ranges::for_each(workers,
+                                  [](auto& worker) { worker.request_stop(); });
+        }
+
+        bool push(job_t&& job)
+        {
+            {
+                std::lock_guard lock(mtx);
+                if (jobs.size() >= config.depth)
+                {
+                    stats.rejected++;
+                    return false;
+                }
+                jobs.emplace_back(std::move(job),
+                                  std::chrono::steady_clock::now());
+                stats.maxpending = std::max(stats.maxpending, jobs.size());
+            }
+            cv.notify_one();
+            return true;
+        }
+
+        queuestats_t getstats() const
+        {
+            std::lock_guard lock(mtx);
+            return stats;
+        }
+
+        const queueconfig_t config;
+
+      private:
+        struct entry_t
+        {
+            job_t job;
+            std::chrono::steady_clock::time_point posted;
+        };
+
+        mutable std::mutex mtx;
+        std::condition_variable_any cv;
+        std::deque<entry_t> jobs;
+        queuestats_t stats{};
+        std::vector<std::jthread> workers;
+
+        void process(std::stop_token stoken)
+        {
+            tracing::setthreadname("executor");
+            using namespace std::chrono;
+            std::unique_lock lock(mtx);
+            while (cv.wait(lock, stoken, [this]() { return !jobs.empty(); }))
+            {
+                auto entry = std::move(jobs.front());
+                jobs.pop_front();
+                auto latency = duration_cast<microseconds>(
+                    steady_clock::now() - entry.posted);
+                stats.sumlatency += latency;
+                stats.maxlatency = std::max(stats.maxlatency, latency);
+                stats.executed++;
+                lock.unlock();
+                try
+                {
+                    entry.job();
+                }
+                catch (const std::exception&)
+                {}
+                lock.lock();
+            }
+        }
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    Queue* getqueue(workqueue name) const
+    {
+        auto it = std::ranges::find_if(queues, [name](const auto& queue) {
+            return queue->config.name == name;
+        });
+        return it != queues.end() ? it->get() : nullptr;
+    }
+};
+
+Executor::Executor(std::span<const queueconfig_t> configs) :
+    handler{std::make_unique<Handler>(configs)}
+{}
+
+Executor::~Executor() = default;
+
+bool Executor::post(workqueue name, job_t job)
+{
+    return handler->post(name, std::move(job));
+}
+
+queuestats_t Executor::getstats(workqueue name) const
+{
+    return handler->getstats(name);
+}
+
+} // namespace robot
@@ -0,0 +1,109 @@
+#include "robot/feedback.hpp"
+
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace robot
+{
+
+using namespace std::chrono_literals;
+
+static constexpr uint32_t maxpendingperiods = 20;
+
+struct Feedback::Handler
+{
+  public:
+    Handler(readfunc read, std::chrono::milliseconds period) :
+        read{read}, period{period}
+    {}
+
+    std::shared_ptr<const snapshot_t> get(std::chrono::milliseconds maxage)
+    {
+        std::unique_lock lock(mtx);
+        auto now = std::chrono::steady_clock::now();
+        if (latest && now - latest->timestamp <= maxage)
+        {
+            return latest;
+        }
+
+        auto awaited = polls + 1;
+        if (!polling)
+        {
+            poll(lock);
+        }
+        else if (!cv.wait_for(lock, period * maxpendingperiods,
+                              [this, awaited]() { return polls >= awaited; }))
+        {
+            return nullptr;
+        }
+        return lastpollok ? latest : nullptr;
+    }
+
+    std::shared_ptr<const snapshot_t> getlatest() const
+    {
+        std::lock_guard lock(mtx);
+        return latest;
+    }
+
+  private:
+    const readfunc read;
+    const std::chrono::milliseconds period;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::shared_ptr<const snapshot_t> latest;
+    uint64_t polls{};
+    uint64_t version{};
+    bool polling{};
+    bool lastpollok{};
+
+    // sample is read by reader that found none in flight, outside of lock
+    void poll(std::unique_lock<std::mutex>& lock)
+    {
+        tracing::Span span("poll", "feedback");
+        polling = true;
+        lock.unlock();
+        roarmm2::servofeedback_t data{};
+        bool ok{};
+        try
+        {
+            ok = read(data);
+        }
+        catch (const std::exception&)
+        {
+            ok = false;
+        }
+        lock.lock();
+        if (ok)
+        {
+            latest = std::make_shared<const snapshot_t>(
+                ++version, std::chrono::steady_clock::now(), data);
+        }
+        lastpollok = ok;
+        polls++;
+        polling = false;
+        cv.notify_all();
+    }
+};
+
+Feedback::Feedback(readfunc read, std::chrono::milliseconds period) :
+    handler{std::make_unique<Handler>(read, period)}
+{}
+
+Feedback::~Feedback() = default;
+
+std::shared_ptr<const snapshot_t>
+    Feedback::get(std::chrono::milliseconds maxage)
+{
+    return handler->get(maxage);
+}
+
+std::shared_ptr<const snapshot_t> Feedback::getlatest() const
+{
+    return handler->getlatest();
+}
+
+} // namespace robot
@@ -0,0 +1,108 @@
+#include "robot/feedbackdecoder.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <utility>
+
+namespace robot::roarmm2
+{
+
+using field_t = std::pair<std::string_view, double servofeedback_t::*>;
+static constexpr std::array<field_t, 11> fields{
+    {{"x", &servofeedback_t::x},
+     {"y", &servofeedback_t::y},
+     {"z", &servofeedback_t::z},
+     {"b", &servofeedback_t::b},
+     {"s", &servofeedback_t::s},
+     {"e", &servofeedback_t::e},
+     {"t", &servofeedback_t::t},
+     {"torB", &servofeedback_t::torb},
+     {"torS", &servofeedback_t::tors},
+     {"torE", &servofeedback_t::tore},
+     {"torH", &servofeedback_t::torh}}};
+// position and joint angles are needed, loads are optional
+static constexpr uint32_t requiredmask = 0x7f;
+
+static const char* skipspaces(const char* it, const char* end)
+{
+    while (it != end && (*it == ' ' || *it == '\t' || *it == '\r' ||
+                         *it == '\n'))
+        it++;
+    return it;
+}
+
+decodeerror decode(std::string_view body, servofeedback_t& feedback)
+{
+    const auto* it = body.data();
+    const auto* end = body.data() + body.size();
+    it = skipspaces(it, end);
+    if (it == end)
+    {
+        return decodeerror::empty;
+    }
+    if (*it++ != '{')
+    {
+        return decodeerror::malformed;
+    }
+
+    uint32_t foundmask{};
+    while (true)
+    {
+        it = skipspaces(it, end);
+        if (it == end)
+        {
+            return decodeerror::malformed;
+        }
+        if (*it == '}')
+        {
+            break;
+        }
+        if (*it++ != '"')
+        {
+            return decodeerror::malformed;
+        }
+        const auto* keybegin = it;
+        while (it != end && *it != '"')
+            it++;
+        if (it == end)
+        {
+            return decodeerror::malformed;
+        }
+        std::string_view key{keybegin, (size_t)(it - keybegin)};
+        it = skipspaces(it + 1, end);
+        if (it == end || *it++ != ':')
+        {
+            return decodeerror::malformed;
+        }
+        it = skipspaces(it, end);
+
+        double value{};
+        auto [ptr, ec] = std::from_chars(it, end, value);
+        if (ec != std::errc{})
+        {
+            return decodeerror::badvalue;
+        }
+        it = ptr;
+        for (uint32_t idx{}; idx < fields.size(); idx++)
+        {
+            if (fields[idx].first == key)
+            {
+                feedback.*(fields[idx].second) = value;
+                foundmask |= 1u << idx;
+                break;
+            }
+        }
+
+        it = skipspaces(it, end);
+        if (it != end && *it == ',')
+        {
+            it++;
+        }
+    }
+    return (foundmask & requiredmask) == requiredmask
+               ? decodeerror::none
+               : decodeerror::missingfield;
+}
+
+} // namespace robot::roarmm2
@@ -0,0 +1,155 @@
+#include "robot/filteredlog.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+struct FilteredLog::Handler
+{
+  public:
+    Handler(std::shared_ptr<logging::LogIf> sink, logging::type level,
+            size_t queuedepth) :
+        sink{sink}, level{level}, queuedepth{queuedepth}
+    {
+        if (!sink)
+        {
+            throw std::runtime_error("No log to write messages to");
+        }
+        if (queuedepth)
+        {
+            writer = std::jthread(
+                [this](std::stop_token stoken) { process(stoken); });
+        }
+    }
+
+    ~Handler()
+    {
+        if (writer.joinable())
+        {
+            // pending messages are written before leaving
+            writer.request_stop();
+            writer.join();
+        }
+    }
+
+    void log(logging::type type, const std::string& module,
+             const std::string& msg)
+    {
+        if (!isenabled(type))
+        {
+            filtered.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!queuedepth)
+        {
+            std::lock_guard lock(mtx);
+            sink->log(type, module, msg);
+            written++;
+            return;
+        }
+        {
+            std::lock_guard lock(mtx);
+            if (messages.size() >= queuedepth)
+            {
+                dropped++;
+                return;
+            }
+            messages.emplace_back(type, module, msg);
+        }
+        cv.notify_one();
+    }
+
+    bool isenabled(logging::type type) const
+    {
+        return (int32_t)type <= (int32_t)level;
+    }
+
+    logstats_t getstats() const
+    {
+        std::lock_guard lock(mtx);
+        return {written, filtered.load(std::memory_order_relaxed), dropped};
+    }
+
+  private:
+    struct message_t
+    {
+        logging::type type;
+        std::string module;
+        std::string msg;
+    };
+
+    const std::shared_ptr<logging::LogIf> sink;
+    const logging::type level;
+    const size_t queuedepth;
+    mutable std::mutex mtx;
+    std::condition_variable_any cv;
+    std::deque<message_t> messages;
+    uint64_t written{};
+    uint64_t dropped{};
+    uint64_t reported{};
+    std::atomic<uint64_t> filtered{};
+    std::jthread writer;
+
+    void process(std::stop_token stoken)
+    {
+        std::unique_lock lock(mtx);
+        while (true)
+        {
+            cv.wait(lock, stoken, [this]() { return !messages.empty(); });
+            if (messages.empty())
+            {
+                break;
+            }
+            auto batch = std::move(messages);
+            messages.clear();
+            auto lost = dropped - reported;
+            reported = dropped;
+            lock.unlock();
+
+            for (const auto& message : batch)
+            {
+                sink->log(message.type, message.module, message.msg);
+            }
+            if (lost && isenabled(logging::type::warning))
+            {
+                sink->log(logging::type::warning, batch.back().module,
+                          "Log queue full, dropped messages: " +
+                              std::to_string(lost));
+            }
+
+            lock.lock();
+            written += batch.size();
+        }
+    }
+};
+
+FilteredLog::FilteredLog(std::shared_ptr<logging::LogIf> sink,
+                         logging::type level, size_t queuedepth) :
+    handler{std::make_unique<Handler>(sink, level, queuedepth)}
+{}
+
+FilteredLog::~FilteredLog() = default;
+
+void FilteredLog::log(logging::type type, const std::string& module,
+                      const std::string& msg)
+{
+    handler->log(type, module, msg);
+}
+
+bool FilteredLog::isenabled(logging::type type) const
+{
+    return handler->isenabled(type);
+}
+
+logstats_t FilteredLog::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -0,0 +1,410 @@
+#include "robot/fleet.hpp"
+
+#include "robot/commands.hpp"
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+struct Fleet::Handler
+{
+  public:
+    Handler(const std::vector<arm_t>& arms, uint32_t ioworkers,
+            robotfactory factory) :
+        factory{factory}
+    {
+        if (arms.empty() || !ioworkers)
+        {
+            throw std::runtime_error("Cannot create fleet");
+        }
+        std::ranges::for_each(arms, [this](const auto& arm) {
+            if (!arm.httpIf)
+            {
+                throw std::runtime_error("No interface to connect to arm");
+            }
+            units.push_back(std::make_unique<Unit>(arm));
+        });
+        choreography = std::make_unique<Choreography>(
+            [this](const cue_t& cue) { return dispatch(cue); }, units.size());
+        std::ranges::generate_n(
+            std::back_inserter(workers), ioworkers, [this]() {
+                return std::jthread(
+                    [this](std::stop_token stoken) { process(stoken); });
+            });
+    }
+
+    ~Handler()
+    {
+        // robots may still talk to their arms while going down
+        std::ranges::for_each(units, [](auto& unit) { unit->robot.reset(); });
+        std::ranges::for_each(workers,
+                              [](auto& worker) { worker.request_stop(); });
+    }
+
+    size_t size() const
+    {
+        return units.size();
+    }
+
+    std::future<response_t> send(size_t arm, const std::string& json)
+    {
+        return call(arm, torequest(json));
+    }
+
+    std::vector<std::future<response_t>> broadcast(const std::string& json)
+    {
+        std::vector<std::future<response_t>> responses;
+        for (size_t arm{}; arm < units.size(); arm++)
+        {
+            responses.push_back(send(arm, json));
+        }
+        return responses;
+    }
+
+    size_t sampletelemetry()
+    {
+        static const std::string json{
+            roarmm2::command::getjson<roarmm2::command::Feedback>()};
+        auto remaining = units.size();
+        size_t updated{};
+        for (size_t arm{}; arm < units.size(); arm++)
+        {
+            auto& telemetry = units[arm]->telemetry;
+            push(arm, torequest(json), [&](const response_t& resp) {
+                roarmm2::servofeedback_t feedback{};
+                auto ok = resp.ok && roarmm2::decode(resp.body, feedback) ==
+                                         roarmm2::decodeerror::none;
+                std::lock_guard lock(mtx);
+                if (ok)
+                {
+                    telemetry.feedback = feedback;
+                    telemetry.updated = std::chrono::steady_clock::now();
+                    updated++;
+                }
+                remaining--;
+                cv.notify_all();
+            });
+        }
+        std::unique_lock lock(mtx);
+        cv.wait(lock, [&remaining]() { return remaining == 0; });
+        return updated;
+    }
+
+    std::vector<armtelemetry_t> gettelemetry() const
+    {
+        std::lock_guard lock(mtx);
+        std::vector<armtelemetry_t> telemetry;
+        std::ranges::transform(
+            units, std::back_inserter(telemetry),
+            [](const auto& unit) { return unit->telemetry; });
+        return telemetry;
+    }
+
+    std::shared_ptr<RobotIf> getrobot(size_t arm)
+    {
+        if (!factory)
+        {
+            throw std::runtime_error("No robot factory given for fleet");
+        }
+        auto& unit = *units.at(arm);
+        // robot may talk to its arm while created, so only other callers of
+        // the same arm wait for it while workers keep serving the fleet
+        std::call_once(unit.robotonce, [this, &unit, arm]() {
+            unit.robot = factory(std::make_shared<ArmLink>(*this, arm));
+        });
+        return unit.robot;
+    }
+
+    void calibrate(uint32_t samples)
+    {
+        static const std::string json{
+            roarmm2::command::getjson<roarmm2::command::Feedback>()};
+        std::lock_guard lock(showmtx);
+        for (auto type : {cuetype::motion, cuetype::led})
+        {
+            choreography->calibrate({{}, 0, type, json}, samples);
+        }
+    }
+
+    choreoreport_t play(const std::vector<cue_t>& timeline, speakfunc speak,
+                        std::stop_token stoken)
+    {
+        std::lock_guard lock(showmtx);
+        speaker = speak;
+        return choreography->run(timeline, stoken);
+    }
+
+  private:
+    using requestfunc = std::function<bool(http::HttpIf&, std::string&)>;
+    using donefunc = std::function<void(const response_t&)>;
+
+    struct job_t
+    {
+        requestfunc request;
+        donefunc done;
+    };
+
+    // Interface given to robots, their requests are queued on arm's strand
+    // and executed by fleet workers like any other command of the arm
+    class ArmLink : public http::HttpIf
+    {
+      public:
+        ArmLink(Handler& handler, size_t arm) : handler{handler}, arm{arm}
+        {}
+
+        bool get(const http::inputtype& in, http::outputtype& out) override
+        {
+            return forward(in, out);
+        }
+
+        bool get(const http::inputtype& in, std::string& out) override
+        {
+            return forward(in, out);
+        }
+
+        bool get(const std::string& in, std::string& out) override
+        {
+            return forward(in, out);
+        }
+
+        std::string info() override
+        {
+            return handler.units.at(arm)->httpIf->info();
+        }
+
+      private:
+        Handler& handler;
+        const size_t arm;
+
+        // caller waits for the response, so its arguments outlive request
+        template <typename In, typename Out>
+        bool forward(const In& in, Out& out)
+        {
+            return handler
+                .perform(arm,
+                         [&in, &out](http::HttpIf& httpIf, std::string&) {
+                             return httpIf.get(in, out);
+                         })
+                .ok;
+        }
+    };
+
+    struct Unit
+    {
+        Unit(const arm_t& arm) : httpIf{arm.httpIf}
+        {
+            telemetry.name = arm.name;
+        }
+
+        std::shared_ptr<http::HttpIf> httpIf;
+        std::deque<job_t> jobs;
+        bool busy{};
+        armtelemetry_t telemetry{};
+        std::once_flag robotonce;
+        std::shared_ptr<RobotIf> robot;
+    };
+
+    const robotfactory factory;
+    mutable std::mutex mtx;
+    std::condition_variable_any cv;
+    std::vector<std::unique_ptr<Unit>> units;
+    // arms having jobs and no request in flight
+    std::deque<size_t> ready;
+    std::vector<std::jthread> workers;
+    // shows are played one at a time, cues of each arm keep its order
+    std::mutex showmtx;
+    speakfunc speaker;
+    std::unique_ptr<Choreography> choreography;
+
+    static requestfunc torequest(const std::string& json)
+    {
+        return [json](http::HttpIf& httpIf, std::string& out) {
+            return httpIf.get(json, out);
+        };
+    }
+
+    std::future<response_t> call(size_t arm, requestfunc request)
+    {
+        auto promise = std::make_shared<std::promise<response_t>>();
+        auto future = promise->get_future();
+        push(arm, request, [promise](const response_t& resp) {
+            promise->set_value(resp);
+        });
+        return future;
+    }
+
+    void push(size_t arm, requestfunc request, donefunc done)
+    {
+        if (arm >= units.size())
+        {
+            throw std::runtime_error("Arm not in fleet");
+        }
+        {
+            std::lock_guard lock(mtx);
+            auto& unit = *units[arm];
+            unit.jobs.emplace_back(request, done);
+            if (!unit.busy && unit.jobs.size() == 1)
+            {
+                ready.push_back(arm);
+            }
+        }
+        cv.notify_all();
+    }
+
+    // caller makes request itself when arm is idle instead of holding a
+    // worker, otherwise it is queued behind commands of the arm
+    response_t perform(size_t arm, requestfunc request)
+    {
+        if (acquire(arm))
+        {
+            auto resp = execute(arm, {request, nullptr});
+            release(arm);
+            return resp;
+        }
+        return call(arm, request).get();
+    }
+
+    bool dispatch(const cue_t& cue)
+    {
+        if (cue.type == cuetype::speech)
+        {
+            return speaker && speaker(cue.arm, cue.payload);
+        }
+        return perform(cue.arm, torequest(cue.payload)).ok;
+    }
+
+    // arm with nothing queued and no request in flight is taken by caller
+    bool acquire(size_t arm)
+    {
+        std::lock_guard lock(mtx);
+        auto& unit = *units.at(arm);
+        if (unit.busy || !unit.jobs.empty())
+        {
+            return false;
+        }
+        unit.busy = true;
+        return true;
+    }
+
+    void release(size_t arm)
+    {
+        std::lock_guard lock(mtx);
+        auto& unit = *units[arm];
+        unit.busy = false;
+        if (!unit.jobs.empty())
+        {
+            ready.push_back(arm);
+            cv.notify_all();
+        }
+    }
+
+    // arm stays busy until completion is reported to keep its order
+    response_t execute(size_t arm, const job_t& job)
+    {
+        using namespace std::chrono;
+        auto& unit = *units[arm];
+        response_t resp{};
+        auto start = steady_clock::now();
+        try
+        {
+            resp.ok = job.request(*unit.httpIf, resp.body);
+        }
+        catch (const std::exception& ex)
+        {
+            resp = {false, ex.what()};
+        }
+        auto latency = duration_cast<microseconds>(steady_clock::now() - start);
+        {
+            std::lock_guard lock(mtx);
+            auto& telemetry = unit.telemetry;
+            telemetry.requests++;
+            telemetry.failures += resp.ok ? 0 : 1;
+            telemetry.sumlatency += latency;
+            telemetry.maxlatency = std::max(telemetry.maxlatency, latency);
+        }
+        if (job.done)
+        {
+            job.done(resp);
+        }
+        return resp;
+    }
+
+    void process(std::stop_token stoken)
+    {
+        tracing::setthreadname("fleet");
+        std::unique_lock lock(mtx);
+        while (cv.wait(lock, stoken, [this]() { return !ready.empty(); }))
+        {
+            auto arm = ready.front();
+            ready.pop_front();
+            auto& unit = *units[arm];
+            auto job = std::move(unit.jobs.front());
+            unit.jobs.pop_front();
+            unit.busy = true;
+            lock.unlock();
+            execute(arm, job);
+            release(arm);
+            lock.lock();
+        }
+    }
+};
+
+Fleet::Fleet(const std::vector<arm_t>& arms, uint32_t ioworkers,
+             robotfactory factory) :
+    handler{std::make_unique<Handler>(arms, ioworkers, factory)}
+{}
+
+Fleet::~Fleet() = default;
+
+size_t Fleet::size() const
+{
+    return handler->size();
+}
+
+std::future<response_t> Fleet::send(size_t arm, const std::string& json)
+{
+    return handler->send(arm, json);
+}
+
+std::vector<std::future<response_t>>
+    Fleet::broadcast(const std::string& json)
+{
+    return handler->broadcast(json);
+}
+
+size_t Fleet::sampletelemetry()
+{
+    return handler->sampletelemetry();
+}
+
+std::vector<armtelemetry_t> Fleet::gettelemetry() const
+{
+    return handler->gettelemetry();
+}
+
+std::shared_ptr<RobotIf> Fleet::getrobot(size_t arm)
+{
+    return handler->getrobot(arm);
+}
+
+void Fleet::calibrate(uint32_t samples)
+{
+    handler->calibrate(samples);
+}
+
+choreoreport_t Fleet::play(const std::vector<cue_t>& timeline,
+                           speakfunc speak, std::stop_token stoken)
+{
+    return handler->play(timeline, speak, stoken);
+}
+
+} // namespace robot
@@ -0,0 +1,134 @@
+#include "robot/kinematics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace robot::roarmm2
+{
+
+static const double upperarm =
+    std::hypot(model.upperarm, model.upperarmoffset);
+static const double upperarmtilt =
+    std::atan2(model.upperarmoffset, model.upperarm);
+
+static inline bool iswithin(double value, const jointlimits_t& limits)
+{
+    return (value >= limits.min) & (value <= limits.max);
+}
+
+static inline void forwardkernel(double base, double shoulder, double elbow,
+                                 double hand, double& x, double& y, double& z,
+                                 double& t)
+{
+    auto upperarmangle = shoulder + upperarmtilt;
+    auto forearmangle = shoulder + elbow;
+    auto r = upperarm * std::sin(upperarmangle) +
+             model.forearm * std::sin(forearmangle);
+    z = upperarm * std::cos(upperarmangle) +
+        model.forearm * std::cos(forearmangle);
+    x = r * std::cos(base);
+    y = r * std::sin(base);
+    t = hand;
+}
+
+// Elbow up solution, computed without branches for the sake of batches
+static inline uint8_t inversekernel(double x, double y, double z, double t,
+                                    double& base, double& shoulder,
+                                    double& elbow, double& hand)
+{
+    auto r = std::sqrt(x * x + y * y);
+    auto distance = std::sqrt(r * r + z * z);
+    auto cosbeta =
+        (upperarm * upperarm + distance * distance -
+         model.forearm * model.forearm) /
+        (2. * upperarm * std::max(distance, 1e-9));
+    auto reachable = (cosbeta >= -1.) & (cosbeta <= 1.);
+    auto beta = std::acos(std::clamp(cosbeta, -1., 1.));
+    auto alpha = std::atan2(z, r);
+
+    auto upperarmangle = std::numbers::pi / 2 - (alpha + beta);
+    auto forearmr = r - upperarm * std::sin(upperarmangle);
+    auto forearmz = z - upperarm * std::cos(upperarmangle);
+    auto forearmangle = std::atan2(forearmr, forearmz);
+
+    base = std::atan2(y, x);
+    shoulder = upperarmangle - upperarmtilt;
+    elbow = forearmangle - shoulder;
+    hand = t;
+    return (uint8_t)(reachable & iswithin(base, model.limits[0]) &
+                     iswithin(shoulder, model.limits[1]) &
+                     iswithin(elbow, model.limits[2]) &
+                     iswithin(hand, model.limits[3]));
+}
+
+waypoint_t forward(const joints_t& joints)
+{
+    waypoint_t pose{};
+    forwardkernel(joints[0], joints[1], joints[2], joints[3], pose[0],
+                  pose[1], pose[2], pose[3]);
+    return pose;
+}
+
+bool inverse(const waypoint_t& pose, joints_t& joints)
+{
+    return inversekernel(pose[0], pose[1], pose[2], pose[3], joints[0],
+                         joints[1], joints[2], joints[3]);
+}
+
+bool iswithinlimits(const joints_t& joints)
+{
+    return std::ranges::equal(joints, model.limits, iswithin);
+}
+
+void forward(const jointbatch_t& joints, posebatch_t& poses)
+{
+    const auto size = joints.base.size();
+    poses.x.resize(size);
+    poses.y.resize(size);
+    poses.z.resize(size);
+    poses.t.resize(size);
+
+    const auto* base = joints.base.data();
+    const auto* shoulder = joints.shoulder.data();
+    const auto* elbow = joints.elbow.data();
+    const auto* hand = joints.hand.data();
+    auto* x = poses.x.data();
+    auto* y = poses.y.data();
+    auto* z = poses.z.data();
+    auto* t = poses.t.data();
+    for (size_t i = 0; i < size; i++)
+    {
+        forwardkernel(base[i], shoulder[i], elbow[i], hand[i], x[i], y[i],
+                      z[i], t[i]);
+    }
+}
+
+size_t inverse(const posebatch_t& poses, jointbatch_t& joints,
+               std::vector<uint8_t>& valid)
+{
+    const auto size = poses.x.size();
+    joints.base.resize(size);
+    joints.shoulder.resize(size);
+    joints.elbow.resize(size);
+    joints.hand.resize(size);
+    valid.resize(size);
+
+    const auto* x = poses.x.data();
+    const auto* y = poses.y.data();
+    const auto* z = poses.z.data();
+    const auto* t = poses.t.data();
+    auto* base = joints.base.data();
+    auto* shoulder = joints.shoulder.data();
+    auto* elbow = joints.elbow.data();
+    auto* hand = joints.hand.data();
+    auto* isvalid = valid.data();
+    for (size_t i = 0; i < size; i++)
+    {
+        isvalid[i] = inversekernel(x[i], y[i], z[i], t[i], base[i],
+                                   shoulder[i], elbow[i], hand[i]);
+    }
+    return (size_t)std::accumulate(valid.begin(), valid.end(), size_t{});
+}
+
+} // namespace robot::roarmm2
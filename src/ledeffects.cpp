@@ -0,0 +1,245 @@
+#include "robot/ledeffects.hpp"
+
+#include "robot/requeststats.hpp"
+
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace robot
+{
+
+namespace ledeffect
+{
+
+static uint8_t getlevel(uint8_t from, uint8_t to, double progress)
+{
+    return (uint8_t)std::lround(from + (to - from) * progress);
+}
+
+static double getprogress(std::chrono::milliseconds elapsed,
+                          std::chrono::milliseconds duration)
+{
+    return std::chrono::duration<double>(elapsed) / duration;
+}
+
+effect_t fade(uint8_t from, uint8_t to, std::chrono::milliseconds duration)
+{
+    return [from, to, duration, done = false](
+               std::chrono::milliseconds elapsed) mutable
+           -> std::optional<uint8_t> {
+        if (done)
+        {
+            return std::nullopt;
+        }
+        if (elapsed >= duration)
+        {
+            done = true;
+            return to;
+        }
+        return getlevel(from, to, getprogress(elapsed, duration));
+    };
+}
+
+effect_t pulse(uint8_t min, uint8_t max, std::chrono::milliseconds period)
+{
+    return [min, max, period](
+               std::chrono::milliseconds elapsed) -> std::optional<uint8_t> {
+        auto phase = getprogress(elapsed % period, period);
+        return getlevel(min, max, 1. - std::abs(2. * phase - 1.));
+    };
+}
+
+effect_t breathe(uint8_t min, uint8_t max, std::chrono::milliseconds period)
+{
+    return [min, max, period](
+               std::chrono::milliseconds elapsed) -> std::optional<uint8_t> {
+        auto phase = getprogress(elapsed % period, period);
+        return getlevel(min, max, (1. - std::cos(2. * M_PI * phase)) / 2.);
+    };
+}
+
+} // namespace ledeffect
+
+struct LedEngine::Handler
+{
+  public:
+    Handler(writefunc write, std::chrono::milliseconds period,
+            attachfunc attach) :
+        attach{attach},
+        frames{std::make_shared<frames_t>(write, period)}
+    {
+        if (!write || period <= std::chrono::milliseconds::zero() || !attach)
+        {
+            throw std::runtime_error("Cannot create led engine");
+        }
+    }
+
+    ~Handler()
+    {
+        // tick still attached finds no effect and detaches
+        std::lock_guard lock(frames->mtx);
+        frames->effect = nullptr;
+        frames->unsent.reset();
+    }
+
+    void run(effect_t neweffect)
+    {
+        bool detached{};
+        {
+            std::lock_guard lock(frames->mtx);
+            frames->effect = neweffect;
+            frames->owner = getactivity();
+            frames->start = std::chrono::steady_clock::now();
+            frames->next = frames->start;
+            frames->lastlevel.reset();
+            frames->unsent.reset();
+            detached = neweffect && !std::exchange(frames->attached, true);
+        }
+        frames->cv.notify_all();
+        if (detached)
+        {
+            attach([frames = frames]() { return frames->tick(); });
+        }
+    }
+
+    void stop()
+    {
+        run(nullptr);
+    }
+
+    void wait()
+    {
+        std::unique_lock lock(frames->mtx);
+        frames->cv.wait(lock, [this]() { return !frames->isrunning(); });
+    }
+
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock lock(frames->mtx);
+        return frames->cv.wait_for(
+            lock, timeout, [this]() { return !frames->isrunning(); });
+    }
+
+    ledstats_t getstats() const
+    {
+        std::lock_guard lock(frames->mtx);
+        return frames->stats;
+    }
+
+  private:
+    // state is shared with tick, so engine can go while tick is attached
+    struct frames_t
+    {
+        frames_t(writefunc write, std::chrono::milliseconds period) :
+            write{write}, period{period}
+        {}
+
+        const writefunc write;
+        const std::chrono::milliseconds period;
+        std::mutex mtx;
+        std::condition_variable cv;
+        effect_t effect;
+        // activity that ran effect, its writes are accounted to
+        activity owner{activity::other};
+        std::chrono::steady_clock::time_point start, next;
+        std::optional<uint8_t> lastlevel, unsent;
+        bool attached{};
+        ledstats_t stats{};
+
+        // writes only start sending, so they are made under lock; level
+        // not taken is retried on next tick unless newer one replaces it
+        bool tick()
+        {
+            using namespace std::chrono;
+            std::unique_lock lock(mtx);
+            auto now = steady_clock::now();
+            if (effect && now >= next)
+            {
+                if (auto level =
+                        effect(duration_cast<milliseconds>(next - start)))
+                {
+                    stats.frames++;
+                    if (level != lastlevel)
+                    {
+                        stats.dropped += unsent ? 1 : 0;
+                        unsent = level;
+                    }
+                    next += period;
+                    if (now > next)
+                    {
+                        auto missed = (now - next) / period + 1;
+                        stats.dropped += (uint64_t)missed;
+                        next += missed * period;
+                    }
+                }
+                else
+                {
+                    effect = nullptr;
+                }
+            }
+            if (unsent)
+            {
+                ActivityScope scope(owner);
+                if (write(*unsent))
+                {
+                    lastlevel = std::exchange(unsent, std::nullopt);
+                    stats.writes++;
+                }
+            }
+            if (!isrunning())
+            {
+                attached = false;
+                lock.unlock();
+                cv.notify_all();
+                return false;
+            }
+            return true;
+        }
+
+        bool isrunning() const
+        {
+            return effect || unsent;
+        }
+    };
+
+    const attachfunc attach;
+    const std::shared_ptr<frames_t> frames;
+};
+
+LedEngine::LedEngine(writefunc write, std::chrono::milliseconds period,
+                     attachfunc attach) :
+    handler{std::make_unique<Handler>(write, period, attach)}
+{}
+
+LedEngine::~LedEngine() = default;
+
+void LedEngine::run(effect_t effect)
+{
+    handler->run(effect);
+}
+
+void LedEngine::stop()
+{
+    handler->stop();
+}
+
+void LedEngine::wait()
+{
+    handler->wait();
+}
+
+bool LedEngine::wait(std::chrono::milliseconds timeout)
+{
+    return handler->wait(timeout);
+}
+
+ledstats_t LedEngine::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -3,13 +3,34 @@
 #include "log/interfaces/console.hpp"
 #include "log/interfaces/group.hpp"
 #include "log/interfaces/storage.hpp"
+#include "robot/audio.hpp"
+#include "robot/filteredlog.hpp"
 #include "robot/interfaces/roarmm2.hpp"
+#include "robot/pooledhttp.hpp"
+#include "robot/serial.hpp"
+#include "robot/speechcache.hpp"
+#include "robot/tracing.hpp"
 #include "tts/interfaces/googlecloud.hpp"
 
 #include <boost/program_options.hpp>
 
+#include <chrono>
 #include <csignal>
 #include <iostream>
+#include <memory>
+
+// messages waiting for log sinks before new ones are dropped
+static constexpr size_t logqueuedepth = 1024;
+// default speed of arm's usb serial port and waits for its responses
+static constexpr uint32_t defaultserialspeed = 115200;
+static constexpr std::chrono::milliseconds serialtimeout{500};
+static constexpr std::chrono::milliseconds serialreplygap{20};
+// synthesized phrases kept between runs and workers filling catalog
+static constexpr const char* speechcachefile = "robot_speech.bin";
+static constexpr uint32_t speechcacheworkers = 4;
+// wifi requests made at once by command lanes, workers and poller, each
+// has client of its own; serial line is locked for whole request instead
+static constexpr uint32_t httpclients = 8;
 
 void signalHandler(int signal)
 {
@@ -22,9 +43,13 @@ void signalHandler(int signal)
 int main(int argc, char* argv[])
 {
     auto loglvl = (uint32_t)logging::type::info;
+    std::string tracefile, serialdevice;
+    uint32_t serialspeed{defaultserialspeed};
     std::signal(SIGINT, signalHandler);
+    // audio player ended while being fed must not end the robot
+    std::signal(SIGPIPE, SIG_IGN);
     if (argc > 1)
-        [argc, argv, &loglvl]() {
+        [argc, argv, &loglvl, &tracefile, &serialdevice, &serialspeed]() {
             boost::program_options::options_description desc("Allowed options");
             desc.add_options()("help,h", "produce help message")(
                 "address,a", boost::program_options::value<std::string>(),
@@ -32,7 +57,9 @@ int main(int argc, char* argv[])
                 "speed,s", boost::program_options::value<std::string>(),
                 "speed of serial communication")(
                 "loglvl,l", boost::program_options::value<uint32_t>(),
-                "level of logging [0-4], default error [1]");
+                "level of logging [0-4], default error [1]")(
+                "trace,t", boost::program_options::value<std::string>(),
+                "file to store chrome trace of robot activity");
 
             boost::program_options::variables_map vm;
             boost::program_options::store(
@@ -48,8 +75,21 @@ int main(int argc, char* argv[])
 
             loglvl =
                 vm.contains("loglvl") ? vm.at("loglvl").as<uint32_t>() : loglvl;
+            tracefile = vm.contains("trace") ? vm.at("trace").as<std::string>()
+                                             : tracefile;
+            serialdevice = vm.contains("address")
+                               ? vm.at("address").as<std::string>()
+                               : serialdevice;
+            serialspeed = vm.contains("speed")
+                              ? (uint32_t)std::stoul(
+                                    vm.at("speed").as<std::string>())
+                              : serialspeed;
         }();
 
+    if (!tracefile.empty() && !robot::tracing::start(tracefile))
+    {
+        std::cerr << "Cannot store trace in " << tracefile << "\n";
+    }
     try
     {
         auto lvl = static_cast<logging::type>(loglvl);
@@ -57,12 +97,35 @@ int main(int argc, char* argv[])
             logging::LogFactory::create<logging::console::Log>(lvl);
         auto logstorage =
             logging::LogFactory::create<logging::storage::Log>(lvl);
-        auto logIf = logging::LogFactory::create<logging::group::Log>(
+        auto loggroup = logging::LogFactory::create<logging::group::Log>(
             {logconsole, logstorage});
-        auto httpIf = http::HttpFactory::create<http::cpr::Http>(logIf);
-        auto ttsIf =
+        // console and storage are written in background, not by behaviors
+        auto logIf =
+            std::make_shared<robot::FilteredLog>(loggroup, lvl, logqueuedepth);
+        // arm attached to serial device is driven directly, without wifi
+        std::shared_ptr<http::HttpIf> httpIf;
+        if (serialdevice.empty())
+        {
+            httpIf = std::make_shared<robot::PooledHttp>(
+                [logIf]() {
+                    return http::HttpFactory::create<http::cpr::Http>(logIf);
+                },
+                httpclients);
+        }
+        else
+        {
+            httpIf = std::make_shared<robot::SerialHttp>(
+                serialdevice, robot::serialconfig_t{serialspeed, serialtimeout,
+                                                    serialreplygap});
+        }
+        // phrases are played from cache, backend keeps voice settings
+        auto ttsIf = std::make_shared<robot::CachedTextToVoice>(
             tts::TextToVoiceFactory::create<tts::googlecloud::TextToVoice>(
-                {tts::language::polish, tts::gender::female, 1});
+                {tts::language::polish, tts::gender::female, 1}),
+            std::make_shared<robot::SpeechCache>(speechcachefile,
+                                                 robot::audio::synthesize,
+                                                 robot::audio::play),
+            speechcacheworkers);
         auto robotIf = robot::RobotFactory::create<robot::roarmm2::Robot>(
             httpIf, ttsIf, logIf);
         auto menu = display::Display(logIf, robotIf);
@@ -76,5 +139,11 @@ int main(int argc, char* argv[])
     {
         std::cerr << "Unknown exception occured, aborting!\n";
     }
+    if (!tracefile.empty())
+    {
+        auto stats = robot::tracing::stop();
+        std::cout << "Traced events: " << stats.events
+                  << ", dropped: " << stats.dropped << "\n";
+    }
     return 0;
 }
@@ -0,0 +1,96 @@
+#include "robot/motiondetect.hpp"
+
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <numeric>
+#include <thread>
+
+namespace robot
+{
+
+static std::chrono::nanoseconds getcputime()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) +
+           std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+static double getdistance(const position_t& a, const position_t& b)
+{
+    return std::sqrt(std::inner_product(
+        a.begin(), a.end(), b.begin(), 0., std::plus<>(),
+        [](double x, double y) { return (x - y) * (x - y); }));
+}
+
+motionresult_t detectmotion(const std::function<position_t()>& read,
+                            const std::function<bool()>& stop,
+                            const motionparams_t& params)
+{
+    using namespace std::chrono;
+    const auto window = (size_t)std::max<int64_t>(
+        1, params.latencytarget / params.period);
+    const auto cpustart = getcputime();
+    const auto baseline = read();
+    uint32_t samples{1};
+    std::deque<position_t> history;
+    steady_clock::time_point movedsince{};
+    bool moving{};
+
+    auto result = [&](bool detected) -> motionresult_t {
+        auto latency =
+            detected && moving
+                ? duration_cast<milliseconds>(steady_clock::now() - movedsince)
+                : milliseconds{};
+        return {detected, latency, samples,
+                duration_cast<microseconds>(getcputime() - cpustart)};
+    };
+
+    auto tick = steady_clock::now();
+    while (!stop())
+    {
+        tick += params.period;
+        std::this_thread::sleep_until(tick);
+
+        auto position = read();
+        samples++;
+        if (!moving && getdistance(position, baseline) > params.deadband)
+        {
+            movedsince = steady_clock::now();
+            moving = true;
+        }
+
+        history.push_back(position);
+        if (history.size() > window)
+        {
+            history.pop_front();
+        }
+        if (history.size() < window)
+        {
+            continue;
+        }
+
+        position_t average{};
+        std::ranges::for_each(history, [&average](const auto& sample) {
+            std::ranges::transform(average, sample, average.begin(),
+                                   std::plus<>());
+        });
+        std::ranges::transform(average, average.begin(), [window](double sum) {
+            return sum / (double)window;
+        });
+        if (getdistance(average, baseline) > params.deadband)
+        {
+            return result(true);
+        }
+        if (getdistance(position, baseline) <= params.deadband)
+        {
+            moving = false;
+        }
+    }
+    return result(false);
+}
+
+} // namespace robot
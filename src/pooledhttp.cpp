@@ -0,0 +1,152 @@
+#include "robot/pooledhttp.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace robot
+{
+
+struct PooledHttp::Handler
+{
+  public:
+    Handler(factoryfunc factory, uint32_t size) :
+        factory{std::move(factory)}, size{size}
+    {
+        if (!this->factory || !size)
+        {
+            throw std::runtime_error("Cannot create pool of http clients");
+        }
+    }
+
+    template <typename In, typename Out>
+    bool get(const In& in, Out& out)
+    {
+        Lease lease(*this);
+        return lease->get(in, out);
+    }
+
+    std::string info()
+    {
+        Lease lease(*this);
+        return lease->info();
+    }
+
+    uint32_t getclients() const
+    {
+        std::lock_guard lock(mtx);
+        return created;
+    }
+
+  private:
+    // client is given back to pool when request is done or has thrown
+    class Lease
+    {
+      public:
+        explicit Lease(Handler& pool) : pool{pool}, client{pool.acquire()}
+        {}
+
+        ~Lease()
+        {
+            pool.release(std::move(client));
+        }
+
+        http::HttpIf* operator->() const
+        {
+            return client.get();
+        }
+
+      private:
+        Handler& pool;
+        std::shared_ptr<http::HttpIf> client;
+    };
+
+    const factoryfunc factory;
+    const uint32_t size;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::shared_ptr<http::HttpIf>> idle;
+    uint32_t created{};
+
+    std::shared_ptr<http::HttpIf> acquire()
+    {
+        std::unique_lock lock(mtx);
+        cv.wait(lock, [this]() { return !idle.empty() || created < size; });
+        if (!idle.empty())
+        {
+            auto client = std::move(idle.back());
+            idle.pop_back();
+            return client;
+        }
+        // slot is taken before client is made, so others do not wait on it
+        created++;
+        lock.unlock();
+        try
+        {
+            if (auto client = factory())
+            {
+                return client;
+            }
+        }
+        catch (...)
+        {
+            giveup();
+            throw;
+        }
+        giveup();
+        throw std::runtime_error("Cannot create http client for pool");
+    }
+
+    void release(std::shared_ptr<http::HttpIf>&& client)
+    {
+        {
+            std::lock_guard lock(mtx);
+            idle.push_back(std::move(client));
+        }
+        cv.notify_one();
+    }
+
+    void giveup()
+    {
+        {
+            std::lock_guard lock(mtx);
+            created--;
+        }
+        cv.notify_one();
+    }
+};
+
+PooledHttp::PooledHttp(factoryfunc factory, uint32_t size) :
+    handler{std::make_unique<Handler>(std::move(factory), size)}
+{}
+
+PooledHttp::~PooledHttp() = default;
+
+bool PooledHttp::get(const http::inputtype& in, http::outputtype& out)
+{
+    return handler->get(in, out);
+}
+
+bool PooledHttp::get(const http::inputtype& in, std::string& out)
+{
+    return handler->get(in, out);
+}
+
+bool PooledHttp::get(const std::string& in, std::string& out)
+{
+    return handler->get(in, out);
+}
+
+std::string PooledHttp::info()
+{
+    return handler->info();
+}
+
+uint32_t PooledHttp::getclients() const
+{
+    return handler->getclients();
+}
+
+} // namespace robot
@@ -0,0 +1,306 @@
+#include "robot/requeststats.hpp"
+
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+namespace robot
+{
+
+// commands sent to arm, requests of other types share last slot
+static constexpr std::array<int32_t, 9> knowntypes{100, 104, 1041, 105, 114,
+                                                   121, 210,  302,  405};
+static constexpr size_t othertype = knowntypes.size();
+
+static thread_local activity threadactivity{activity::other};
+
+static size_t getslot(int32_t type)
+{
+    auto it = std::ranges::find(knowntypes, type);
+    return (size_t)std::distance(knowntypes.begin(), it);
+}
+
+static int32_t gettype(const http::inputtype& in)
+{
+    if (auto it = in.find("T"); it != in.end())
+    {
+        if (const auto* type = std::get_if<int32_t>(&it->second))
+        {
+            return *type;
+        }
+    }
+    return -1;
+}
+
+static int32_t gettype(std::string_view json)
+{
+    static constexpr std::string_view key{"\"T\":"};
+    int32_t type{-1};
+    if (auto pos = json.find(key); pos != std::string_view::npos)
+    {
+        auto begin = json.data() + pos + key.size();
+        std::from_chars(begin, json.data() + json.size(), type);
+    }
+    return type;
+}
+
+// size of map as json object, numbers are estimated with their digits
+template <typename Map>
+static uint64_t getsize(const Map& values)
+{
+    uint64_t size{2};
+    std::ranges::for_each(values, [&size](const auto& item) {
+        size += item.first.size() + 4;
+        size += std::visit(
+            [](const auto& value) -> uint64_t {
+                using type = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<type, std::string>)
+                {
+                    return value.size() + 2;
+                }
+                else if constexpr (std::is_same_v<type, std::monostate>)
+                {
+                    return 4;
+                }
+                else
+                {
+                    return std::to_string(value).size();
+                }
+            },
+            item.second);
+    });
+    return size;
+}
+
+void LatencyHistogram::record(std::chrono::microseconds latency)
+{
+    static constexpr uint64_t subbuckets = 1 << subbits;
+    auto value = std::min((uint64_t)std::max(latency.count(), (int64_t)0),
+                          ((uint64_t)1 << maxbits) - 1);
+    size_t bucket = value;
+    if (value >= subbuckets)
+    {
+        auto shift = (uint64_t)std::bit_width(value) - 1 - subbits;
+        bucket = (shift + 1) * subbuckets + (value >> shift) - subbuckets;
+    }
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    auto prev = maximum.load(std::memory_order_relaxed);
+    while (prev < value && !maximum.compare_exchange_weak(
+                               prev, value, std::memory_order_relaxed))
+        ;
+    total.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const
+{
+    auto num = count();
+    return std::chrono::microseconds{
+        num ? (int64_t)(sum.load(std::memory_order_relaxed) / num) : 0};
+}
+
+std::chrono::microseconds LatencyHistogram::max() const
+{
+    return std::chrono::microseconds{
+        (int64_t)maximum.load(std::memory_order_relaxed)};
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double percent) const
+{
+    static constexpr uint64_t subbuckets = 1 << subbits;
+    auto num = count();
+    if (!num)
+    {
+        return {};
+    }
+    auto rank = std::max(
+        (uint64_t)std::ceil(std::clamp(percent, 0., 100.) / 100. * (double)num),
+        (uint64_t)1);
+    uint64_t seen{};
+    for (size_t bucket{}; bucket < counts.size(); bucket++)
+    {
+        seen += counts[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            auto shift = bucket < subbuckets ? 0 : bucket / subbuckets - 1;
+            auto mantissa =
+                bucket < subbuckets ? bucket : bucket % subbuckets + subbuckets;
+            auto highest = ((mantissa + 1) << shift) - 1;
+            return std::min(std::chrono::microseconds{(int64_t)highest},
+                            max());
+        }
+    }
+    return max();
+}
+
+struct MeteredHttp::Handler
+{
+  public:
+    explicit Handler(std::shared_ptr<http::HttpIf> httpIf) : httpIf{httpIf}
+    {
+        if (!httpIf)
+        {
+            throw std::runtime_error("No interface to meter requests on");
+        }
+    }
+
+    template <typename In, typename Out>
+    bool get(const In& in, Out& out)
+    {
+        using namespace std::chrono;
+        auto type = gettype(in);
+        tracing::Span span("request", "http", type);
+        auto start = steady_clock::now();
+        bool ok{};
+        try
+        {
+            ok = httpIf->get(in, out);
+        }
+        catch (...)
+        {
+            account(type, in, out, false, start);
+            throw;
+        }
+        account(type, in, out, ok, start);
+        return ok;
+    }
+
+    std::string info()
+    {
+        return httpIf->info();
+    }
+
+    requestreport_t getreport() const
+    {
+        requestreport_t report{};
+        for (size_t num{}; num < slots.size(); num++)
+        {
+            const auto& slot = slots[num];
+            if (auto requests = slot.latency.count())
+            {
+                report.commands.push_back(
+                    {.type = num < othertype ? knowntypes[num] : -1,
+                     .requests = requests,
+                     .failures = slot.failures.load(),
+                     .bytessent = slot.bytessent.load(),
+                     .bytesreceived = slot.bytesreceived.load(),
+                     .mean = slot.latency.mean(),
+                     .p50 = slot.latency.percentile(50.),
+                     .p90 = slot.latency.percentile(90.),
+                     .p99 = slot.latency.percentile(99.),
+                     .max = slot.latency.max()});
+            }
+        }
+        std::ranges::transform(activities, report.activities.begin(),
+                               [](const auto& cnt) { return cnt.load(); });
+        return report;
+    }
+
+  private:
+    struct slot_t
+    {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> failures;
+        std::atomic<uint64_t> bytessent;
+        std::atomic<uint64_t> bytesreceived;
+    };
+
+    const std::shared_ptr<http::HttpIf> httpIf;
+    std::array<slot_t, knowntypes.size() + 1> slots{};
+    std::array<std::atomic<uint64_t>, 5> activities{};
+
+    template <typename In, typename Out>
+    void account(int32_t type, const In& in, const Out& out, bool ok,
+                 std::chrono::steady_clock::time_point start)
+    {
+        using namespace std::chrono;
+        auto& slot = slots[getslot(type)];
+        if constexpr (std::is_same_v<In, std::string>)
+        {
+            slot.bytessent.fetch_add(in.size(), std::memory_order_relaxed);
+        }
+        else
+        {
+            slot.bytessent.fetch_add(getsize(in), std::memory_order_relaxed);
+        }
+        if constexpr (std::is_same_v<Out, std::string>)
+        {
+            slot.bytesreceived.fetch_add(out.size(),
+                                         std::memory_order_relaxed);
+        }
+        else
+        {
+            slot.bytesreceived.fetch_add(getsize(out),
+                                         std::memory_order_relaxed);
+        }
+        slot.failures.fetch_add(ok ? 0 : 1, std::memory_order_relaxed);
+        activities[(size_t)threadactivity].fetch_add(
+            1, std::memory_order_relaxed);
+        slot.latency.record(
+            duration_cast<microseconds>(steady_clock::now() - start));
+    }
+};
+
+activity getactivity()
+{
+    return threadactivity;
+}
+
+ActivityScope::ActivityScope(activity current) : prev{threadactivity}
+{
+    if (prev == activity::other)
+    {
+        threadactivity = current;
+    }
+}
+
+ActivityScope::~ActivityScope()
+{
+    threadactivity = prev;
+}
+
+MeteredHttp::MeteredHttp(std::shared_ptr<http::HttpIf> httpIf) :
+    handler{std::make_unique<Handler>(httpIf)}
+{}
+
+MeteredHttp::~MeteredHttp() = default;
+
+bool MeteredHttp::get(const http::inputtype& in, http::outputtype& out)
+{
+    return handler->get(in, out);
+}
+
+bool MeteredHttp::get(const http::inputtype& in, std::string& out)
+{
+    return handler->get(in, out);
+}
+
+bool MeteredHttp::get(const std::string& in, std::string& out)
+{
+    return handler->get(in, out);
+}
+
+std::string MeteredHttp::info()
+{
+    return handler->info();
+}
+
+
+requestreport_t MeteredHttp::getreport() const
+{
+    return handler->getreport();
+}
+
+} // namespace robot
@@ -1,21 +1,105 @@
 #include "robot/interfaces/roarmm2.hpp"
 
 #include "menu/interfaces/cli.hpp"
+#include "robot/behavior.hpp"
+#include "robot/behaviorscripts.hpp"
+#include "robot/callqueue.hpp"
+#include "robot/commandchannel.hpp"
+#include "robot/commands.hpp"
+#include "robot/convergence.hpp"
+#include "robot/executor.hpp"
+#include "robot/feedback.hpp"
+#include "robot/feedbackdecoder.hpp"
+#include "robot/filteredlog.hpp"
+#include "robot/helpers.hpp"
+#include "robot/kinematics.hpp"
+#include "robot/ledeffects.hpp"
+#include "robot/motiondetect.hpp"
+#include "robot/requeststats.hpp"
+#include "robot/shadowstate.hpp"
+#include "robot/speechcache.hpp"
+#include "robot/speechqueue.hpp"
+#include "robot/teach.hpp"
+#include "robot/tracing.hpp"
+#include "robot/trajectory.hpp"
 #include "robot/ttstexts.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <iterator>
 #include <memory>
-#include <random>
+#include <mutex>
+#include <sstream>
+#include <stop_token>
+#include <thread>
+#include <vector>
 
 namespace robot::roarmm2
 {
 
+using namespace std::chrono_literals;
+using robothelpers::append;
+
 static constexpr int32_t posmargin = 1;
 static constexpr int32_t eoatclosedangle = 180;
+static constexpr auto feedbackperiod = 50ms;
+static constexpr auto feedbackmaxage = 100ms;
+static constexpr auto feedbackfresh = 0ms;
+static constexpr convparams_t eoatconvergence{.deadline = 3000ms,
+                                              .margin = posmargin,
+                                              .mininterval = 20ms,
+                                              .maxinterval = 200ms,
+                                              .backoff = 1.5,
+                                              .stallvelocity = 5.,
+                                              .stallsamples = 4,
+                                              .startgrace = 300ms};
+// arm is at pose when within margin in millimeters, settled when slower
+// than stall velocity in millimeters per second
+static constexpr convparams_t arrivalconvergence{.deadline = 2000ms,
+                                                 .margin = 3.,
+                                                 .mininterval = 20ms,
+                                                 .maxinterval = 100ms,
+                                                 .backoff = 1.5,
+                                                 .stallvelocity = 10.,
+                                                 .stallsamples = 5,
+                                                 .startgrace = 500ms};
+// tool rotation weighs in arrival as distance traveled by its tip, so
+// millimeters per radian are about length of the jaw
+static constexpr double toolreach = 100.;
+static constexpr auto ledframeperiod = 40ms;
+static constexpr auto streamperiod = 50ms;
+static constexpr uint32_t speechlookahead = 2;
+static constexpr std::array<queueconfig_t, 3> workqueues{
+    {{.name = workqueue::lighting, .workers = 1, .depth = 4},
+     {.name = workqueue::telemetry, .workers = 1, .depth = 32},
+     {.name = workqueue::sensing, .workers = 2, .depth = 4}}};
+// calls of asynchronous interface waiting for the running one
+static constexpr size_t asyncdepth = 8;
+static constexpr uint32_t commandlanes = 3;
+static constexpr uint32_t motionorder = 0;
+static constexpr uint32_t ledorder = 1;
+static constexpr motionparams_t handmotion{
+    .period = 100ms, .deadband = 5., .latencytarget = 300ms};
+static constexpr const char* requeststatsfile = "robot_requests.txt";
+// joints taken on init command, their accepted distance from targets and
+// time after command before feedback of stopped joint is compared
+static constexpr joints_t basejoints{0., 0., M_PI / 2, M_PI};
+static constexpr double shadowtolerance = 2. * M_PI / 180.;
+static constexpr auto shadowsettle = 300ms;
+static constexpr auto teachperiod = 20ms;
+static constexpr const char* teachdir = "recordings";
+static constexpr const char* teachext = ".trj";
+static constexpr auto behaviortick = 5ms;
+static constexpr const char* behaviorsfile = "robot_behaviors.txt";
 
 using xyzt_t = std::tuple<int32_t, int32_t, int32_t, double>;
 using xyz_t = std::tuple<int32_t, int32_t, int32_t>;
@@ -37,19 +121,175 @@ struct HttoOutputVisitor
     }
 };
 
+struct control_t
+{
+    std::stop_token stoken{};
+    progressfunc progress{};
+    bool interactive{};
+
+    bool isstopped() const
+    {
+        return stoken.stop_requested() ||
+               (interactive && menu::cli::Menu::isenterpressed());
+    }
+
+    void report(task what) const
+    {
+        if (progress)
+        {
+            progress(what);
+        }
+    }
+};
+
+struct Runtime::Handler
+{
+  public:
+    explicit Handler(uint32_t robots) : executor{getqueues(robots)}
+    {}
+
+    // behaviors are compiled once, by robot created first
+    Scheduler& getscheduler(
+        const std::function<std::shared_ptr<const Program>()>& load)
+    {
+        std::call_once(scheduleronce, [this, &load]() {
+            scheduler = std::make_unique<Scheduler>(load(), behaviortick);
+        });
+        return *scheduler;
+    }
+
+    Executor executor;
+
+  private:
+    std::once_flag scheduleronce;
+    std::unique_ptr<Scheduler> scheduler;
+
+    static std::vector<queueconfig_t> getqueues(uint32_t robots)
+    {
+        if (!robots)
+        {
+            throw std::runtime_error("Runtime needs robots to serve");
+        }
+        std::vector<queueconfig_t> queues;
+        std::ranges::transform(
+            workqueues, std::back_inserter(queues), [robots](auto queue) {
+                // one more waiting worker for every other robot
+                if (queue.name == workqueue::sensing)
+                {
+                    queue.workers += robots - 1;
+                }
+                queue.depth *= robots;
+                return queue;
+            });
+        return queues;
+    }
+};
+
+Runtime::Runtime(uint32_t robots) :
+    handler{std::make_unique<Handler>(robots)}
+{}
+
+Runtime::~Runtime() = default;
+
 struct Robot::Handler
 {
   public:
     Handler(std::shared_ptr<http::HttpIf> httpIf,
             std::shared_ptr<tts::TextToVoiceIf> ttsIf,
-            std::shared_ptr<logging::LogIf> logIf) :
+            std::shared_ptr<logging::LogIf> logIf,
+            std::shared_ptr<Runtime> runtime) :
         httpIf{httpIf},
-        ttsIf{ttsIf}, logIf{logIf}
+        ttsIf{ttsIf}, logIf{logIf},
+        runtime{runtime ? runtime : std::make_shared<Runtime>()}
     {
         if (!this->httpIf)
         {
             throw std::runtime_error("No interface to connect to robot");
         }
+        filteredlog = std::dynamic_pointer_cast<FilteredLog>(this->logIf);
+        shadow = std::make_unique<ShadowState>(shadowtolerance, shadowsettle);
+        metered = std::make_shared<MeteredHttp>(this->httpIf);
+        this->httpIf = metered;
+        channel =
+            std::make_unique<CommandChannel>(this->httpIf, commandlanes);
+        feedback = std::make_unique<Feedback>(
+            [this](servofeedback_t& data) { return readfeedback(data); },
+            feedbackperiod);
+        // frames are computed on scheduler tick shared with behaviors
+        leds = std::make_unique<LedEngine>(
+            [this](uint8_t lvl) { return writeledframe(lvl); },
+            ledframeperiod,
+            [this](LedEngine::tickfunc tick) {
+                scheduler->attach(std::move(tick));
+            });
+        recorder = std::make_unique<Recorder>(
+            [this](joints_t& joints) {
+                servofeedback_t data{};
+                if (!readfeedback(data))
+                {
+                    return false;
+                }
+                joints = {data.b, data.s, data.e, data.t};
+                return true;
+            },
+            teachperiod);
+        streamer = std::make_unique<Streamer>(
+            [this](const waypoint_t& point) {
+                // every setpoint is sent, small steps make smooth motion
+                shadow->trackpose(point);
+                if (!sendcommand(setposcmd(toxyzt(point))))
+                {
+                    shadow->invalidate(shadowpart::joints);
+                }
+            },
+            streamperiod);
+        if (this->ttsIf)
+        {
+            // cached backend stops only own playback, other one can be
+            // stopped solely for all robots
+            auto cached =
+                std::dynamic_pointer_cast<CachedTextToVoice>(this->ttsIf);
+            speech = std::make_unique<SpeechQueue>(
+                [cached](const std::string& text) {
+                    if (cached)
+                    {
+                        tracing::Span span("prepare", "tts");
+                        cached->prepare(text);
+                    }
+                },
+                [this](const std::string& text) {
+                    tracing::Span span("speak", "tts");
+                    this->ttsIf->speak(text);
+                },
+                [cached]() {
+                    if (cached)
+                    {
+                        cached->stop();
+                    }
+                    else
+                    {
+                        tts::TextToVoiceIf::kill();
+                    }
+                },
+                speechlookahead);
+        }
+        executor = &this->runtime->handler->executor;
+        scheduler = &this->runtime->handler->getscheduler(
+            [this]() { return loadbehaviors(); });
+        calls = std::make_unique<CallQueue>(
+            [this](CallQueue::tickfunc tick) {
+                scheduler->attach(std::move(tick));
+            },
+            asyncdepth);
+    }
+
+    // behaviors and jobs of shared runtime may still use robot, so they
+    // are stopped and waited for
+    ~Handler()
+    {
+        halt.request_stop();
+        std::unique_lock lock(jobsmtx);
+        jobscv.wait(lock, [this]() { return !jobs; });
     }
 
     bool isenterpressed()
@@ -71,82 +311,148 @@ struct Robot::Handler
     void disengage()
     {
         speak(task::parked);
-        setledoff();
-        moveparked();
-        settorquelocked();
+        // led is independent from motion, so switch it off in parallel,
+        // only commands changing state of arm are sent
+        auto parked = getparkedpos();
+        const std::vector<pollfunc> pending{
+            sendqueued(shadow->setled(0), setledcmd(0), ledorder),
+            sendqueued(shadow->setpose(towaypoint(parked)), setposcmd(parked),
+                       motionorder),
+            sendqueued(shadow->settorque(true), command::Torque{1},
+                       motionorder)};
+        std::ranges::for_each(pending, [](const auto& sent) {
+            while (!sent())
+            {
+                std::this_thread::sleep_for(behaviortick);
+            }
+        });
+        // final line is spoken while parking, not dropped with the queue
+        waitspeakdone();
     }
 
     void movebase()
     {
-        sendcommand({{"T", 100}});
+        sendchanging(shadow->setjoints(basejoints), command::MoveInit{});
         speak(task::ready);
     }
 
     void moveleft()
     {
-        sendcommand({{"T", 121},
-                     {"joint", 1},
-                     {"angle", 45},
-                     {"spd", 10},
-                     {"acc", 10}});
+        sendchanging(shadow->setjoint(0, dgrtorad(45)),
+                     command::MoveJoint{
+                         .joint = 1, .angle = 45, .spd = 10, .acc = 10});
     }
 
     void moveright()
     {
-        sendcommand({{"T", 121},
-                     {"joint", 1},
-                     {"angle", -45},
-                     {"spd", 10},
-                     {"acc", 10}});
+        sendchanging(shadow->setjoint(0, dgrtorad(-45)),
+                     command::MoveJoint{
+                         .joint = 1, .angle = -45, .spd = 10, .acc = 10});
     }
 
     void moveparked()
     {
-        sendcommand(setposcmd({80, 0, 455, dgrtorad(180 - 35)}));
+        movetopos(getparkedpos());
     }
 
     void settorqueunlocked()
     {
-        sendcommand({{"T", 210}, {"cmd", 0}});
+        sendchanging(shadow->settorque(false), command::Torque{.cmd = 0});
     }
 
     void settorquelocked()
     {
-        sendcommand({{"T", 210}, {"cmd", 1}});
+        sendchanging(shadow->settorque(true), command::Torque{.cmd = 1});
     }
 
     void setledon(uint8_t lvl)
     {
-        sendcommand({{"T", 114}, {"led", lvl}});
-        ledstatus = true;
+        if (shadow->setled(lvl) &&
+            !channel->send(command::tojson(setledcmd(lvl)), ledorder).get().ok)
+        {
+            shadow->invalidate(shadowpart::led);
+        }
     }
 
     void setledoff()
     {
-        sendcommand({{"T", 114}, {"led", 0}});
+        setledon(0);
+    }
 
-        ledstatus = false;
+    // frame is dropped while previous one is being sent, so effect keeps
+    // its pace on slow link and tick is never blocked
+    bool writeledframe(uint8_t lvl)
+    {
+        if (ledwriting.exchange(true))
+        {
+            return false;
+        }
+        if (!shadow->setled(lvl))
+        {
+            ledwriting = false;
+            return true;
+        }
+        channel->send(command::tojson(setledcmd(lvl)), ledorder,
+                      [this](const response_t& resp) {
+                          if (!resp.ok)
+                          {
+                              shadow->invalidate(shadowpart::led);
+                          }
+                          ledwriting = false;
+                      });
+        return true;
     }
 
-    std::string getwifiinfo()
+    void getwifiinfo(std::string& str)
     {
         http::outputtype output;
         if (sendcommand({{"T", 405}}, output))
         {
-            return getstrfromhttp(output);
+            getstrfromhttp(output, str);
         }
-        return {};
     }
 
-    std::string getservosinfo()
+    void getrequeststats(std::string& str) const
     {
-        http::outputtype output;
-        if (sendcommand({{"T", 105}}, output))
+        static constexpr auto activities = std::to_array<const char*>(
+            {"other", "dance", "shakehand", "enlight", "gripper"});
+        auto report = metered->getreport();
+        str += "T : requests/failures, sent/received bytes, "
+               "latency avg/p50/p90/p99/max us\n";
+        std::ranges::for_each(report.commands, [&str](const auto& cmd) {
+            append(str, cmd.type, " : ", cmd.requests, "/", cmd.failures,
+                   ", ", cmd.bytessent, "/", cmd.bytesreceived, ", ",
+                   cmd.mean.count(), "/", cmd.p50.count(), "/",
+                   cmd.p90.count(), "/", cmd.p99.count(), "/",
+                   cmd.max.count(), "\n");
+        });
+        for (size_t num{}; num < activities.size(); num++)
         {
-            auto eoatdgr = (int32_t)radtodgr(std::get<double>(output.at("t")));
-            return getstrfromhttp(output) + "t : " + std::to_string(eoatdgr);
+            append(str, activities[num], " requests : ",
+                   report.activities[num], "\n");
+        }
+        auto shadowstats = shadow->getstats();
+        append(str, "elided requests : ", shadowstats.elided,
+               ", dropped targets : ", shadowstats.dropped, "\n");
+    }
+
+    bool dumprequeststats() const
+    {
+        std::string str;
+        getrequeststats(str);
+        std::ofstream file(requeststatsfile, std::ios::app);
+        file << robothelpers::gettimestr() << "\n" << str << "\n";
+        return (bool)file;
+    }
+
+    void getservosinfo(std::string& str)
+    {
+        if (auto snapshot = feedback->get(feedbackmaxage))
+        {
+            const auto& data = snapshot->data;
+            getstrfromfeedback(data, str);
+            append(str, "t : ", (int32_t)radtodgr(data.t));
         }
-        return {};
     }
 
     bool seteoat(int32_t rawangle, int32_t& retangle)
@@ -155,16 +461,18 @@ struct Robot::Handler
         {
             Eoat(Handler* handler, int32_t rawangle) :
                 handler{handler}, setpoint{convert(rawangle)},
-                currangle{handler->geteoatangle()}
+                currangle{handler->geteoatangle(feedbackmaxage)}
             {}
 
             void move()
             {
-                handler->sendcommand({{"T", 121},
-                                      {"joint", 4},
-                                      {"angle", setpoint},
-                                      {"spd", 50},
-                                      {"acc", 10}});
+                // feedback showed jaw outside margin, which may still be
+                // within tolerance of shadow, so resend is never elided
+                handler->shadow->invalidatejoint(3);
+                handler->sendchanging(
+                    handler->shadow->setjoint(3, handler->dgrtorad(setpoint)),
+                    command::MoveJoint{
+                        .joint = 4, .angle = setpoint, .spd = 50, .acc = 10});
                 waitmoving();
             }
 
@@ -181,35 +489,36 @@ struct Robot::Handler
           private:
             const Handler* handler;
             const int32_t setpoint;
-            const uint32_t maxrepeats{3};
-            int32_t currangle{}, prevangle{};
-            uint32_t repeats{};
+            int32_t currangle{};
 
             void waitmoving()
             {
-                while ((currangle = handler->geteoatangle()) != setpoint)
+                auto result = waitconverged(
+                    [this]() {
+                        return (double)handler->geteoatangle(feedbackfresh);
+                    },
+                    setpoint, eoatconvergence);
+                currangle = (int32_t)result.position;
+                handler->log(logging::type::debug, [&result](auto& str) {
+                    append(str, "Eaot moved in ", result.elapsed.count(),
+                           " ms with ", result.polls, " polls");
+                });
+                switch (result.status)
                 {
-                    if (currangle == prevangle)
-                    {
-                        if (handler->isposaccepted(currangle, setpoint))
-                        {
-                            handler->log(
-                                logging::type::debug,
-                                "Eaot not in setpoint, but within margin");
-                            break;
-                        }
-                        if (repeats++ == maxrepeats)
-                        {
-                            handler->log(logging::type::warning,
-                                         "Eaot cannot reach setpoint");
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        repeats = 0;
-                        prevangle = currangle;
-                    }
+                    case convergence::reached:
+                        break;
+                    case convergence::withinmargin:
+                        handler->log(logging::type::debug,
+                                     "Eaot not in setpoint, but within margin");
+                        break;
+                    case convergence::stalled:
+                        handler->log(logging::type::warning,
+                                     "Eaot cannot reach setpoint");
+                        break;
+                    case convergence::timedout:
+                        handler->log(logging::type::warning,
+                                     "Eaot not in setpoint before deadline");
+                        break;
                 }
             }
 
@@ -228,156 +537,151 @@ struct Robot::Handler
 
     bool openeoat()
     {
+        ActivityScope scope(activity::gripper);
         [[maybe_unused]] int32_t retangle{};
         return seteoat(45, retangle);
     }
 
     bool closeeoat()
     {
+        ActivityScope scope(activity::gripper);
         [[maybe_unused]] int32_t retangle{};
         return seteoat(0, retangle);
     }
 
-    std::string getdeviceinfo()
+    void getdeviceinfo(std::string& str)
     {
         http::outputtype output;
         if (sendcommand({{"T", 302}}, output))
         {
-            return getstrfromhttp(output);
+            getstrfromhttp(output, str);
         }
-        return {};
     }
 
-    void shakehand()
+    bool shakehand(const control_t& ctrl)
     {
-        movehandshakepos();
-        speak(task::greetstart);
-        usleep(2 * 1000 * 1000);
-
-        auto initpos = getxyz();
-        while (!isenterpressed())
-        {
-            if (initpos != getxyz())
-            {
-                if (!closeeoat())
-                {
-                    speak(task::greetshake);
-                    for (uint8_t cnt{}; cnt < 3; cnt++)
-                    {
-                        dohandshake();
-                    }
-                    movehandshakepos();
-                    speak(task::greetend);
-                    usleep(1000 * 1000);
-                    break;
-                }
-                speak(task::greetfail);
-                movehandshakepos();
-                usleep(2 * 1000 * 1000);
-                initpos = getxyz();
-            }
-        }
-        movebase();
+        return runbehavior("shakehand", activity::shakehand, ctrl);
     }
 
-    void dance()
+    bool dance(const control_t& ctrl)
     {
-        std::atomic<bool> singing{true};
-        movedancebasepos();
-        speak(task::dancestart);
-        auto singingcall = std::async(std::launch::async, [this, &singing]() {
-            auto phrases =
-                std::to_array<task>({task::songlinefirst, task::songlinesecond,
-                                     task::songlinethird, task::songlineforth});
-            uint32_t cnt{};
-            while (singing)
-            {
-                auto num = (cnt++) % phrases.size();
-                speak(phrases[num], false);
-            }
-            speak(task::danceend);
-        });
-
-        auto ledcall = std::async(std::launch::async, [this, &singing]() {
-            bool increase{true};
-            int32_t level{}, step{5};
-            while (singing)
-            {
-                increase = level > 120 ? false : level < 10 ? true : increase;
-                level += increase ? step : -step;
-                setledon((uint8_t)level);
-                usleep(1000);
-            }
-            setledoff();
-        });
-
-        auto dancestates =
-            std::to_array<xyzt_t>({{-65, 145, 160, dgrtorad(180 - 65)},
-                                   {-140, 320, 355, dgrtorad(180 - 0)},
-                                   {65, 35, 95, dgrtorad(180 - 25)},
-                                   {60, 110, 455, dgrtorad(180 - 45)},
-                                   {12, 400, -75, dgrtorad(180 - 10)}});
-
-        std::random_device os_seed;
-        const uint32_t seed = os_seed();
-        std::mt19937 generator(seed);
-        std::uniform_int_distribution<uint32_t> rand(0, dancestates.size() - 1);
-
-        while (!isenterpressed())
-        {
-            static uint32_t prevpos{UINT32_MAX};
-            uint32_t pos{};
-            while ((pos = rand(generator)) == prevpos)
-                ;
-            movetopos(dancestates[pos]);
-            prevpos = pos;
-            usleep(1200 * 1000);
-        }
-        singing = false;
-        tts::TextToVoiceIf::kill();
-        movedancebasepos();
-        ledcall.wait();
-        singingcall.wait();
-        movebase();
+        return runbehavior("dance", activity::dance, ctrl);
     }
 
-    void enlight()
+    bool teach(const control_t& ctrl)
     {
-        speak(task::enlightstart);
-        setledoff();
-        movehandshakepos();
-        movetopos({424, 75, 168, dgrtorad(180 - 0)});
-
-        auto ledcall = std::async(std::launch::async, [this]() {
-            int32_t step{2};
-            for (int32_t level{0}; level < 120; level += step)
-            {
-                setledon((uint8_t)level);
-                usleep(10 * 1000);
-            }
-            speak(task::enlightbreak);
-        });
-
-        while (!isenterpressed())
+        settorqueunlocked();
+        log(logging::type::info,
+            "Move arm by hand, press enter to finish teaching");
+        recorder->start();
+        while (!ctrl.isstopped())
+        {
+            pause(100ms, ctrl);
+        }
+        auto recording = recorder->stop();
+        settorquelocked();
+        if (!recording.size())
         {
-            usleep(100 * 1000);
+            log(logging::type::warning, "Nothing recorded while teaching");
+            return false;
         }
 
-        ledcall.wait();
-        speak(task::enlightend);
+        std::filesystem::create_directories(teachdir);
+        auto path = std::filesystem::path{teachdir} /
+                    (std::to_string(std::chrono::system_clock::now()
+                                        .time_since_epoch() /
+                                    1ms) +
+                     teachext);
+        recording.save(path);
+        log(logging::type::info,
+            [&recording, &path, stats = recorder->getstats()](auto& str) {
+                append(str, "Recorded ", recording.size(), " samples in ",
+                       recording.bytes(), " bytes to ", path.native(),
+                       ", missed: ", stats.missed,
+                       ", overruns: ", stats.overruns);
+            });
+        return true;
+    }
 
-        ledcall = std::async(std::launch::async, [this]() {
-            int32_t step{2};
-            for (int32_t level{120}; level > 0; level -= step)
+    bool replay(const control_t& ctrl, double scale)
+    {
+        auto path = getlatestrecording();
+        if (path.empty())
+        {
+            log(logging::type::warning, "No recording to replay");
+            return false;
+        }
+        std::vector<waypoint_t> points;
+        try
+        {
+            // recording is mapped, poses are computed only for replay steps
+            points = resample(Recording(path), streamperiod, scale);
+        }
+        catch (const std::exception& ex)
+        {
+            log(logging::type::error, [&path, &ex](auto& str) {
+                append(str, "Cannot replay ", path.native(), ": ", ex.what());
+            });
+            return false;
+        }
+        if (points.empty())
+        {
+            log(logging::type::warning, "Nothing to replay in recording");
+            return false;
+        }
+        movetoposandwait(toxyzt(points.front()), 100);
+        if (ctrl.isstopped())
+        {
+            return false;
+        }
+        // streamer is stopped by own source, as enter is only polled
+        std::stop_source stop;
+        auto done = streamer->run(
+            Trajectory(points, streamperiod, interpolation::linear),
+            stop.get_token());
+        while (done.wait_for(behaviortick) != std::future_status::ready)
+        {
+            if (ctrl.isstopped())
             {
-                setledon((uint8_t)level);
-                usleep(1000);
+                stop.request_stop();
             }
-        });
+        }
+        logstreamstats(done.get());
+        return !stop.stop_requested();
+    }
 
-        ledcall.wait();
-        setledoff();
-        movebase();
+    bool enlight(const control_t& ctrl)
+    {
+        return runbehavior("enlight", activity::enlight, ctrl);
+    }
+
+    // calls of asynchronous interface are run one after another as
+    // behaviors, their ends are polled by scheduler, so no thread waits
+    std::future<bool> runasync(std::string_view name, activity current,
+                               const control_t& ctrl,
+                               std::optional<task> done = std::nullopt)
+    {
+        auto stats = std::make_shared<streamstats_t>();
+        return calls->push(
+            {.start =
+                 [this, name, current, ctrl, stats]() {
+                     ActivityScope scope(current);
+                     return scheduler->run(name, getactions(ctrl, stats));
+                 },
+             .isstopped =
+                 [this, ctrl]() {
+                     return halt.stop_requested() || ctrl.isstopped();
+                 },
+             .finish =
+                 [this, ctrl, done, stats,
+                  guard = std::make_shared<JobGuard>(*this)](bool succeeded) {
+                     if (succeeded && done)
+                     {
+                         ctrl.report(*done);
+                     }
+                     logbehaviorstats(*stats);
+                     logqueuestats();
+                 }});
     }
 
     void sendusercmd()
@@ -395,6 +699,8 @@ struct Robot::Handler
                 try
                 {
                     log(logging::type::info, sendcommand(usercmd));
+                    // effect of arbitrary command is not known
+                    shadow->invalidate();
                 }
                 catch (const std::exception& e)
                 {
@@ -475,14 +781,34 @@ struct Robot::Handler
         }
     }
 
+    bool islogged(logging::type type) const
+    {
+        return logIf && (!filteredlog || filteredlog->isenabled(type));
+    }
+
     void log(logging::type type, const std::string& msg) const
     {
-        if (logIf)
+        if (islogged(type))
         {
             logIf->log(type, module, msg);
         }
     }
 
+    // Message is formatted only when its level is logged, into buffer
+    // reused by calling thread
+    template <typename F>
+        requires std::invocable<F&, std::string&>
+    void log(logging::type type, F&& format) const
+    {
+        if (islogged(type))
+        {
+            thread_local std::string buffer;
+            buffer.clear();
+            format(buffer);
+            logIf->log(type, module, buffer);
+        }
+    }
+
     tts::language getlanguage()
     {
         auto voice = ttsIf->getvoice();
@@ -491,12 +817,12 @@ struct Robot::Handler
 
     bool iseoatclosed()
     {
-        return isposaccepted(geteoatangle(), eoatclosedangle);
+        return isposaccepted(geteoatangle(feedbackmaxage), eoatclosedangle);
     }
 
     bool isledon()
     {
-        return ledstatus;
+        return shadow->getled().value_or(0) > 0;
     }
 
   private:
@@ -504,20 +830,307 @@ struct Robot::Handler
     std::shared_ptr<http::HttpIf> httpIf;
     std::shared_ptr<tts::TextToVoiceIf> ttsIf;
     std::shared_ptr<logging::LogIf> logIf;
-    std::future<void> ttsasync;
-    bool ledstatus{};
+    std::shared_ptr<FilteredLog> filteredlog;
+    // used by threads of components below, so destroyed after them
+    std::unique_ptr<ShadowState> shadow;
+    std::atomic<bool> ledwriting{};
+    std::shared_ptr<MeteredHttp> metered;
+    std::unique_ptr<CommandChannel> channel;
+    std::unique_ptr<Feedback> feedback;
+    std::unique_ptr<LedEngine> leds;
+    std::unique_ptr<Streamer> streamer;
+    std::unique_ptr<Recorder> recorder;
+    std::unique_ptr<SpeechQueue> speech;
+    std::shared_ptr<Runtime> runtime;
+    Executor* executor{};
+    Scheduler* scheduler{};
+    std::unique_ptr<CallQueue> calls;
+    std::stop_source halt;
+    std::mutex jobsmtx;
+    std::condition_variable jobscv;
+    uint32_t jobs{};
+
+    // job released once it is done or dropped by full queue
+    class JobGuard
+    {
+      public:
+        explicit JobGuard(Handler& owner) : owner{owner}
+        {
+            std::lock_guard lock(owner.jobsmtx);
+            owner.jobs++;
+        }
+
+        ~JobGuard()
+        {
+            std::lock_guard lock(owner.jobsmtx);
+            if (!--owner.jobs)
+            {
+                owner.jobscv.notify_all();
+            }
+        }
+
+      private:
+        Handler& owner;
+    };
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(workqueue name, F&& func)
+    {
+        return executor->submit(
+            name, [guard = std::make_shared<JobGuard>(*this),
+                   func = std::forward<F>(func)]() { return func(); });
+    }
+
+    template <typename F>
+    bool post(workqueue name, F&& func)
+    {
+        return executor->post(
+            name, [guard = std::make_shared<JobGuard>(*this),
+                   func = std::forward<F>(func)]() { func(); });
+    }
+
+    void pause(std::chrono::milliseconds time, const control_t& ctrl)
+    {
+        tracing::Span span("pause", "sleep");
+        std::mutex mtx;
+        std::unique_lock lock(mtx);
+        std::condition_variable_any().wait_for(lock, ctrl.stoken, time,
+                                               []() { return false; });
+    }
+
+    bool runbehavior(std::string_view name, activity current,
+                     const control_t& ctrl)
+    {
+        ActivityScope scope(current);
+        auto stats = std::make_shared<streamstats_t>();
+        auto done = scheduler->run(name, getactions(ctrl, stats)).get();
+        logbehaviorstats(*stats);
+        return done;
+    }
+
+    void logbehaviorstats(const streamstats_t& stats)
+    {
+        if (stats.setpoints)
+        {
+            logstreamstats(stats);
+        }
+        logledstats();
+        logspeechstats();
+        logschedulerstats();
+    }
+
+    // waits are run on sensing workers, so they do not hold scheduler,
+    // actions sending requests take activity of the behavior along
+    actions_t getactions(const control_t& ctrl,
+                         std::shared_ptr<streamstats_t> stats)
+    {
+        return {
+            .isstopped =
+                [this, ctrl]() {
+                    return halt.stop_requested() || ctrl.isstopped();
+                },
+            .move =
+                withactivity([this](const waypoint_t& pose, uint32_t spd) {
+                    auto pos = toxyzt(pose);
+                    auto changing = shadow->setpose(pose);
+                    return spd ? sendqueued(changing, setposcmd(pos, spd),
+                                            motionorder)
+                               : sendqueued(changing, setposcmd(pos),
+                                            motionorder);
+                }),
+            .glide = withactivity(
+                [this, stats](const std::optional<waypoint_t>& from,
+                              const waypoint_t& to,
+                              std::chrono::milliseconds time,
+                              std::stop_token stoken) {
+                    return glide(from, to, time, stoken, stats);
+                }),
+            .base =
+                withactivity([this]() {
+                    speak(task::ready);
+                    return sendqueued(shadow->setjoints(basejoints),
+                                      command::MoveInit{}, motionorder);
+                }),
+            .say =
+                [this, ctrl](task what) {
+                    ctrl.report(what);
+                    return topoll(
+                        speech ? speech->push(gettext(what),
+                                              speechpriority::status)
+                               : std::future<bool>{});
+                },
+            .sing =
+                [this, ctrl](task what) {
+                    ctrl.report(what);
+                    return topoll(sing(what));
+                },
+            .hush = [this]() { hush(); },
+            .light =
+                withactivity([this](effect_t effect) {
+                    if (effect)
+                    {
+                        leds->run(std::move(effect));
+                        return topoll(true);
+                    }
+                    // last frame of effect may still be written
+                    return topoll(
+                        submit(workqueue::lighting, [this]() {
+                            leds->stop();
+                            setledoff();
+                            return true;
+                        }));
+                }),
+            .lightwait =
+                [this]() -> pollfunc {
+                    // polled by scheduler, so no worker waits for effect
+                    return [this]() -> std::optional<bool> {
+                        if (leds->wait(0ms))
+                        {
+                            return true;
+                        }
+                        return std::nullopt;
+                    };
+                },
+            .arrival =
+                withactivity([this](const waypoint_t& pose) {
+                    return topoll(submit(
+                        workqueue::sensing, [this, pos = toxyzt(pose)]() {
+                            auto status = awaitarrival(pos).status;
+                            return status == convergence::reached ||
+                                   status == convergence::withinmargin;
+                        }));
+                }),
+            .hand =
+                withactivity([this](std::stop_token stoken) {
+                    return topoll(submit(
+                        workqueue::sensing,
+                        [this, stoken]() { return detecthand(stoken); }));
+                }),
+            .grip =
+                withactivity([this](bool close) {
+                    return topoll(submit(
+                        workqueue::sensing, [this, close]() {
+                            return close ? closeeoat() : openeoat();
+                        }));
+                })};
+    }
+
+    pollfunc glide(const std::optional<waypoint_t>& from,
+                   const waypoint_t& to, std::chrono::milliseconds time,
+                   std::stop_token stoken,
+                   std::shared_ptr<streamstats_t> stats)
+    {
+        if (!from)
+        {
+            // start is read on worker, streaming begins once it is known
+            auto start = std::make_shared<std::future<waypoint_t>>(
+                submit(workqueue::sensing, [this]() {
+                    return towaypoint(getxyzt(feedbackmaxage));
+                }));
+            auto streaming = std::make_shared<pollfunc>();
+            return withactivity([this, start, streaming, to, time, stoken,
+                                 stats]() -> std::optional<bool> {
+                if (!*streaming)
+                {
+                    if (start->wait_for(0s) != std::future_status::ready)
+                    {
+                        return std::nullopt;
+                    }
+                    *streaming = glide(start->get(), to, time, stoken, stats);
+                }
+                return (*streaming)();
+            });
+        }
+        Trajectory trajectory({*from, to}, time);
+        if (!isfeasible(trajectory))
+        {
+            log(logging::type::warning, [&to](auto& str) {
+                append(str, "Pose ", (int32_t)to[0], ", ", (int32_t)to[1],
+                       ", ", (int32_t)to[2], " cannot be reached, skipping");
+            });
+            return topoll(false);
+        }
+        auto streamed = std::make_shared<std::future<streamstats_t>>(
+            streamer->run(trajectory, stoken));
+        return [streamed, stats]() -> std::optional<bool> {
+            if (streamed->wait_for(0s) != std::future_status::ready)
+            {
+                return std::nullopt;
+            }
+            auto movestats = streamed->get();
+            stats->setpoints += movestats.setpoints;
+            stats->missed += movestats.missed;
+            stats->sumjitter += movestats.sumjitter;
+            stats->maxjitter = std::max(stats->maxjitter, movestats.maxjitter);
+            return true;
+        };
+    }
+
+    bool detecthand(std::stop_token stoken)
+    {
+        auto motion = detectmotion(
+            [this]() {
+                const auto [x, y, z] = getxyz(handmotion.period);
+                return position_t{(double)x, (double)y, (double)z};
+            },
+            [&stoken]() { return stoken.stop_requested(); }, handmotion);
+        if (motion.detected)
+        {
+            log(logging::type::debug, [&motion](auto& str) {
+                append(str, "Hand detected with latency ",
+                       motion.latency.count(), " ms, ", motion.samples,
+                       " samples, ", motion.cputime.count(), " us of cpu");
+            });
+        }
+        return motion.detected;
+    }
+
+    // behaviors can be changed without rebuild by file in working directory
+    std::shared_ptr<const Program> loadbehaviors()
+    {
+        std::shared_ptr<const Program> program;
+        if (std::ifstream file(behaviorsfile); file)
+        {
+            std::stringstream script;
+            script << file.rdbuf();
+            script << getcallscript();
+            program = std::make_shared<const Program>(script.str());
+            log(logging::type::info, [](auto& str) {
+                append(str, "Behaviors loaded from ", behaviorsfile);
+            });
+        }
+        else
+        {
+            program = std::make_shared<const Program>(
+                std::string(getbehaviorscript()) +
+                std::string(getcallscript()));
+        }
+        for (const auto* name : {"shakehand", "dance", "enlight"})
+        {
+            if (!program->find(name))
+            {
+                throw std::runtime_error(std::string("No behavior ") + name +
+                                         " in script");
+            }
+        }
+        return program;
+    }
+
+    command::SetLed setledcmd(uint8_t lvl) const
+    {
+        return {.led = lvl};
+    }
 
-    http::inputtype setposcmd(const xyzt_t& pos, double spd)
+    command::MoveXYZT setposcmd(const xyzt_t& pos, double spd) const
     {
         const auto [x, y, z, t] = pos;
-        return {{"T", 104}, {"x", x}, {"y", y},
-                {"z", z},   {"t", t}, {"spd", spd}};
-    };
+        return {.x = x, .y = y, .z = z, .t = t, .spd = spd};
+    }
 
-    http::inputtype setposcmd(const xyzt_t& pos)
+    command::MoveXYZTDirect setposcmd(const xyzt_t& pos) const
     {
         const auto [x, y, z, t] = pos;
-        return {{"T", 1041}, {"x", x}, {"y", y}, {"z", z}, {"t", t}};
+        return {.x = x, .y = y, .z = z, .t = t};
     }
 
     constexpr double radtodgr(double rad) const
@@ -530,58 +1143,154 @@ struct Robot::Handler
         return dgr * M_PI / 180.;
     }
 
-    xyzt_t getxyzt()
+    std::shared_ptr<const snapshot_t>
+        getfeedback(std::chrono::milliseconds maxage) const
+    {
+        if (auto snapshot = feedback->get(maxage))
+        {
+            return snapshot;
+        }
+        throw std::runtime_error("Cannot read feedback from robot");
+    }
+
+    xyzt_t getxyzt(std::chrono::milliseconds maxage = feedbackfresh) const
     {
-        http::outputtype ret;
-        sendcommand({{"T", 105}}, ret);
-        return {(int32_t)std::get<double>(ret.at("x")),
-                (int32_t)std::get<double>(ret.at("y")),
-                (int32_t)std::get<double>(ret.at("z")),
-                std::get<double>(ret.at("t"))};
+        const auto& ret = getfeedback(maxage)->data;
+        return {(int32_t)ret.x, (int32_t)ret.y, (int32_t)ret.z, ret.t};
     }
 
-    xyz_t getxyz()
+    xyz_t getxyz(std::chrono::milliseconds maxage = feedbackfresh) const
     {
-        http::outputtype ret;
-        sendcommand({{"T", 105}}, ret);
-        return {(int32_t)std::get<double>(ret.at("x")),
-                (int32_t)std::get<double>(ret.at("y")),
-                (int32_t)std::get<double>(ret.at("z"))};
+        const auto& ret = getfeedback(maxage)->data;
+        return {(int32_t)ret.x, (int32_t)ret.y, (int32_t)ret.z};
     }
 
-    int32_t geteoatangle() const
+    int32_t geteoatangle(std::chrono::milliseconds maxage) const
     {
-        http::outputtype ret;
-        sendcommand({{"T", 105}}, ret);
-        return (int32_t)radtodgr(std::get<double>(ret.at("t")));
+        return (int32_t)radtodgr(getfeedback(maxage)->data.t);
+    }
+
+    void logledstats()
+    {
+        auto stats = leds->getstats();
+        logtelemetry([stats](auto& str) {
+            append(str, "Led frames: ", stats.frames, ", writes: ",
+                   stats.writes, ", dropped: ", stats.dropped);
+        });
     }
 
     void movetopos(xyzt_t pos)
     {
-        sendcommand(setposcmd(pos));
+        sendchanging(shadow->setpose(towaypoint(pos)), setposcmd(pos));
     }
 
     void movetopos(xyzt_t pos, uint32_t spd)
     {
-        sendcommand(setposcmd(pos, spd));
+        sendchanging(shadow->setpose(towaypoint(pos)), setposcmd(pos, spd));
+    }
+
+    xyzt_t getparkedpos() const
+    {
+        return {80, 0, 455, dgrtorad(180 - 35)};
+    }
+
+    void movetoposandwait(xyzt_t pos, uint32_t spd)
+    {
+        movetopos(pos, spd);
+        awaitarrival(pos);
     }
 
-    void movehandshakepos()
+    // Returns as soon as arm settles, at target or where it got stuck
+    convresult_t awaitarrival(const xyzt_t& pos) const
     {
-        movetopos({175, 235, 325, dgrtorad(180 - 35)}, 100);
+        tracing::Span span("arrival", "motion");
+        const auto target = towaypoint(pos);
+        auto result = waitconverged(
+            [this, &target]() {
+                const auto& data = getfeedback(feedbackfresh)->data;
+                return std::sqrt(
+                    std::pow(data.x - target[0], 2) +
+                    std::pow(data.y - target[1], 2) +
+                    std::pow(data.z - target[2], 2) +
+                    std::pow((data.t - target[3]) * toolreach, 2));
+            },
+            0., arrivalconvergence);
+        if (result.status == convergence::reached ||
+            result.status == convergence::withinmargin)
+        {
+            log(logging::type::debug, [&result](auto& str) {
+                append(str, "Arm arrived in ", result.elapsed.count(),
+                       " ms with ", result.polls, " polls");
+            });
+        }
+        else
+        {
+            log(logging::type::warning, [&result](auto& str) {
+                append(str, "Arm settled ", (int32_t)result.position,
+                       " mm from target after ", result.elapsed.count(),
+                       " ms");
+            });
+        }
+        return result;
     }
 
-    void dohandshake()
+    waypoint_t towaypoint(const xyzt_t& pos) const
     {
-        movetopos({245, 310, 215, dgrtorad(180)}, 150);
-        usleep(500 * 1000);
-        movetopos({215, 280, 335, dgrtorad(180)}, 150);
-        usleep(500 * 1000);
+        const auto [x, y, z, t] = pos;
+        return {(double)x, (double)y, (double)z, t};
     }
 
-    void movedancebasepos()
+    xyzt_t toxyzt(const waypoint_t& point) const
     {
-        movetopos({175, 235, 325, dgrtorad(180 - 35)}, 100);
+        const auto [x, y, z, t] = point;
+        return {(int32_t)std::lround(x), (int32_t)std::lround(y),
+                (int32_t)std::lround(z), t};
+    }
+
+    std::filesystem::path getlatestrecording() const
+    {
+        std::filesystem::path latest;
+        std::error_code error;
+        std::filesystem::file_time_type latesttime{};
+        for (const auto& entry :
+             std::filesystem::directory_iterator(teachdir, error))
+        {
+            if (entry.path().extension() == teachext &&
+                (latest.empty() || entry.last_write_time() > latesttime))
+            {
+                latest = entry.path();
+                latesttime = entry.last_write_time();
+            }
+        }
+        return latest;
+    }
+
+    bool isfeasible(const Trajectory& trajectory) const
+    {
+        posebatch_t poses;
+        for (auto time = 0ms; time <= trajectory.duration();
+             time += streamperiod)
+        {
+            const auto [x, y, z, t] = trajectory.sample(time);
+            poses.x.push_back(x);
+            poses.y.push_back(y);
+            poses.z.push_back(z);
+            poses.t.push_back(t);
+        }
+        jointbatch_t joints;
+        std::vector<uint8_t> valid;
+        return inverse(poses, joints, valid) == valid.size();
+    }
+
+    void logstreamstats(const streamstats_t& stats)
+    {
+        auto avgjitter =
+            stats.setpoints ? stats.sumjitter / (int64_t)stats.setpoints : 0us;
+        logtelemetry([stats, avgjitter](auto& str) {
+            append(str, "Streamed setpoints: ", stats.setpoints,
+                   ", missed: ", stats.missed, ", jitter avg/max: ",
+                   avgjitter.count(), "/", stats.maxjitter.count(), " us");
+        });
     }
 
     bool sendcommand(const http::inputtype& in, http::outputtype& out) const
@@ -589,6 +1298,92 @@ struct Robot::Handler
         return httpIf->get(in, out);
     }
 
+    bool readfeedback(servofeedback_t& data) const
+    {
+        static const std::string json{command::getjson<command::Feedback>()};
+        thread_local std::string resp;
+        if (!httpIf->get(json, resp))
+        {
+            return false;
+        }
+        if (auto error = decode(resp, data); error != decodeerror::none)
+        {
+            log(logging::type::warning, [error](auto& str) {
+                append(str, "Cannot decode feedback, error: ",
+                       (int32_t)error);
+            });
+            return false;
+        }
+        shadow->confirm(data);
+        return true;
+    }
+
+    template <command::command C>
+    bool sendcommand(const C& cmd) const
+    {
+        thread_local command::Encoder encoder;
+        thread_local std::string json, resp;
+        json.assign(encoder.encode(cmd));
+        return httpIf->get(json, resp);
+    }
+
+    // failed command leaves unknown only the state it touches
+    void invalidate(const command::SetLed&) const
+    {
+        shadow->invalidate(shadowpart::led);
+    }
+
+    void invalidate(const command::Torque&) const
+    {
+        shadow->invalidate(shadowpart::torque);
+    }
+
+    void invalidate(const command::MoveJoint& cmd) const
+    {
+        // joints of command are numbered from one
+        shadow->invalidatejoint((size_t)cmd.joint - 1);
+    }
+
+    template <command::command C>
+    void invalidate(const C&) const
+    {
+        shadow->invalidate(shadowpart::joints);
+    }
+
+    // skipped command changes nothing, failed one leaves state unknown
+    template <command::command C>
+    void sendchanging(bool changing, const C& cmd) const
+    {
+        if (changing && !sendcommand(cmd))
+        {
+            invalidate(cmd);
+        }
+    }
+
+    // sent on ordered lane of channel, gives whether it succeeded
+    template <command::command C>
+    pollfunc sendqueued(bool changing, const C& cmd, uint32_t order) const
+    {
+        if (!changing)
+        {
+            return topoll(true);
+        }
+        auto sent = std::make_shared<std::future<response_t>>(
+            channel->send(command::tojson(cmd), order));
+        return [this, sent, cmd]() -> std::optional<bool> {
+            if (sent->wait_for(0s) != std::future_status::ready)
+            {
+                return std::nullopt;
+            }
+            if (!sent->get().ok)
+            {
+                invalidate(cmd);
+                return false;
+            }
+            return true;
+        };
+    }
+
     template <typename In = http::inputtype>
     std::string sendcommand(const In& in) const
     {
@@ -599,41 +1394,143 @@ struct Robot::Handler
 
     void speak(task what, bool async = true)
     {
-        if (ttsIf)
+        if (speech)
         {
-            if (async)
-            {
-                waitspeakdone();
-                ttsasync = std::async(std::launch::async, [this, what]() {
-                    auto inlang = std::get<0>(ttsIf->getvoice());
-                    ttsIf->speak(getttstext(what, inlang));
-                });
-            }
-            else
+            auto spoken = speech->push(gettext(what), speechpriority::status);
+            if (!async)
             {
-                waitspeakdone();
-                auto inlang = std::get<0>(ttsIf->getvoice());
-                ttsIf->speak(getttstext(what, inlang));
+                tracing::Span span("speech wait", "tts");
+                spoken.wait();
             }
         }
     }
 
+    std::future<bool> sing(task what)
+    {
+        if (speech)
+        {
+            return speech->push(gettext(what), speechpriority::song);
+        }
+        return {};
+    }
+
+    void hush()
+    {
+        if (speech)
+        {
+            speech->cancel(speechpriority::song);
+        }
+    }
+
     void waitspeakdone()
     {
-        if (ttsasync.valid())
+        if (speech)
         {
-            ttsasync.wait();
+            tracing::Span span("speech wait", "tts");
+            speech->wait();
         }
     }
 
-    std::string getstrfromhttp(const http::outputtype& out)
+    std::string gettext(task what) const
+    {
+        auto inlang = std::get<0>(ttsIf->getvoice());
+        return getttstext(what, inlang);
+    }
+
+    void logqueuestats()
+    {
+        static constexpr auto names =
+            std::to_array<const char*>({"lighting", "telemetry", "motion",
+                                        "sensing"});
+        std::ranges::for_each(workqueues, [this](const auto& config) {
+            auto stats = executor->getstats(config.name);
+            auto avglatency = stats.executed
+                                  ? stats.sumlatency / (int64_t)stats.executed
+                                  : 0us;
+            logtelemetry([name = names.at((size_t)config.name), stats,
+                          avglatency](auto& str) {
+                append(str, name, " queue executed: ", stats.executed,
+                       ", rejected: ", stats.rejected,
+                       ", max pending: ", stats.maxpending,
+                       ", latency avg/max: ", avglatency.count(), "/",
+                       stats.maxlatency.count(), " us");
+            });
+        });
+        logtelemetry([stats = calls->getstats()](auto& str) {
+            append(str, "Async calls started: ", stats.started,
+                   ", cancelled: ", stats.cancelled,
+                   ", rejected: ", stats.rejected,
+                   ", max pending: ", stats.maxpending);
+        });
+    }
+
+    // statistics are formatted and written in background to not delay
+    // behaviors, nothing is posted when they are not logged
+    template <typename F>
+    void logtelemetry(F&& format)
+    {
+        if (islogged(logging::type::debug))
+        {
+            post(workqueue::telemetry,
+                           [this, format = std::forward<F>(format)]() {
+                               log(logging::type::debug, format);
+                           });
+        }
+    }
+
+    void logspeechstats()
+    {
+        if (speech)
+        {
+            auto stats = speech->getstats();
+            auto avggap = stats.gaps ? stats.sumgap / (int64_t)stats.gaps : 0us;
+            logtelemetry([stats, avggap](auto& str) {
+                append(str, "Spoken utterances: ", stats.spoken,
+                       ", cancelled: ", stats.cancelled,
+                       ", preempted: ", stats.preempted,
+                       ", unprepared: ", stats.unprepared,
+                       ", gap avg/max: ", avggap.count(), "/",
+                       stats.maxgap.count(), " us");
+            });
+        }
+    }
+
+    void logschedulerstats()
+    {
+        auto stats = scheduler->getstats();
+        logtelemetry([stats](auto& str) {
+            append(str, "Behavior runs: ", stats.runs, ", instructions: ",
+                   stats.instructions, ", slices: ", stats.slices,
+                   ", max active: ", stats.maxactive);
+        });
+    }
+
+    void getstrfromhttp(const http::outputtype& out, std::string& str)
     {
-        std::string str;
         std::ranges::for_each(out, [&str](const auto& item) {
-            str += item.first + " : " +
-                   std::visit(HttoOutputVisitor(), item.second) + "\n";
+            append(str, item.first, " : ",
+                   std::visit(HttoOutputVisitor(), item.second), "\n");
+        });
+    }
+
+    void getstrfromfeedback(const servofeedback_t& data, std::string& str)
+    {
+        using field_t = std::pair<const char*, double servofeedback_t::*>;
+        static constexpr std::array<field_t, 11> fields{
+            {{"x", &servofeedback_t::x},
+             {"y", &servofeedback_t::y},
+             {"z", &servofeedback_t::z},
+             {"b", &servofeedback_t::b},
+             {"s", &servofeedback_t::s},
+             {"e", &servofeedback_t::e},
+             {"t", &servofeedback_t::t},
+             {"torB", &servofeedback_t::torb},
+             {"torS", &servofeedback_t::tors},
+             {"torE", &servofeedback_t::tore},
+             {"torH", &servofeedback_t::torh}}};
+        std::ranges::for_each(fields, [&str, &data](const auto& field) {
+            append(str, field.first, " : ", data.*(field.second), "\n");
         });
-        return str;
     }
 
     bool isposaccepted(int32_t present, int32_t expected) const
@@ -644,8 +1541,9 @@ struct Robot::Handler
 
 Robot::Robot(std::shared_ptr<http::HttpIf> httpIf,
              std::shared_ptr<tts::TextToVoiceIf> ttsIf,
-             std::shared_ptr<logging::LogIf> logIf) :
-    handler{std::make_unique<Handler>(httpIf, ttsIf, logIf)}
+             std::shared_ptr<logging::LogIf> logIf,
+             std::shared_ptr<Runtime> runtime) :
+    handler{std::make_unique<Handler>(httpIf, ttsIf, logIf, runtime)}
 {}
 
 Robot::~Robot() = default;
@@ -659,7 +1557,8 @@ bool Robot::readwifiinfo(bool isshown)
 {
     if (isshown)
         return true;
-    handler->log(logging::type::info, handler->getwifiinfo());
+    handler->log(logging::type::info,
+                 [this](auto& str) { handler->getwifiinfo(str); });
     return true;
 }
 
@@ -667,7 +1566,30 @@ bool Robot::readservosinfo(bool isshown)
 {
     if (isshown)
         return true;
-    handler->log(logging::type::info, handler->getservosinfo());
+    handler->log(logging::type::info,
+                 [this](auto& str) { handler->getservosinfo(str); });
+    return true;
+}
+
+bool Robot::readrequeststats(bool isshown)
+{
+    if (isshown)
+        return true;
+    handler->log(logging::type::info,
+                 [this](auto& str) { handler->getrequeststats(str); });
+    return true;
+}
+
+bool Robot::dumprequeststats(bool isshown)
+{
+    if (isshown)
+        return true;
+    if (!handler->dumprequeststats())
+    {
+        handler->log(logging::type::error,
+                     "Cannot store request stats in " +
+                         std::string{requeststatsfile});
+    }
     return true;
 }
 
@@ -689,7 +1611,8 @@ bool Robot::readdeviceinfo(bool isshown)
 {
     if (isshown)
         return true;
-    handler->log(logging::type::info, handler->getdeviceinfo());
+    handler->log(logging::type::info,
+                 [this](auto& str) { handler->getdeviceinfo(str); });
     return true;
 }
 
@@ -753,7 +1676,7 @@ bool Robot::shakehand(bool isshown)
 {
     if (isshown)
         return true;
-    handler->shakehand();
+    handler->shakehand({.interactive = true});
     return false;
 }
 
@@ -761,7 +1684,7 @@ bool Robot::dance(bool isshown)
 {
     if (isshown)
         return true;
-    handler->dance();
+    handler->dance({.interactive = true});
     return false;
 }
 
@@ -777,7 +1700,23 @@ bool Robot::enlight(bool isshown)
 {
     if (isshown)
         return true;
-    handler->enlight();
+    handler->enlight({.interactive = true});
+    return false;
+}
+
+bool Robot::teach(bool isshown)
+{
+    if (isshown)
+        return true;
+    handler->teach({.interactive = true});
+    return false;
+}
+
+bool Robot::replay(bool isshown, double scale)
+{
+    if (isshown)
+        return true;
+    handler->replay({.interactive = true}, scale);
     return false;
 }
 
@@ -833,4 +1772,53 @@ bool Robot::changelangtogerman(bool isshown)
     return false;
 }
 
+std::future<bool> Robot::openeoatasync(std::stop_token stoken,
+                                       progressfunc progress)
+{
+    return handler->runasync("openeoat", activity::gripper,
+                             {stoken, progress, false}, task::eoatopened);
+}
+
+std::future<bool> Robot::closeeoatasync(std::stop_token stoken,
+                                        progressfunc progress)
+{
+    return handler->runasync("closeeoat", activity::gripper,
+                             {stoken, progress, false}, task::eoatclosed);
+}
+
+std::future<bool> Robot::movebaseasync(std::stop_token stoken,
+                                       progressfunc progress)
+{
+    return handler->runasync("movebase", activity::other,
+                             {stoken, progress, false}, task::ready);
+}
+
+std::future<bool> Robot::moveparkedasync(std::stop_token stoken,
+                                         progressfunc progress)
+{
+    return handler->runasync("moveparked", activity::other,
+                             {stoken, progress, false}, task::parked);
+}
+
+std::future<bool> Robot::shakehandasync(std::stop_token stoken,
+                                        progressfunc progress)
+{
+    return handler->runasync("shakehand", activity::shakehand,
+                             {stoken, progress, false});
+}
+
+std::future<bool> Robot::danceasync(std::stop_token stoken,
+                                    progressfunc progress)
+{
+    return handler->runasync("dance", activity::dance,
+                             {stoken, progress, false});
+}
+
+std::future<bool> Robot::enlightasync(std::stop_token stoken,
+                                      progressfunc progress)
+{
+    return handler->runasync("enlight", activity::enlight,
+                             {stoken, progress, false});
+}
+
 } // namespace robot::roarmm2
@@ -0,0 +1,431 @@
+#include "robot/serial.hpp"
+
+#include "robot/commands.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace robot
+{
+
+static constexpr auto bauds = std::to_array<std::pair<uint32_t, speed_t>>(
+    {{9600, B9600},
+     {19200, B19200},
+     {38400, B38400},
+     {57600, B57600},
+     {115200, B115200},
+     {230400, B230400},
+     {460800, B460800},
+     {921600, B921600}});
+// longest line taken from arm, anything longer is noise on the line
+static constexpr size_t maxline = 4096;
+// commands answered by echo alone, nothing follows it to wait for
+static constexpr auto echoonly = std::to_array<int32_t>(
+    {roarmm2::command::MoveInit::type, roarmm2::command::MoveXYZT::type,
+     roarmm2::command::MoveXYZTDirect::type, roarmm2::command::SetLed::type,
+     roarmm2::command::MoveJoint::type, roarmm2::command::Torque::type});
+
+static speed_t getspeed(uint32_t baud)
+{
+    auto it = std::ranges::find_if(
+        bauds, [baud](const auto& entry) { return entry.first == baud; });
+    if (it == bauds.end())
+    {
+        throw std::runtime_error("Unsupported serial speed: " +
+                                 std::to_string(baud));
+    }
+    return it->second;
+}
+
+static void appendjson(std::string& json, const std::string& text)
+{
+    json += '"';
+    std::ranges::for_each(text, [&json](char c) {
+        if (c == '"' || c == '\\')
+        {
+            json += '\\';
+        }
+        json += c;
+    });
+    json += '"';
+}
+
+static bool isechoonly(std::string_view json)
+{
+    static constexpr std::string_view key{"\"T\":"};
+    auto pos = json.find(key);
+    if (pos == std::string_view::npos)
+    {
+        return false;
+    }
+    auto end = json.data() + json.size();
+    auto begin = std::find_if_not(
+        json.data() + pos + key.size(), end,
+        [](char c) { return std::isspace((unsigned char)c); });
+    int32_t type{};
+    auto [ptr, ec] = std::from_chars(begin, end, type);
+    return ec == std::errc{} &&
+           std::ranges::find(echoonly, type) != echoonly.end();
+}
+
+// commands are flat objects, so no general json library is needed
+static std::string encode(const http::inputtype& in)
+{
+    std::string json{"{"};
+    std::ranges::for_each(in, [&json](const auto& item) {
+        if (json.size() > 1)
+        {
+            json += ',';
+        }
+        appendjson(json, item.first);
+        json += ':';
+        std::visit(
+            [&json](const auto& value) {
+                using type = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<type, std::string>)
+                {
+                    appendjson(json, value);
+                }
+                else
+                {
+                    std::array<char, 32> digits;
+                    auto end = std::to_chars(digits.data(),
+                                             digits.data() + digits.size(),
+                                             value)
+                                   .ptr;
+                    json.append(digits.data(), end);
+                }
+            },
+            item.second);
+    });
+    return json += '}';
+}
+
+class Decoder
+{
+  public:
+    explicit Decoder(std::string_view json) : json{json}
+    {}
+
+    bool decode(http::outputtype& out)
+    {
+        if (!take('{'))
+        {
+            return false;
+        }
+        if (take('}'))
+        {
+            return true;
+        }
+        do
+        {
+            std::string key;
+            if (!getstring(key) || !take(':'))
+            {
+                return false;
+            }
+            if (!getvalue(out[key]))
+            {
+                return false;
+            }
+        } while (take(','));
+        return take('}');
+    }
+
+  private:
+    std::string_view json;
+    size_t pos{};
+
+    void skipspaces()
+    {
+        while (pos < json.size() && std::isspace((unsigned char)json[pos]))
+        {
+            pos++;
+        }
+    }
+
+    bool take(char c)
+    {
+        skipspaces();
+        if (pos < json.size() && json[pos] == c)
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool getstring(std::string& text)
+    {
+        if (!take('"'))
+        {
+            return false;
+        }
+        for (; pos < json.size(); pos++)
+        {
+            if (json[pos] == '"')
+            {
+                pos++;
+                return true;
+            }
+            if (json[pos] == '\\' && ++pos == json.size())
+            {
+                break;
+            }
+            text += json[pos];
+        }
+        return false;
+    }
+
+    bool getvalue(http::outputtype::mapped_type& value)
+    {
+        skipspaces();
+        if (pos < json.size() && json[pos] == '"')
+        {
+            std::string text;
+            value = text;
+            return getstring(std::get<std::string>(value));
+        }
+        // booleans are kept as numbers, as output holds no other type
+        static constexpr auto literals =
+            std::to_array<std::pair<std::string_view,
+                                    http::outputtype::mapped_type>>(
+                {{"null", std::monostate{}},
+                 {"true", int64_t{1}},
+                 {"false", int64_t{0}}});
+        for (const auto& [literal, literalvalue] : literals)
+        {
+            if (json.substr(pos).starts_with(literal))
+            {
+                pos += literal.size();
+                value = literalvalue;
+                return true;
+            }
+        }
+        auto begin = json.data() + pos, end = json.data() + json.size();
+        auto numend = std::find_if(begin, end, [](char c) {
+            return c == ',' || c == '}' || std::isspace((unsigned char)c);
+        });
+        if (std::string_view{begin, numend}.find_first_of(".eE") ==
+            std::string_view::npos)
+        {
+            int64_t number{};
+            auto [ptr, ec] = std::from_chars(begin, numend, number);
+            value = number;
+            pos += (size_t)(ptr - begin);
+            return ec == std::errc{} && ptr == numend;
+        }
+        double number{};
+        auto [ptr, ec] = std::from_chars(begin, numend, number);
+        value = number;
+        pos += (size_t)(ptr - begin);
+        return ec == std::errc{} && ptr == numend;
+    }
+};
+
+struct SerialHttp::Handler
+{
+  public:
+    Handler(const std::filesystem::path& device, const serialconfig_t& config) :
+        device{device}, config{config}
+    {
+        auto speed = getspeed(config.baud);
+        fd = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open serial device " +
+                                     device.string());
+        }
+        termios tty{};
+        if (::tcgetattr(fd, &tty))
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot read serial device settings");
+        }
+        ::cfmakeraw(&tty);
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cc[VMIN] = 0;
+        tty.c_cc[VTIME] = 0;
+        if (::cfsetispeed(&tty, speed) || ::cfsetospeed(&tty, speed) ||
+            ::tcsetattr(fd, TCSANOW, &tty))
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot configure serial device");
+        }
+        ::tcflush(fd, TCIOFLUSH);
+    }
+
+    ~Handler()
+    {
+        ::close(fd);
+    }
+
+    bool request(const std::string& json, std::string& resp)
+    {
+        using namespace std::chrono;
+        std::lock_guard lock(mtx);
+        // late answers to commands that timed out are not taken as response
+        received.clear();
+        ::tcflush(fd, TCIFLUSH);
+
+        auto deadline = steady_clock::now() + config.timeout;
+        if (!writeline(json, deadline))
+        {
+            return false;
+        }
+        bool echoed{};
+        const bool echoonly = isechoonly(json);
+        while (readline(line, deadline))
+        {
+            if (line != json)
+            {
+                resp.assign(line);
+                return true;
+            }
+            if (!echoed)
+            {
+                echoed = true;
+                resp.assign(line);
+                if (echoonly)
+                {
+                    return true;
+                }
+                deadline = std::min(deadline,
+                                    steady_clock::now() + config.replygap);
+            }
+        }
+        return echoed;
+    }
+
+    std::string info() const
+    {
+        return "serial " + device.string() + " at " +
+               std::to_string(config.baud);
+    }
+
+  private:
+    const std::filesystem::path device;
+    const serialconfig_t config;
+    int fd{-1};
+    std::mutex mtx;
+    std::string received;
+    std::string line;
+
+    bool wait(short events, std::chrono::steady_clock::time_point deadline)
+    {
+        using namespace std::chrono;
+        auto left = ceil<milliseconds>(deadline - steady_clock::now());
+        if (left <= left.zero())
+        {
+            return false;
+        }
+        pollfd pfd{fd, events, 0};
+        return ::poll(&pfd, 1, (int)left.count()) > 0 &&
+               (pfd.revents & events);
+    }
+
+    bool writeline(const std::string& json,
+                   std::chrono::steady_clock::time_point deadline)
+    {
+        line.assign(json) += '\n';
+        size_t written{};
+        while (written < line.size())
+        {
+            auto num =
+                ::write(fd, line.data() + written, line.size() - written);
+            if (num > 0)
+            {
+                written += (size_t)num;
+            }
+            else if ((num < 0 && errno != EAGAIN && errno != EINTR) ||
+                     !wait(POLLOUT, deadline))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readline(std::string& out,
+                  std::chrono::steady_clock::time_point deadline)
+    {
+        while (true)
+        {
+            if (auto end = received.find('\n'); end != std::string::npos)
+            {
+                out.assign(received, 0, end);
+                received.erase(0, end + 1);
+                if (!out.empty() && out.back() == '\r')
+                {
+                    out.pop_back();
+                }
+                if (!out.empty())
+                {
+                    return true;
+                }
+                continue;
+            }
+            if (received.size() > maxline)
+            {
+                received.clear();
+            }
+            if (!wait(POLLIN, deadline))
+            {
+                return false;
+            }
+            std::array<char, 256> chunk;
+            auto num = ::read(fd, chunk.data(), chunk.size());
+            if (num > 0)
+            {
+                received.append(chunk.data(), (size_t)num);
+            }
+            else if (num == 0 || (errno != EAGAIN && errno != EINTR))
+            {
+                return false;
+            }
+        }
+    }
+};
+
+SerialHttp::SerialHttp(const std::filesystem::path& device,
+                       const serialconfig_t& config) :
+    handler{std::make_unique<Handler>(device, config)}
+{}
+
+SerialHttp::~SerialHttp() = default;
+
+bool SerialHttp::get(const http::inputtype& in, http::outputtype& out)
+{
+    std::string resp;
+    return handler->request(encode(in), resp) && Decoder(resp).decode(out);
+}
+
+bool SerialHttp::get(const http::inputtype& in, std::string& resp)
+{
+    return handler->request(encode(in), resp);
+}
+
+bool SerialHttp::get(const std::string& json, std::string& resp)
+{
+    return handler->request(json, resp);
+}
+
+std::string SerialHttp::info()
+{
+    return handler->info();
+}
+
+} // namespace robot
@@ -0,0 +1,314 @@
+#include "robot/shadowstate.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace robot
+{
+
+struct ShadowState::Handler
+{
+  public:
+    Handler(double tolerance, std::chrono::milliseconds settle) :
+        tolerance{tolerance}, settle{settle}
+    {
+        if (tolerance <= 0. || settle.count() < 0)
+        {
+            throw std::runtime_error("Shadow state needs positive tolerance");
+        }
+    }
+
+    bool setled(uint8_t lvl)
+    {
+        std::lock_guard lock(mtx);
+        return update(led, lvl);
+    }
+
+    bool settorque(bool locked)
+    {
+        std::lock_guard lock(mtx);
+        if (!locked)
+        {
+            forgetjoints();
+        }
+        return update(torque, locked);
+    }
+
+    bool setjoints(const roarmm2::joints_t& angles)
+    {
+        std::lock_guard lock(mtx);
+        bool same{true};
+        for (size_t joint{}; joint < joints.size(); joint++)
+        {
+            same = same && isreached(joints[joint], angles[joint]);
+        }
+        if (same)
+        {
+            return elide();
+        }
+        assign(angles);
+        return send();
+    }
+
+    bool setjoint(size_t joint, double angle)
+    {
+        if (joint >= joints.size())
+        {
+            throw std::runtime_error("Joint not in arm");
+        }
+        std::lock_guard lock(mtx);
+        if (isreached(joints[joint], angle))
+        {
+            return elide();
+        }
+        assign(joint, istracked() ? std::optional{angle} : std::nullopt);
+        return send();
+    }
+
+    bool setpose(const waypoint_t& pose)
+    {
+        roarmm2::joints_t angles{};
+        if (roarmm2::inverse(pose, angles))
+        {
+            return setjoints(angles);
+        }
+        // pose out of reach, firmware decides what arm does
+        std::lock_guard lock(mtx);
+        forgetjoints();
+        return send();
+    }
+
+    void trackpose(const waypoint_t& pose)
+    {
+        roarmm2::joints_t angles{};
+        auto reachable = roarmm2::inverse(pose, angles);
+        std::lock_guard lock(mtx);
+        if (reachable)
+        {
+            assign(angles);
+        }
+        else
+        {
+            forgetjoints();
+        }
+        send();
+    }
+
+    void invalidate(shadowpart part)
+    {
+        std::lock_guard lock(mtx);
+        switch (part)
+        {
+            case shadowpart::led:
+                led.reset();
+                break;
+            case shadowpart::torque:
+                torque.reset();
+                break;
+            case shadowpart::joints:
+                forgetjoints();
+                break;
+        }
+    }
+
+    void invalidatejoint(size_t joint)
+    {
+        if (joint >= joints.size())
+        {
+            throw std::runtime_error("Joint not in arm");
+        }
+        std::lock_guard lock(mtx);
+        joints[joint].reset();
+    }
+
+    void confirm(const roarmm2::servofeedback_t& data)
+    {
+        const roarmm2::joints_t angles{data.b, data.s, data.e, data.t};
+        const auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(mtx);
+        for (size_t joint{}; joint < joints.size(); joint++)
+        {
+            auto& sample = samples[joint];
+            auto moved = sample.last ? std::abs(angles[joint] - *sample.last)
+                                     : std::numeric_limits<double>::max();
+            sample.last = angles[joint];
+            // joint still on its way is not compared, only settled one
+            auto settled = moved <= tolerance / 4 && now >= sample.since;
+            if (joints[joint] && settled &&
+                std::abs(*joints[joint] - angles[joint]) > tolerance)
+            {
+                joints[joint].reset();
+                stats.dropped++;
+            }
+        }
+    }
+
+    std::optional<uint8_t> getled() const
+    {
+        std::lock_guard lock(mtx);
+        return led;
+    }
+
+    shadowstats_t getstats() const
+    {
+        std::lock_guard lock(mtx);
+        return stats;
+    }
+
+  private:
+    // feedback of joint since it was last commanded
+    struct sample_t
+    {
+        std::chrono::steady_clock::time_point since;
+        std::optional<double> last;
+    };
+
+    const double tolerance;
+    const std::chrono::milliseconds settle;
+    mutable std::mutex mtx;
+    std::optional<uint8_t> led;
+    std::optional<bool> torque;
+    std::array<std::optional<double>, 4> joints;
+    std::array<sample_t, 4> samples;
+    shadowstats_t stats{};
+
+    template <typename T>
+    bool update(std::optional<T>& state, T value)
+    {
+        if (state == value)
+        {
+            return elide();
+        }
+        state = value;
+        return send();
+    }
+
+    bool isreached(const std::optional<double>& state, double angle) const
+    {
+        return state && std::abs(*state - angle) <= tolerance;
+    }
+
+    // unlocked arm can be moved by hand, so its joints are not tracked,
+    // motion may engage servos, so torque is unknown until commanded again
+    bool istracked()
+    {
+        if (torque == false)
+        {
+            torque.reset();
+            return false;
+        }
+        return true;
+    }
+
+    // commanded joint is compared with feedback once its move can settle
+    void assign(size_t joint, std::optional<double> angle)
+    {
+        joints[joint] = angle;
+        samples[joint] = {std::chrono::steady_clock::now() + settle, {}};
+    }
+
+    void assign(const roarmm2::joints_t& angles)
+    {
+        auto tracked = istracked();
+        for (size_t joint{}; joint < joints.size(); joint++)
+        {
+            assign(joint,
+                   tracked ? std::optional{angles[joint]} : std::nullopt);
+        }
+    }
+
+    void forgetjoints()
+    {
+        for (auto& joint : joints)
+        {
+            joint.reset();
+        }
+    }
+
+    bool elide()
+    {
+        stats.elided++;
+        return false;
+    }
+
+    bool send()
+    {
+        stats.sent++;
+        return true;
+    }
+};
+
+ShadowState::ShadowState(double tolerance,
+                         std::chrono::milliseconds settle) :
+    handler{std::make_unique<Handler>(tolerance, settle)}
+{}
+
+ShadowState::~ShadowState() = default;
+
+bool ShadowState::setled(uint8_t lvl)
+{
+    return handler->setled(lvl);
+}
+
+bool ShadowState::settorque(bool locked)
+{
+    return handler->settorque(locked);
+}
+
+bool ShadowState::setjoints(const roarmm2::joints_t& angles)
+{
+    return handler->setjoints(angles);
+}
+
+bool ShadowState::setjoint(size_t joint, double angle)
+{
+    return handler->setjoint(joint, angle);
+}
+
+bool ShadowState::setpose(const waypoint_t& pose)
+{
+    return handler->setpose(pose);
+}
+
+void ShadowState::trackpose(const waypoint_t& pose)
+{
+    handler->trackpose(pose);
+}
+
+void ShadowState::invalidate()
+{
+    handler->invalidate(shadowpart::led);
+    handler->invalidate(shadowpart::torque);
+    handler->invalidate(shadowpart::joints);
+}
+
+void ShadowState::invalidate(shadowpart part)
+{
+    handler->invalidate(part);
+}
+
+void ShadowState::invalidatejoint(size_t joint)
+{
+    handler->invalidatejoint(joint);
+}
+
+void ShadowState::confirm(const roarmm2::servofeedback_t& data)
+{
+    handler->confirm(data);
+}
+
+std::optional<uint8_t> ShadowState::getled() const
+{
+    return handler->getled();
+}
+
+shadowstats_t ShadowState::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -0,0 +1,390 @@
+#include "robot/speechcache.hpp"
+
+#include "robot/tracing.hpp"
+#include "robot/ttstexts.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+namespace robot
+{
+
+// file layout: magic, then entries of [keysize][audiosize][key][audio]
+static constexpr std::array<char, 8> magic{'R', 'O', 'B', 'T', 'T', 'S',
+                                           '0', '1'};
+
+struct entryheader_t
+{
+    uint32_t keysize;
+    uint32_t audiosize;
+};
+
+static std::string getkey(const phrase_t& phrase)
+{
+    const auto& [lang, gender, rate] = phrase.voice;
+    return std::to_string((int32_t)lang) + ":" +
+           std::to_string((int32_t)gender) + ":" + std::to_string(rate) +
+           ":" + phrase.text;
+}
+
+struct SpeechCache::Handler
+{
+  public:
+    Handler(const std::filesystem::path& path, synthfunc synth,
+            playfunc play) :
+        synth{synth},
+        play{play}
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open speech cache file");
+        }
+        if (getfilesize() == 0 &&
+            ::write(fd, magic.data(), magic.size()) != (ssize_t)magic.size())
+        {
+            ::close(fd);
+            throw std::runtime_error("Cannot initialize speech cache file");
+        }
+        remap();
+        if (mapping->size < magic.size() ||
+            std::memcmp(mapping->data, magic.data(), magic.size()))
+        {
+            ::close(fd);
+            throw std::runtime_error("Invalid speech cache file");
+        }
+        load();
+    }
+
+    ~Handler()
+    {
+        ::close(fd);
+    }
+
+    size_t fill(const std::vector<phrase_t>& phrases, uint32_t workers,
+                std::stop_token stoken)
+    {
+        std::atomic<size_t> next{}, added{};
+        auto worker = [this, &phrases, &next, &added, stoken]() {
+            std::vector<char> audio;
+            while (!stoken.stop_requested())
+            {
+                auto idx = next++;
+                if (idx >= phrases.size())
+                {
+                    break;
+                }
+                auto key = getkey(phrases[idx]);
+                if (contains(key))
+                {
+                    continue;
+                }
+                audio.clear();
+                if (synthesize(phrases[idx], audio) && store(key, audio))
+                {
+                    added++;
+                }
+            }
+        };
+        {
+            // calling thread is one of workers, so single one starts none
+            std::vector<std::jthread> pool;
+            for (uint32_t num{1}; num < workers; num++)
+            {
+                pool.emplace_back(worker);
+            }
+            worker();
+        }
+        return added;
+    }
+
+    bool contains(const std::string& key) const
+    {
+        std::lock_guard lock(mtx);
+        return index.contains(key);
+    }
+
+    bool speak(const phrase_t& phrase, std::stop_token stoken)
+    {
+        auto key = getkey(phrase);
+        // mapping is kept alive while playing even if cache grows meanwhile
+        auto [audio, keep] = find(key);
+        if (audio.empty())
+        {
+            countmiss();
+            std::vector<char> synthesized;
+            if (!synthesize(phrase, synthesized) || !store(key, synthesized))
+            {
+                return false;
+            }
+            std::tie(audio, keep) = find(key);
+        }
+        else
+        {
+            counthit();
+        }
+        tracing::Span span("playback", "tts");
+        return !audio.empty() && !stoken.stop_requested() &&
+               play(audio, stoken);
+    }
+
+    speechstats_t getstats() const
+    {
+        std::lock_guard lock(mtx);
+        return stats;
+    }
+
+  private:
+    struct mapping_t
+    {
+        char* data;
+        size_t size;
+
+        ~mapping_t()
+        {
+            ::munmap(data, size);
+        }
+    };
+
+    struct entry_t
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    const synthfunc synth;
+    const playfunc play;
+    int fd{-1};
+    mutable std::mutex mtx;
+    std::shared_ptr<const mapping_t> mapping;
+    std::unordered_map<std::string, entry_t> index;
+    speechstats_t stats{};
+
+    bool synthesize(const phrase_t& phrase, std::vector<char>& audio) const
+    {
+        tracing::Span span("synthesize", "tts");
+        return synth(phrase, audio);
+    }
+
+    void counthit()
+    {
+        std::lock_guard lock(mtx);
+        stats.hits++;
+    }
+
+    void countmiss()
+    {
+        std::lock_guard lock(mtx);
+        stats.misses++;
+    }
+
+    size_t getfilesize() const
+    {
+        struct stat info{};
+        ::fstat(fd, &info);
+        return (size_t)info.st_size;
+    }
+
+    void remap()
+    {
+        auto size = getfilesize();
+        auto* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map speech cache file");
+        }
+        mapping = std::make_shared<const mapping_t>((char*)data, size);
+    }
+
+    void load()
+    {
+        auto offset = magic.size();
+        while (offset + sizeof(entryheader_t) <= mapping->size)
+        {
+            entryheader_t header{};
+            std::memcpy(&header, mapping->data + offset, sizeof(header));
+            auto keyoffset = offset + sizeof(header);
+            auto audiooffset = keyoffset + header.keysize;
+            if (audiooffset + header.audiosize > mapping->size)
+            {
+                break;
+            }
+            index.insert_or_assign(
+                std::string{mapping->data + keyoffset, header.keysize},
+                entry_t{audiooffset, header.audiosize});
+            stats.bytes += header.audiosize;
+            offset = audiooffset + header.audiosize;
+        }
+        if (offset != mapping->size)
+        {
+            // entry written partially, interrupted while storing
+            ::ftruncate(fd, (off_t)offset);
+            remap();
+        }
+        stats.entries = index.size();
+    }
+
+    bool store(const std::string& key, const std::vector<char>& audio)
+    {
+        std::lock_guard lock(mtx);
+        if (index.contains(key))
+        {
+            return true;
+        }
+        auto offset = getfilesize();
+        entryheader_t header{(uint32_t)key.size(), (uint32_t)audio.size()};
+        std::vector<char> entry(sizeof(header) + key.size() + audio.size());
+        std::memcpy(entry.data(), &header, sizeof(header));
+        std::ranges::copy(key, entry.begin() + sizeof(header));
+        std::ranges::copy(audio, entry.begin() + (int64_t)sizeof(header) +
+                                     (int64_t)key.size());
+        if (::pwrite(fd, entry.data(), entry.size(), (off_t)offset) !=
+            (ssize_t)entry.size())
+        {
+            ::ftruncate(fd, (off_t)offset);
+            return false;
+        }
+        remap();
+        index.emplace(key, entry_t{offset + sizeof(header) + key.size(),
+                                   audio.size()});
+        stats.entries++;
+        stats.bytes += audio.size();
+        return true;
+    }
+
+    std::pair<std::span<const char>, std::shared_ptr<const mapping_t>>
+        find(const std::string& key) const
+    {
+        std::lock_guard lock(mtx);
+        if (auto it = index.find(key); it != index.end())
+        {
+            return {{mapping->data + it->second.offset, it->second.size},
+                    mapping};
+        }
+        return {};
+    }
+};
+
+SpeechCache::SpeechCache(const std::filesystem::path& path, synthfunc synth,
+                         playfunc play) :
+    handler{std::make_unique<Handler>(path, synth, play)}
+{}
+
+SpeechCache::~SpeechCache() = default;
+
+size_t SpeechCache::fill(const std::vector<phrase_t>& phrases,
+                         uint32_t workers, std::stop_token stoken)
+{
+    return handler->fill(phrases, workers, stoken);
+}
+
+bool SpeechCache::contains(const phrase_t& phrase) const
+{
+    return handler->contains(getkey(phrase));
+}
+
+bool SpeechCache::speak(const phrase_t& phrase, std::stop_token stoken)
+{
+    return handler->speak(phrase, stoken);
+}
+
+speechstats_t SpeechCache::getstats() const
+{
+    return handler->getstats();
+}
+
+CachedTextToVoice::CachedTextToVoice(
+    std::shared_ptr<tts::TextToVoiceIf> backend,
+    std::shared_ptr<SpeechCache> cache, uint32_t workers) :
+    backend{backend},
+    cache{cache}, workers{workers}
+{
+    if (!this->backend || !this->cache)
+    {
+        throw std::runtime_error("Cannot create cached text to voice");
+    }
+    prefill();
+}
+
+CachedTextToVoice::~CachedTextToVoice() = default;
+
+void CachedTextToVoice::speak(const std::string& text)
+{
+    std::stop_token stoken;
+    {
+        std::lock_guard lock(mtx);
+        playing = std::stop_source{};
+        stoken = playing.get_token();
+    }
+    if (cache->speak({text, backend->getvoice()}, stoken) ||
+        stoken.stop_requested())
+    {
+        return;
+    }
+    {
+        std::lock_guard lock(mtx);
+        fallback = true;
+    }
+    backend->speak(text);
+    std::lock_guard lock(mtx);
+    fallback = false;
+}
+
+void CachedTextToVoice::stop()
+{
+    std::lock_guard lock(mtx);
+    playing.request_stop();
+    if (fallback)
+    {
+        tts::TextToVoiceIf::kill();
+    }
+}
+
+tts::voice_t CachedTextToVoice::getvoice()
+{
+    return backend->getvoice();
+}
+
+void CachedTextToVoice::setvoice(const tts::voice_t& voice)
+{
+    backend->setvoice(voice);
+    prefill();
+}
+
+void CachedTextToVoice::prepare(const std::string& text)
+{
+    // synthesized by caller, being long lived preparer of speech queue
+    cache->fill({{text, backend->getvoice()}}, 1);
+}
+
+void CachedTextToVoice::prefill()
+{
+    // phrases catalog for current voice is synthesized in background,
+    // previous filling is cancelled on voice change
+    auto voice = backend->getvoice();
+    std::vector<phrase_t> phrases;
+    std::ranges::transform(getttstexts(std::get<tts::language>(voice)),
+                           std::back_inserter(phrases),
+                           [&voice](const auto& text) {
+                               return phrase_t{text, voice};
+                           });
+    prefiller = std::jthread(
+        [cache = cache, workers = workers,
+         phrases = std::move(phrases)](std::stop_token stoken) {
+            cache->fill(phrases, workers, stoken);
+        });
+}
+
+} // namespace robot
@@ -0,0 +1,228 @@
+#include "robot/speechqueue.hpp"
+
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <mutex>
+#include <thread>
+
+namespace robot
+{
+
+struct SpeechQueue::Handler
+{
+  public:
+    Handler(preparefunc prepare, speakfunc speak, stopfunc stop,
+            uint32_t lookahead) :
+        prepare{prepare},
+        speak{speak}, stop{stop}, lookahead{lookahead},
+        player{[this](std::stop_token stoken) { play(stoken); }},
+        preparer{[this](std::stop_token stoken) { preparenext(stoken); }}
+    {}
+
+    ~Handler()
+    {
+        player.request_stop();
+        preparer.request_stop();
+        player.join();
+        preparer.join();
+        std::ranges::for_each(
+            queue, [](auto& item) { item->done.set_value(false); });
+    }
+
+    std::future<bool> push(const std::string& text, speechpriority prio)
+    {
+        auto item = std::make_shared<item_t>();
+        item->text = text;
+        item->prio = prio;
+        item->queued = std::chrono::steady_clock::now();
+        auto future = item->done.get_future();
+        {
+            std::lock_guard lock(mtx);
+            auto it = std::ranges::find_if(queue, [prio](const auto& queued) {
+                return queued->prio < prio;
+            });
+            queue.insert(it, item);
+            if (current && current->prio < prio && !current->interrupted)
+            {
+                // stopped under lock, so only the preempted one is affected
+                current->interrupted = true;
+                stats.preempted++;
+                stop();
+            }
+        }
+        cv.notify_all();
+        return future;
+    }
+
+    void cancel(speechpriority prio)
+    {
+        {
+            std::lock_guard lock(mtx);
+            std::erase_if(queue, [this, prio](auto& item) {
+                if (item->prio <= prio)
+                {
+                    item->done.set_value(false);
+                    stats.cancelled++;
+                    return true;
+                }
+                return false;
+            });
+            if (current && current->prio <= prio && !current->interrupted)
+            {
+                current->interrupted = true;
+                stats.cancelled++;
+                stop();
+            }
+        }
+        cv.notify_all();
+    }
+
+    void wait()
+    {
+        std::unique_lock lock(mtx);
+        cv.wait(lock, [this]() { return queue.empty() && !current; });
+    }
+
+    speechqueuestats_t getstats() const
+    {
+        std::lock_guard lock(mtx);
+        return stats;
+    }
+
+  private:
+    struct item_t
+    {
+        std::string text;
+        speechpriority prio;
+        std::chrono::steady_clock::time_point queued;
+        std::promise<bool> done;
+        bool prepared{};
+        bool preparing{};
+        bool interrupted{};
+    };
+
+    const preparefunc prepare;
+    const speakfunc speak;
+    const stopfunc stop;
+    const uint32_t lookahead;
+    mutable std::mutex mtx;
+    std::condition_variable_any cv;
+    std::list<std::shared_ptr<item_t>> queue;
+    std::shared_ptr<item_t> current;
+    std::chrono::steady_clock::time_point lastend;
+    speechqueuestats_t stats{};
+    std::jthread player;
+    std::jthread preparer;
+
+    void play(std::stop_token stoken)
+    {
+        tracing::setthreadname("speech player");
+        using namespace std::chrono;
+        std::unique_lock lock(mtx);
+        while (cv.wait(lock, stoken, [this]() {
+            return !queue.empty() && !queue.front()->preparing;
+        }))
+        {
+            current = queue.front();
+            queue.pop_front();
+            auto start = steady_clock::now();
+            if (!current->prepared)
+            {
+                stats.unprepared++;
+            }
+            if (stats.spoken && current->queued <= lastend)
+            {
+                // utterance was waiting while previous one was playing
+                auto gap = duration_cast<microseconds>(start - lastend);
+                stats.gaps++;
+                stats.sumgap += gap;
+                stats.maxgap = std::max(stats.maxgap, gap);
+            }
+            lock.unlock();
+
+            bool ok{true};
+            try
+            {
+                speak(current->text);
+            }
+            catch (const std::exception&)
+            {
+                ok = false;
+            }
+
+            lock.lock();
+            lastend = steady_clock::now();
+            stats.spoken++;
+            current->done.set_value(ok && !current->interrupted);
+            current.reset();
+            cv.notify_all();
+        }
+    }
+
+    std::shared_ptr<item_t> getunprepared() const
+    {
+        auto end = std::next(queue.begin(),
+                             std::min<size_t>(lookahead, queue.size()));
+        auto it = std::find_if(queue.begin(), end, [](const auto& item) {
+            return !item->prepared && !item->preparing;
+        });
+        return it != end ? *it : nullptr;
+    }
+
+    void preparenext(std::stop_token stoken)
+    {
+        tracing::setthreadname("speech preparer");
+        std::unique_lock lock(mtx);
+        while (cv.wait(lock, stoken,
+                       [this]() { return (bool)getunprepared(); }))
+        {
+            auto item = getunprepared();
+            item->preparing = true;
+            lock.unlock();
+            try
+            {
+                prepare(item->text);
+            }
+            catch (const std::exception&)
+            {}
+            lock.lock();
+            item->preparing = false;
+            item->prepared = true;
+            cv.notify_all();
+        }
+    }
+};
+
+SpeechQueue::SpeechQueue(preparefunc prepare, speakfunc speak, stopfunc stop,
+                         uint32_t lookahead) :
+    handler{std::make_unique<Handler>(prepare, speak, stop, lookahead)}
+{}
+
+SpeechQueue::~SpeechQueue() = default;
+
+std::future<bool> SpeechQueue::push(const std::string& text,
+                                    speechpriority prio)
+{
+    return handler->push(text, prio);
+}
+
+void SpeechQueue::cancel(speechpriority prio)
+{
+    handler->cancel(prio);
+}
+
+void SpeechQueue::wait()
+{
+    handler->wait();
+}
+
+speechqueuestats_t SpeechQueue::getstats() const
+{
+    return handler->getstats();
+}
+
+} // namespace robot
@@ -0,0 +1,525 @@
+#include "robot/teach.hpp"
+
+#include "robot/tracing.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+using namespace std::chrono_literals;
+
+// file layout: magic, header, then deltas of every joint for each sample
+// after first one as zigzag varints
+static constexpr std::array<char, 8> magic{'R', 'O', 'B', 'T', 'R', 'J',
+                                           '0', '1'};
+// joint angles are stored as multiples of quantum in radians
+static constexpr double quantum = 1e-4;
+static constexpr size_t ringcapacity = 1024;
+static constexpr auto drainperiod = 100ms;
+static constexpr double minscale = 0.5;
+static constexpr double maxscale = 2.;
+
+using quantized_t = std::array<int32_t, 4>;
+
+struct recordheader_t
+{
+    uint32_t periodus;
+    uint32_t samples;
+    quantized_t first;
+};
+
+static quantized_t quantize(const roarmm2::joints_t& joints)
+{
+    quantized_t quantized{};
+    std::ranges::transform(joints, quantized.begin(), [](double angle) {
+        return (int32_t)std::lround(angle / quantum);
+    });
+    return quantized;
+}
+
+static roarmm2::joints_t dequantize(const quantized_t& quantized)
+{
+    roarmm2::joints_t joints{};
+    std::ranges::transform(quantized, joints.begin(), [](int32_t value) {
+        return (double)value * quantum;
+    });
+    return joints;
+}
+
+static void putvarint(std::vector<uint8_t>& out, int32_t delta)
+{
+    auto value = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool getvarint(std::span<const uint8_t> in, size_t& pos,
+                      int32_t& delta)
+{
+    uint32_t value{};
+    for (uint32_t shift{}; shift < 35 && pos < in.size(); shift += 7)
+    {
+        auto byte = in[pos++];
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+        {
+            delta = (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Recording::Handler
+{
+  public:
+    explicit Handler(std::chrono::microseconds period)
+    {
+        if (period.count() <= 0)
+        {
+            throw std::runtime_error("Cannot create recording");
+        }
+        header.periodus = (uint32_t)period.count();
+    }
+
+    explicit Handler(const std::filesystem::path& path)
+    {
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open recording " +
+                                     path.string());
+        }
+        struct stat info{};
+        ::fstat(fd, &info);
+        auto size = (size_t)info.st_size;
+        auto* data = size >= magic.size() + sizeof(header)
+                         ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                         : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map recording " + path.string());
+        }
+        mapped = data;
+        mapping = {(const uint8_t*)data, size};
+        if (std::memcmp(mapping.data(), magic.data(), magic.size()))
+        {
+            ::munmap(mapped, size);
+            throw std::runtime_error("Invalid recording " + path.string());
+        }
+        std::memcpy(&header, mapping.data() + magic.size(), sizeof(header));
+        last = header.first;
+    }
+
+    ~Handler()
+    {
+        if (mapped)
+        {
+            ::munmap(mapped, mapping.size());
+        }
+    }
+
+    void append(const roarmm2::joints_t& joints)
+    {
+        if (!mapping.empty())
+        {
+            throw std::runtime_error("Loaded recording cannot be extended");
+        }
+        auto quantized = quantize(joints);
+        if (!header.samples)
+        {
+            header.first = quantized;
+        }
+        else
+        {
+            for (size_t joint{}; joint < quantized.size(); joint++)
+            {
+                putvarint(deltas, quantized[joint] - last[joint]);
+            }
+        }
+        last = quantized;
+        header.samples++;
+    }
+
+    void save(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        auto body = getbody();
+        file.write(magic.data(), magic.size());
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)body.data(), (std::streamsize)body.size());
+        if (!file)
+        {
+            throw std::runtime_error("Cannot save recording " +
+                                     path.string());
+        }
+    }
+
+    std::chrono::microseconds period() const
+    {
+        return std::chrono::microseconds{header.periodus};
+    }
+
+    size_t size() const
+    {
+        return header.samples;
+    }
+
+    size_t bytes() const
+    {
+        return magic.size() + sizeof(header) + getbody().size();
+    }
+
+    std::vector<roarmm2::joints_t> decode() const
+    {
+        std::vector<roarmm2::joints_t> samples;
+        if (!header.samples)
+        {
+            return samples;
+        }
+        samples.reserve(header.samples);
+        auto body = getbody();
+        auto current = header.first;
+        samples.push_back(dequantize(current));
+        size_t pos{};
+        for (uint32_t num{1}; num < header.samples; num++)
+        {
+            for (auto& value : current)
+            {
+                int32_t delta{};
+                if (!getvarint(body, pos, delta))
+                {
+                    throw std::runtime_error("Recording is truncated");
+                }
+                value += delta;
+            }
+            samples.push_back(dequantize(current));
+        }
+        return samples;
+    }
+
+  private:
+    recordheader_t header{};
+    quantized_t last{};
+    std::vector<uint8_t> deltas;
+    void* mapped{};
+    std::span<const uint8_t> mapping;
+
+    std::span<const uint8_t> getbody() const
+    {
+        if (mapping.empty())
+        {
+            return deltas;
+        }
+        return mapping.subspan(magic.size() + sizeof(header));
+    }
+};
+
+Recording::Recording(std::chrono::microseconds period) :
+    handler{std::make_unique<Handler>(period)}
+{}
+
+Recording::Recording(const std::filesystem::path& path) :
+    handler{std::make_unique<Handler>(path)}
+{}
+
+Recording::Recording(Recording&&) noexcept = default;
+
+Recording& Recording::operator=(Recording&&) noexcept = default;
+
+Recording::~Recording() = default;
+
+void Recording::append(const roarmm2::joints_t& joints)
+{
+    handler->append(joints);
+}
+
+void Recording::save(const std::filesystem::path& path) const
+{
+    handler->save(path);
+}
+
+std::chrono::microseconds Recording::period() const
+{
+    return handler->period();
+}
+
+size_t Recording::size() const
+{
+    return handler->size();
+}
+
+size_t Recording::bytes() const
+{
+    return handler->bytes();
+}
+
+std::vector<roarmm2::joints_t> Recording::decode() const
+{
+    return handler->decode();
+}
+
+// Single producer, single consumer queue, sampler never blocks on it
+class SampleRing
+{
+  public:
+    bool push(const roarmm2::joints_t& joints)
+    {
+        auto head = next.load(std::memory_order_relaxed);
+        if (head - taken.load(std::memory_order_acquire) == ringcapacity)
+        {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        samples[head % ringcapacity] = joints;
+        next.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename F>
+    void drain(F&& consume)
+    {
+        auto tail = taken.load(std::memory_order_relaxed);
+        auto head = next.load(std::memory_order_acquire);
+        for (auto pos = tail; pos != head; pos++)
+        {
+            consume(samples[pos % ringcapacity]);
+        }
+        taken.store(head, std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> overruns{};
+
+  private:
+    std::array<roarmm2::joints_t, ringcapacity> samples;
+    std::atomic<size_t> next{};
+    std::atomic<size_t> taken{};
+};
+
+struct Recorder::Handler
+{
+  public:
+    Handler(readfunc read, std::chrono::milliseconds period) :
+        read{read}, period{period}
+    {
+        if (!read || period.count() <= 0)
+        {
+            throw std::runtime_error("Cannot create recorder");
+        }
+    }
+
+    ~Handler()
+    {
+        halt();
+    }
+
+    void start()
+    {
+        if (sampler.joinable())
+        {
+            throw std::runtime_error("Recording already in progress");
+        }
+        recording.emplace(period);
+        ring = std::make_unique<SampleRing>();
+        samples = 0;
+        missed = 0;
+        drainer = std::jthread([this](std::stop_token stoken) {
+            std::mutex mtx;
+            std::unique_lock lock(mtx);
+            while (!stoken.stop_requested())
+            {
+                std::condition_variable_any().wait_for(
+                    lock, stoken, drainperiod, []() { return false; });
+                drain();
+            }
+        });
+        sampler =
+            std::jthread([this](std::stop_token stoken) { sample(stoken); });
+    }
+
+    Recording stop()
+    {
+        if (!sampler.joinable())
+        {
+            throw std::runtime_error("No recording in progress");
+        }
+        halt();
+        drain();
+        auto result = std::move(*recording);
+        recording.reset();
+        return result;
+    }
+
+    teachstats_t getstats() const
+    {
+        return {samples.load(), missed.load(),
+                ring ? ring->overruns.load() : 0};
+    }
+
+  private:
+    const readfunc read;
+    const std::chrono::milliseconds period;
+    std::optional<Recording> recording;
+    std::unique_ptr<SampleRing> ring;
+    std::atomic<uint64_t> samples{};
+    std::atomic<uint64_t> missed{};
+    std::jthread sampler;
+    std::jthread drainer;
+
+    void halt()
+    {
+        // sampler goes first, so drainer takes everything it pushed
+        for (auto* thread : {&sampler, &drainer})
+        {
+            if (thread->joinable())
+            {
+                thread->request_stop();
+                thread->join();
+            }
+        }
+    }
+
+    void drain()
+    {
+        ring->drain([this](const auto& joints) { recording->append(joints); });
+    }
+
+    void sample(std::stop_token stoken)
+    {
+        using namespace std::chrono;
+        tracing::setthreadname("teach sampler");
+        std::mutex mtx;
+        std::unique_lock lock(mtx);
+        std::optional<roarmm2::joints_t> latest;
+        auto tick = steady_clock::now();
+        while (!stoken.stop_requested())
+        {
+            roarmm2::joints_t joints{};
+            if (read(joints))
+            {
+                latest = joints;
+            }
+            else
+            {
+                missed++;
+            }
+            // every period gets a sample, so recording keeps time,
+            // slots not read in time hold latest known joints
+            uint64_t slots{1};
+            tick += period;
+            if (auto now = steady_clock::now(); now > tick)
+            {
+                auto late = (uint64_t)((now - tick) / period) + 1;
+                missed += late;
+                slots += late;
+                tick += late * period;
+            }
+            for (; latest && slots; slots--)
+            {
+                if (ring->push(*latest))
+                {
+                    samples++;
+                }
+            }
+            std::condition_variable_any().wait_until(lock, stoken, tick,
+                                                     []() { return false; });
+        }
+    }
+};
+
+Recorder::Recorder(readfunc read, std::chrono::milliseconds period) :
+    handler{std::make_unique<Handler>(read, period)}
+{}
+
+Recorder::~Recorder() = default;
+
+void Recorder::start()
+{
+    handler->start();
+}
+
+Recording Recorder::stop()
+{
+    return handler->stop();
+}
+
+teachstats_t Recorder::getstats() const
+{
+    return handler->getstats();
+}
+
+std::vector<waypoint_t> resample(const Recording& recording,
+                                 std::chrono::milliseconds step, double scale)
+{
+    using namespace std::chrono;
+    if (scale < minscale || scale > maxscale || step.count() <= 0)
+    {
+        throw std::runtime_error("Cannot replay recording at given speed");
+    }
+    auto samples = recording.decode();
+    if (samples.empty())
+    {
+        throw std::runtime_error("Cannot replay empty recording");
+    }
+
+    const auto period = duration<double>(recording.period()).count();
+    const auto advance = duration<double>(step).count() * scale;
+    const auto total = period * (double)(samples.size() - 1);
+    roarmm2::jointbatch_t joints;
+    auto add = [&joints](const roarmm2::joints_t& sample) {
+        joints.base.push_back(sample[0]);
+        joints.shoulder.push_back(sample[1]);
+        joints.elbow.push_back(sample[2]);
+        joints.hand.push_back(sample[3]);
+    };
+    // last step is the final sample, time rounding must not add one more
+    const auto steps = (size_t)std::ceil(total / advance - 1e-9);
+    for (size_t num{}; num < steps; num++)
+    {
+        auto position = (double)num * advance / period;
+        auto idx = (size_t)position;
+        auto frac = position - (double)idx;
+        const auto& from = samples[idx];
+        const auto& to = samples[std::min(idx + 1, samples.size() - 1)];
+        roarmm2::joints_t sample{};
+        std::ranges::transform(from, to, sample.begin(),
+                               [frac](auto a, auto b) {
+                                   return a + (b - a) * frac;
+                               });
+        add(sample);
+    }
+    add(samples.back());
+
+    roarmm2::posebatch_t poses;
+    roarmm2::forward(joints, poses);
+    std::vector<waypoint_t> points(poses.x.size());
+    for (size_t num{}; num < points.size(); num++)
+    {
+        points[num] = {poses.x[num], poses.y[num], poses.z[num], poses.t[num]};
+    }
+    return points;
+}
+
+} // namespace robot
@@ -0,0 +1,252 @@
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace robot::tracing
+{
+
+using namespace std::chrono_literals;
+
+// events kept per thread between flushes, newer ones are dropped when full
+static constexpr size_t ringcapacity = 4096;
+static constexpr auto flushperiod = 100ms;
+
+struct event_t
+{
+    const char* name;
+    const char* category;
+    int64_t start;
+    int64_t duration;
+    int64_t arg;
+    bool hasarg;
+};
+
+// Single producer single consumer ring, filled by owning thread only
+class Ring
+{
+  public:
+    Ring(uint32_t tid, const std::string& name) : tid{tid}, name{name}
+    {}
+
+    void push(const event_t& event)
+    {
+        auto head = next.load(std::memory_order_relaxed);
+        if (head - taken.load(std::memory_order_acquire) == ringcapacity)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[head % ringcapacity] = event;
+        next.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename F>
+    size_t drain(F&& consume)
+    {
+        auto tail = taken.load(std::memory_order_relaxed);
+        auto head = next.load(std::memory_order_acquire);
+        for (auto pos = tail; pos != head; pos++)
+        {
+            consume(events[pos % ringcapacity]);
+        }
+        taken.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    const uint32_t tid;
+    const std::string name;
+    std::atomic<uint64_t> dropped{};
+
+  private:
+    std::array<event_t, ringcapacity> events;
+    std::atomic<size_t> next{};
+    std::atomic<size_t> taken{};
+};
+
+class Tracer
+{
+  public:
+    static Tracer& get()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    bool start(const std::filesystem::path& path)
+    {
+        std::lock_guard lock(mtx);
+        if (active)
+        {
+            return false;
+        }
+        file.open(path, std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        separator = "";
+        // leftovers of spans closed after previous stop are discarded
+        std::erase_if(rings, [](const auto& ring) {
+            ring->drain([](const auto&) {});
+            ring->dropped = 0;
+            return ring.use_count() == 1;
+        });
+        stats = {};
+        epoch = std::chrono::steady_clock::now();
+        active = true;
+        flusher = std::jthread([this](std::stop_token stoken) {
+            std::mutex waitmtx;
+            std::unique_lock waitlock(waitmtx);
+            while (!stoken.stop_requested())
+            {
+                std::condition_variable_any().wait_for(
+                    waitlock, stoken, flushperiod, []() { return false; });
+                std::lock_guard lock(mtx);
+                flush();
+            }
+        });
+        return true;
+    }
+
+    tracestats_t stop()
+    {
+        active = false;
+        if (flusher.joinable())
+        {
+            flusher.request_stop();
+            flusher.join();
+        }
+        std::lock_guard lock(mtx);
+        if (!file.is_open())
+        {
+            return {};
+        }
+        flush();
+        std::ranges::for_each(rings, [this](const auto& ring) {
+            stats.dropped += ring->dropped;
+            if (!ring->name.empty())
+            {
+                file << separator
+                     << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                        "\"tid\":"
+                     << ring->tid << ",\"args\":{\"name\":\"" << ring->name
+                     << "\"}}";
+                separator = ",\n";
+            }
+        });
+        file << "]}\n";
+        file.close();
+        return stats;
+    }
+
+    std::shared_ptr<Ring> addring(const std::string& name)
+    {
+        std::lock_guard lock(mtx);
+        auto ring = std::make_shared<Ring>(++tids, name);
+        rings.push_back(ring);
+        return ring;
+    }
+
+    std::chrono::steady_clock::time_point getepoch() const
+    {
+        return epoch.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::mutex mtx;
+    std::ofstream file;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::jthread flusher;
+    std::atomic<std::chrono::steady_clock::time_point> epoch;
+    uint32_t tids{};
+    std::string buffer;
+    const char* separator{""};
+    tracestats_t stats{};
+
+    void flush()
+    {
+        std::ranges::for_each(rings, [this](const auto& ring) {
+            stats.events += ring->drain([this, &ring](const auto& event) {
+                append(ring->tid, event);
+            });
+        });
+        file << buffer;
+        buffer.clear();
+    }
+
+    void append(uint32_t tid, const event_t& event)
+    {
+        buffer += separator;
+        buffer += "{\"name\":\"";
+        buffer += event.name;
+        buffer += "\",\"cat\":\"";
+        buffer += event.category;
+        buffer += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        appendnum(tid);
+        buffer += ",\"ts\":";
+        appendnum(event.start);
+        buffer += ",\"dur\":";
+        appendnum(event.duration);
+        if (event.hasarg)
+        {
+            buffer += ",\"args\":{\"value\":";
+            appendnum(event.arg);
+            buffer += '}';
+        }
+        buffer += '}';
+        separator = ",\n";
+    }
+
+    void appendnum(int64_t value)
+    {
+        std::array<char, 24> digits;
+        auto end = std::to_chars(digits.begin(), digits.end(), value).ptr;
+        buffer.append(digits.begin(), end);
+    }
+};
+
+static thread_local std::string threadname;
+
+bool start(const std::filesystem::path& path)
+{
+    return Tracer::get().start(path);
+}
+
+tracestats_t stop()
+{
+    return Tracer::get().stop();
+}
+
+void setthreadname(const std::string& name)
+{
+    threadname = name;
+}
+
+void record(const char* name, const char* category,
+            std::chrono::steady_clock::time_point start, int64_t arg,
+            bool hasarg)
+{
+    using namespace std::chrono;
+    if (!active.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    thread_local auto ring = Tracer::get().addring(threadname);
+    auto epoch = Tracer::get().getepoch();
+    auto now = steady_clock::now();
+    ring->push({name, category,
+                duration_cast<microseconds>(start - epoch).count(),
+                duration_cast<microseconds>(now - start).count(), arg,
+                hasarg});
+}
+
+} // namespace robot::tracing
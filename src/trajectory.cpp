@@ -0,0 +1,156 @@
+#include "robot/trajectory.hpp"
+
+#include "robot/requeststats.hpp"
+#include "robot/tracing.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace robot
+{
+
+Trajectory::Trajectory(const std::vector<waypoint_t>& waypoints,
+                       std::chrono::milliseconds segment,
+                       interpolation profile) :
+    waypoints{waypoints},
+    segment{segment}, profile{profile}
+{
+    if (waypoints.empty() || segment.count() <= 0)
+    {
+        throw std::runtime_error("Cannot create trajectory");
+    }
+}
+
+waypoint_t Trajectory::sample(std::chrono::duration<double> time) const
+{
+    if (time >= duration())
+    {
+        return waypoints.back();
+    }
+    auto progress = std::max(0., time / segment);
+    auto idx = (size_t)progress;
+    auto tau = progress - (double)idx;
+    // minimum jerk: 10t^3 - 15t^4 + 6t^5
+    auto shape = profile == interpolation::linear
+                     ? tau
+                     : tau * tau * tau * (10. + tau * (-15. + tau * 6.));
+
+    const auto& from = waypoints.at(idx);
+    const auto& to = waypoints.at(idx + 1);
+    waypoint_t point{};
+    std::ranges::transform(from, to, point.begin(), [shape](auto a, auto b) {
+        return a + (b - a) * shape;
+    });
+    return point;
+}
+
+std::chrono::milliseconds Trajectory::duration() const
+{
+    return segment * (int64_t)(waypoints.size() - 1);
+}
+
+struct Streamer::Handler
+{
+  public:
+    Handler(sendfunc send, std::chrono::milliseconds period) :
+        send{send}, period{period}, timer{[this](std::stop_token stoken) {
+            process(stoken);
+        }}
+    {}
+
+    ~Handler()
+    {
+        timer.request_stop();
+    }
+
+    std::future<streamstats_t> run(const Trajectory& trajectory,
+                                   std::stop_token stoken)
+    {
+        std::packaged_task<streamstats_t()> job(
+            withactivity([this, trajectory, stoken]() {
+                return stream(trajectory, stoken);
+            }));
+        auto result = job.get_future();
+        {
+            std::lock_guard lock(mtx);
+            jobs.push_back(std::move(job));
+        }
+        cv.notify_all();
+        return result;
+    }
+
+  private:
+    const sendfunc send;
+    const std::chrono::milliseconds period;
+    std::mutex mtx;
+    std::condition_variable_any cv;
+    std::deque<std::packaged_task<streamstats_t()>> jobs;
+    std::jthread timer;
+
+    void process(std::stop_token stoken)
+    {
+        tracing::setthreadname("streamer");
+        std::unique_lock lock(mtx);
+        while (cv.wait(lock, stoken, [this]() { return !jobs.empty(); }))
+        {
+            auto job = std::move(jobs.front());
+            jobs.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    streamstats_t stream(const Trajectory& trajectory, std::stop_token stoken)
+    {
+        using namespace std::chrono;
+        streamstats_t stats{};
+        const auto start = steady_clock::now();
+        const auto end = start + trajectory.duration();
+        auto tick = start;
+        while (!stoken.stop_requested())
+        {
+            std::this_thread::sleep_until(tick);
+            auto now = steady_clock::now();
+            auto jitter = duration_cast<microseconds>(now - tick);
+            stats.maxjitter = std::max(stats.maxjitter, jitter);
+            stats.sumjitter += jitter;
+
+            send(trajectory.sample(tick - start));
+            stats.setpoints++;
+            if (tick >= end)
+            {
+                break;
+            }
+
+            tick = std::min(tick + period, end);
+            now = steady_clock::now();
+            if (now > tick && tick < end)
+            {
+                // deadline missed, skip to the next achievable setpoint
+                auto missed = (now - tick) / period + 1;
+                stats.missed += (uint64_t)missed;
+                tick = std::min(tick + missed * period, end);
+            }
+        }
+        return stats;
+    }
+};
+
+Streamer::Streamer(sendfunc send, std::chrono::milliseconds period) :
+    handler{std::make_unique<Handler>(send, period)}
+{}
+
+Streamer::~Streamer() = default;
+
+std::future<streamstats_t> Streamer::run(const Trajectory& trajectory,
+                                         std::stop_token stoken)
+{
+    return handler->run(trajectory, stoken);
+}
+
+} // namespace robot
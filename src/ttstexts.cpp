@@ -1,7 +1,10 @@
 #include "robot/ttstexts.hpp"
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 namespace robot
 {
@@ -140,6 +143,18 @@ const std::unordered_map<task, langmap> ttstextmap = {
          {tts::language::english, "now I will talk in english"},
          {tts::language::german, "jetzt werde ich auf deutsch sprechen"},
      }},
+    {task::eoatopened,
+     {
+         {tts::language::polish, "chwytak otwarty"},
+         {tts::language::english, "gripper opened"},
+         {tts::language::german, "greifer geöffnet"},
+     }},
+    {task::eoatclosed,
+     {
+         {tts::language::polish, "chwytak zamknięty"},
+         {tts::language::english, "gripper closed"},
+         {tts::language::german, "greifer geschlossen"},
+     }},
     {task::nothingtodo,
      {
          {tts::language::polish, "nic nie trzeba robić"},
@@ -147,6 +162,31 @@ const std::unordered_map<task, langmap> ttstextmap = {
          {tts::language::german, "es gibt nichts zu tun"},
      }}};
 
+static constexpr std::array<std::pair<std::string_view, task>, 23> tasknames{
+    {{"initiatating", task::initiatating},
+     {"ready", task::ready},
+     {"parked", task::parked},
+     {"greetstart", task::greetstart},
+     {"greetshake", task::greetshake},
+     {"greetend", task::greetend},
+     {"greetfail", task::greetfail},
+     {"dancestart", task::dancestart},
+     {"songlinefirst", task::songlinefirst},
+     {"songlinesecond", task::songlinesecond},
+     {"songlinethird", task::songlinethird},
+     {"songlineforth", task::songlineforth},
+     {"danceend", task::danceend},
+     {"enlightstart", task::enlightstart},
+     {"enlightend", task::enlightend},
+     {"enlightbreak", task::enlightbreak},
+     {"voicechangestart", task::voicechangestart},
+     {"voicechangeend", task::voicechangeend},
+     {"langchangestart", task::langchangestart},
+     {"langchangeend", task::langchangeend},
+     {"eoatopened", task::eoatopened},
+     {"eoatclosed", task::eoatclosed},
+     {"nothingtodo", task::nothingtodo}}};
+
 std::string getttstext(task what, tts::language inlang)
 {
     if (ttstextmap.contains(what))
@@ -161,4 +201,27 @@ std::string getttstext(task what, tts::language inlang)
     throw std::runtime_error("Given task for TTS text not available");
 }
 
+std::vector<std::string> getttstexts(tts::language inlang)
+{
+    std::vector<std::string> texts;
+    std::ranges::for_each(ttstextmap, [inlang, &texts](const auto& item) {
+        if (item.second.contains(inlang))
+        {
+            texts.push_back(item.second.at(inlang));
+        }
+    });
+    return texts;
+}
+
+std::optional<task> gettask(std::string_view name)
+{
+    auto found = std::ranges::find(tasknames, name,
+                                   &std::pair<std::string_view, task>::first);
+    if (found != tasknames.end())
+    {
+        return found->second;
+    }
+    return std::nullopt;
+}
+
 } // namespace robot
@@ -23,3 +23,72 @@ EXTERNALPROJECT_ADD(
 include_directories(${source_dir}/googletest/include)
 include_directories(${source_dir}/googlemock/include)
 link_directories(${build_dir}/lib)
+
+set(source_dir "${CMAKE_BINARY_DIR}/libhttp-src")
+set(build_dir "${CMAKE_BINARY_DIR}/libhttp-build")
+
+# headers are shared with main project when built as its part
+if(NOT TARGET libhttp)
+  EXTERNALPROJECT_ADD(
+    libhttp
+    GIT_REPOSITORY    https://github.com/lukaskaz/lib-http.git
+    GIT_TAG           main
+    PATCH_COMMAND     ""
+    PREFIX            libhttp-workspace
+    SOURCE_DIR        ${source_dir}
+    BINARY_DIR        ${build_dir}
+    CONFIGURE_COMMAND ""
+    BUILD_COMMAND     ""
+    UPDATE_COMMAND    ""
+    INSTALL_COMMAND   ""
+    TEST_COMMAND      ""
+  )
+endif()
+
+include_directories(${source_dir}/inc)
+
+set(source_dir "${CMAKE_BINARY_DIR}/libtts-src")
+set(build_dir "${CMAKE_BINARY_DIR}/libtts-build")
+
+# headers are shared with main project when built as its part
+if(NOT TARGET libtts)
+  EXTERNALPROJECT_ADD(
+    libtts
+    GIT_REPOSITORY    https://github.com/lukaskaz/lib-tts.git
+    GIT_TAG           main
+    PATCH_COMMAND     ""
+    PREFIX            libtts-workspace
+    SOURCE_DIR        ${source_dir}
+    BINARY_DIR        ${build_dir}
+    CONFIGURE_COMMAND ""
+    BUILD_COMMAND     ""
+    UPDATE_COMMAND    ""
+    INSTALL_COMMAND   ""
+    TEST_COMMAND      ""
+  )
+endif()
+
+include_directories(${source_dir}/inc)
+
+set(source_dir "${CMAKE_BINARY_DIR}/liblogger-src")
+set(build_dir "${CMAKE_BINARY_DIR}/liblogger-build")
+
+# headers are shared with main project when built as its part
+if(NOT TARGET liblogger)
+  EXTERNALPROJECT_ADD(
+    liblogger
+    GIT_REPOSITORY    https://github.com/lukaskaz/lib-logger.git
+    GIT_TAG           main
+    PATCH_COMMAND     ""
+    PREFIX            liblogger-workspace
+    SOURCE_DIR        ${source_dir}
+    BINARY_DIR        ${build_dir}
+    CONFIGURE_COMMAND ""
+    BUILD_COMMAND     ""
+    UPDATE_COMMAND    ""
+    INSTALL_COMMAND   ""
+    TEST_COMMAND      ""
+  )
+endif()
+
+include_directories(${source_dir}/inc)
@@ -0,0 +1,328 @@
+#include "robot/behavior.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestBehavior : public testing::Test
+{
+  public:
+    // actions are called from scheduler thread only, events are read once
+    // behaviors are finished
+    std::vector<std::string> events;
+    std::atomic<bool> stopped{};
+    bool gripped{};
+
+    actions_t getactions()
+    {
+        return {.isstopped = [this]() { return stopped.load(); },
+                .move =
+                    [this](const waypoint_t& pose, uint32_t) {
+                        events.push_back("move " +
+                                         std::to_string((int32_t)pose[0]));
+                        return topoll(true);
+                    },
+                .glide =
+                    [this](const std::optional<waypoint_t>&,
+                           const waypoint_t& to, std::chrono::milliseconds,
+                           std::stop_token) {
+                        events.push_back("glide " +
+                                         std::to_string((int32_t)to[0]));
+                        return topoll(true);
+                    },
+                .base =
+                    [this]() {
+                        events.push_back("base");
+                        return topoll(true);
+                    },
+                .say =
+                    [this](task what) {
+                        events.push_back("say " +
+                                         std::to_string((int32_t)what));
+                        return topoll(true);
+                    },
+                .sing = [](task) { return topoll(true); },
+                .hush = []() {},
+                .light = [](effect_t) { return topoll(true); },
+                .lightwait = []() { return topoll(true); },
+                .arrival = [](const waypoint_t&) { return topoll(true); },
+                .hand = [](std::stop_token) { return topoll(true); },
+                .grip = [this](bool) { return topoll(gripped); }};
+    }
+
+    std::future<bool> run(std::string_view script, std::string_view name)
+    {
+        scheduler = std::make_unique<Scheduler>(
+            std::make_shared<Program>(script), 5ms);
+        return scheduler->run(name, getactions());
+    }
+
+    std::unique_ptr<Scheduler> scheduler;
+};
+
+TEST_F(TestBehavior, IsScriptCompiledIntoInstructions)
+{
+    Program program(R"(
+        behavior main   # comment
+            repeat 2
+                move 1 2 3 90 100
+            end
+            start other
+        end
+        behavior other
+            say ready
+        end)");
+    // repeat, move, next, start and finish of main, say and finish of other
+    EXPECT_EQ(program.size(), 7);
+    EXPECT_EQ(program.find("main"), 0);
+    EXPECT_EQ(program.find("other"), 5);
+    EXPECT_FALSE(program.find("missing"));
+    EXPECT_EQ(program.at(1).op, opcode::move);
+    EXPECT_EQ(program.at(1).args[3], 90);
+
+    EXPECT_THROW(Program("move 1 2 3 0"), std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n loop\n end"), std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n jump\n end"), std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n break\n end"), std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n say nobody\n end"),
+                 std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n start nobody\n end"),
+                 std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n move 1 2 x 0\n end"),
+                 std::runtime_error);
+    EXPECT_THROW(Program("behavior main\n choose\n loop\n end\n end\n end"),
+                 std::runtime_error);
+}
+
+TEST_F(TestBehavior, AreLoopsAndBranchesFollowed)
+{
+    auto done = run(R"(
+        behavior main
+            repeat 3
+                move 1 0 0 0
+            end
+            loop
+                move 2 0 0 0
+                break
+            end
+            grip close
+            if
+                say ready
+            else
+                say parked
+            end
+            ifnot
+                succeed
+            end
+            base
+        end)",
+                    "main");
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    EXPECT_TRUE(done.get());
+    EXPECT_EQ(events, (std::vector<std::string>{
+                          "move 1", "move 1", "move 1", "move 2",
+                          "say " + std::to_string((int32_t)task::parked),
+                          "base"}));
+}
+
+TEST_F(TestBehavior, IsChoiceNeverRepeated)
+{
+    auto done = run(R"(
+        behavior main
+            repeat 50
+                choose
+                    glide 1 0 0 0 10
+                    glide 2 0 0 0 10
+                    glide 3 0 0 0 10
+                end
+            end
+        end)",
+                    "main");
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    EXPECT_FALSE(done.get());
+    ASSERT_EQ(events.size(), 50);
+    for (size_t num{1}; num < events.size(); num++)
+    {
+        EXPECT_NE(events[num], events[num - 1]);
+    }
+}
+
+TEST_F(TestBehavior, AreBehaviorsRunConcurrently)
+{
+    static constexpr std::string_view script{R"(
+        behavior main
+            start ticker
+            wait 200
+            stop ticker
+            say ready
+            succeed
+        end
+        behavior ticker
+            loop
+                move 1 0 0 0
+                wait 20
+            end
+            move 2 0 0 0
+        end
+        behavior idle
+            wait 200
+            succeed
+        end)"};
+    auto started = std::chrono::steady_clock::now();
+    auto done = run(script, "main");
+    auto idle = scheduler->run("idle", getactions());
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    ASSERT_EQ(idle.wait_for(1s), std::future_status::ready);
+    EXPECT_TRUE(done.get());
+    EXPECT_TRUE(idle.get());
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 350ms);
+
+    // ticker ended before its parent went on
+    ASSERT_GE(events.size(), 3);
+    EXPECT_EQ(events.back(), "say " + std::to_string((int32_t)task::ready));
+    EXPECT_EQ(events[events.size() - 2], "move 2");
+    EXPECT_GT(events.size(), 5);
+    auto stats = scheduler->getstats();
+    EXPECT_EQ(stats.runs, 3);
+    EXPECT_EQ(stats.maxactive, 3);
+    EXPECT_THROW(scheduler->run("missing", getactions()), std::runtime_error);
+}
+
+TEST_F(TestBehavior, IsStoppedBehaviorCleaningUp)
+{
+    auto done = run(R"(
+        behavior main
+            loop
+                wait 10000
+            end
+            say danceend
+            succeed
+        end)",
+                    "main");
+    std::this_thread::sleep_for(50ms);
+    stopped = true;
+    ASSERT_EQ(done.wait_for(500ms), std::future_status::ready);
+    EXPECT_TRUE(done.get());
+    EXPECT_EQ(events, (std::vector<std::string>{
+                          "say " + std::to_string((int32_t)task::danceend)}));
+}
+
+TEST_F(TestBehavior, IsFailedActionEndingBehavior)
+{
+    scheduler =
+        std::make_unique<Scheduler>(std::make_shared<Program>(R"(
+            behavior main
+                grip open
+                succeed
+            end)"),
+                                    5ms);
+    auto actions = getactions();
+    actions.grip = [](bool) -> pollfunc {
+        return []() -> std::optional<bool> {
+            throw std::runtime_error("Cannot read feedback from robot");
+        };
+    };
+    auto done = scheduler->run("main", actions);
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    EXPECT_THROW(done.get(), std::runtime_error);
+}
+
+TEST_F(TestBehavior, IsLightWaitNeverHanging)
+{
+    scheduler =
+        std::make_unique<Scheduler>(std::make_shared<Program>(R"(
+            behavior endless
+                led pulse 0 100 100
+                ledwait
+                succeed
+            end
+            behavior main
+                led fade 0 100 100
+                ledwait
+                say danceend
+            end)"),
+                                    5ms);
+    auto actions = getactions();
+    // effect that never finishes
+    actions.lightwait = []() -> pollfunc {
+        return []() { return std::optional<bool>{}; };
+    };
+    auto endless = scheduler->run("endless", actions);
+    ASSERT_EQ(endless.wait_for(500ms), std::future_status::ready);
+    EXPECT_TRUE(endless.get());
+
+    auto done = scheduler->run("main", actions);
+    EXPECT_EQ(done.wait_for(50ms), std::future_status::timeout);
+    stopped = true;
+    ASSERT_EQ(done.wait_for(500ms), std::future_status::ready);
+    EXPECT_FALSE(done.get());
+    EXPECT_EQ(events, (std::vector<std::string>{
+                          "say " + std::to_string((int32_t)task::danceend)}));
+}
+
+TEST_F(TestBehavior, AreSlowActionsNotBlockingOthers)
+{
+    scheduler =
+        std::make_unique<Scheduler>(std::make_shared<Program>(R"(
+            behavior main
+                grip close
+                move 1 0 0 0
+                ifnot
+                    succeed
+                end
+            end
+            behavior other
+                wait 20
+                succeed
+            end)"),
+                                    5ms);
+    auto actions = getactions();
+    std::promise<bool> moved;
+    // failed move is not an outcome to branch on
+    actions.move = [&moved](const waypoint_t&, uint32_t) {
+        return topoll(moved.get_future());
+    };
+    gripped = true;
+    auto done = scheduler->run("main", actions);
+    auto other = scheduler->run("other", actions);
+    ASSERT_EQ(other.wait_for(500ms), std::future_status::ready);
+    EXPECT_TRUE(other.get());
+    EXPECT_EQ(done.wait_for(0ms), std::future_status::timeout);
+    moved.set_value(false);
+    ASSERT_EQ(done.wait_for(500ms), std::future_status::ready);
+    EXPECT_FALSE(done.get());
+}
+
+TEST_F(TestBehavior, AreAttachedFunctionsTickedUntilDone)
+{
+    scheduler = std::make_unique<Scheduler>(
+        std::make_shared<Program>("behavior main\n wait 30\n succeed\nend"),
+        5ms);
+    std::atomic<uint32_t> ticks{};
+    std::promise<void> detached;
+    // ticked without any behavior running and alongside one
+    scheduler->attach([&ticks, &detached]() {
+        if (++ticks < 20)
+        {
+            return true;
+        }
+        detached.set_value();
+        return false;
+    });
+    auto done = scheduler->run("main", getactions());
+    ASSERT_EQ(done.wait_for(500ms), std::future_status::ready);
+    EXPECT_TRUE(done.get());
+    ASSERT_EQ(detached.get_future().wait_for(500ms),
+              std::future_status::ready);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(ticks, 20u);
+}
@@ -0,0 +1,146 @@
+#include "robot/callqueue.hpp"
+
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestCallQueue : public testing::Test
+{
+  public:
+    static constexpr size_t depth = 2;
+    std::mutex mtx;
+    std::vector<CallQueue::tickfunc> attaching;
+    std::vector<uint32_t> started;
+
+    CallQueue queue{[this](CallQueue::tickfunc tick) {
+                        std::lock_guard lock(mtx);
+                        attaching.push_back(std::move(tick));
+                    },
+                    depth};
+
+    // stands in for scheduler thread, ticks may attach further ones
+    std::jthread ticker{[this](std::stop_token stoken) {
+        std::vector<CallQueue::tickfunc> ticks;
+        while (!stoken.stop_requested())
+        {
+            {
+                std::lock_guard lock(mtx);
+                std::ranges::move(attaching, std::back_inserter(ticks));
+                attaching.clear();
+            }
+            std::erase_if(ticks, [](const auto& tick) { return !tick(); });
+            std::this_thread::sleep_for(1ms);
+        }
+    }};
+
+    // call stays running until its promise is set
+    CallQueue::call_t getcall(uint32_t num, std::promise<bool>& running,
+                              std::stop_token stoken = {})
+    {
+        return {.start =
+                    [this, num, &running]() {
+                        std::lock_guard lock(mtx);
+                        started.push_back(num);
+                        return running.get_future();
+                    },
+                .isstopped = [stoken]() { return stoken.stop_requested(); }};
+    }
+
+    std::vector<uint32_t> getstarted()
+    {
+        std::lock_guard lock(mtx);
+        return started;
+    }
+};
+
+TEST_F(TestCallQueue, AreCallsRunOneAfterAnother)
+{
+    std::promise<bool> first, second;
+    auto firstdone = queue.push(getcall(1, first));
+    auto seconddone = queue.push(getcall(2, second));
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(getstarted(), std::vector<uint32_t>{1});
+
+    first.set_value(true);
+    EXPECT_TRUE(firstdone.get());
+    while (getstarted().size() < 2)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    second.set_value(false);
+    EXPECT_FALSE(seconddone.get());
+    EXPECT_EQ(getstarted(), (std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ(queue.getstats().started, 2u);
+}
+
+TEST_F(TestCallQueue, IsStoppedCallNotStarted)
+{
+    std::promise<bool> first, second;
+    std::stop_source stop;
+    auto firstdone = queue.push(getcall(1, first));
+    auto seconddone = queue.push(getcall(2, second, stop.get_token()));
+    stop.request_stop();
+    first.set_value(true);
+
+    EXPECT_TRUE(firstdone.get());
+    EXPECT_FALSE(seconddone.get());
+    EXPECT_EQ(getstarted(), std::vector<uint32_t>{1});
+    EXPECT_EQ(queue.getstats().cancelled, 1u);
+}
+
+TEST_F(TestCallQueue, IsOutcomeFinishedBeforeResult)
+{
+    std::promise<bool> running;
+    std::vector<bool> finished;
+    auto call = getcall(1, running);
+    call.finish = [&finished](bool succeeded) {
+        finished.push_back(succeeded);
+    };
+    auto done = queue.push(std::move(call));
+    running.set_value(true);
+
+    EXPECT_TRUE(done.get());
+    EXPECT_EQ(finished, std::vector<bool>{true});
+}
+
+TEST_F(TestCallQueue, IsOverflowingCallRejected)
+{
+    std::promise<bool> running;
+    std::vector<std::promise<bool>> waiting(depth + 1);
+    auto done = queue.push(getcall(0, running));
+    while (getstarted().empty())
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    std::vector<std::future<bool>> results;
+    for (uint32_t num{}; num < waiting.size(); num++)
+    {
+        results.push_back(queue.push(getcall(num + 1, waiting[num])));
+    }
+    EXPECT_THROW(results.back().get(), std::runtime_error);
+
+    running.set_value(true);
+    for (uint32_t num{}; num < depth; num++)
+    {
+        while (getstarted().size() < num + 2)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        waiting[num].set_value(true);
+        EXPECT_TRUE(results[num].get());
+    }
+    EXPECT_TRUE(done.get());
+    auto stats = queue.getstats();
+    EXPECT_EQ(stats.rejected, 1u);
+    EXPECT_EQ(stats.maxpending, depth);
+}
@@ -0,0 +1,114 @@
+#include "robot/choreography.hpp"
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestChoreography : public testing::Test
+{
+  public:
+    // round trip of command for each arm, slow arm lags 40 ms one way,
+    // speech takes longer to start than commands
+    static constexpr std::array<std::chrono::milliseconds, 2> roundtrips{
+        10ms, 90ms};
+    static constexpr auto speechdelay = 100ms;
+    const cue_t probe{0ms, 0, cuetype::motion, "{\"T\":105}"};
+
+    Choreography::dispatchfunc dispatch = [](const cue_t& cue) {
+        std::this_thread::sleep_for(
+            roundtrips.at(cue.arm) +
+            (cue.type == cuetype::speech ? speechdelay : 0ms));
+        return cue.payload != "fail";
+    };
+
+    std::vector<cue_t> gettimeline() const
+    {
+        std::vector<cue_t> timeline;
+        for (auto at : {0ms, 150ms, 300ms})
+        {
+            for (size_t arm{}; arm < roundtrips.size(); arm++)
+            {
+                timeline.push_back({at, arm, cuetype::motion, "{\"T\":104}"});
+            }
+        }
+        return timeline;
+    }
+};
+
+TEST_F(TestChoreography, IsLatencyMeasured)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    choreography.calibrate(probe, 3);
+    EXPECT_NEAR((double)choreography.getlatency(0, cuetype::motion).count(),
+                5000, 2000);
+    EXPECT_NEAR((double)choreography.getlatency(1, cuetype::motion).count(),
+                45000, 5000);
+    EXPECT_EQ(choreography.getlatency(0, cuetype::speech), 0us);
+}
+
+TEST_F(TestChoreography, AreCueTypesPlayedIndependently)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    choreography.calibrate(probe, 3);
+    choreography.calibrate({0ms, 0, cuetype::speech, "hello"}, 3);
+    // motion cue is due while speech of the same arm is still dispatched
+    auto report =
+        choreography.run({{0ms, 0, cuetype::speech, "hello"},
+                          {20ms, 0, cuetype::motion, "{\"T\":104}"}});
+    EXPECT_EQ(report.arms[0].cues, 2);
+    EXPECT_LT(report.arms[0].maxskew, 15ms);
+    EXPECT_GT(report.arms[0].latencies[(size_t)cuetype::speech],
+              report.arms[0].latencies[(size_t)cuetype::motion]);
+}
+
+TEST_F(TestChoreography, AreArmsAligned)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    choreography.calibrate(probe, 3);
+    auto report = choreography.run(gettimeline());
+    ASSERT_EQ(report.arms.size(), roundtrips.size());
+    for (const auto& arm : report.arms)
+    {
+        EXPECT_EQ(arm.cues, 3);
+        EXPECT_EQ(arm.failed, 0);
+        EXPECT_LT(arm.maxskew, 15ms);
+    }
+    EXPECT_LT(report.maxspread, 20ms);
+}
+
+TEST_F(TestChoreography, IsFailedCueReported)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    auto timeline = gettimeline();
+    timeline.push_back({200ms, 0, cuetype::speech, "fail"});
+    auto report = choreography.run(timeline);
+    EXPECT_EQ(report.arms[0].cues, 4);
+    EXPECT_EQ(report.arms[0].failed, 1);
+    EXPECT_EQ(report.arms[1].failed, 0);
+}
+
+TEST_F(TestChoreography, IsShowStopped)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    std::stop_source stop;
+    std::jthread stopper([&stop]() {
+        std::this_thread::sleep_for(200ms);
+        stop.request_stop();
+    });
+    auto report = choreography.run(gettimeline(), stop.get_token());
+    EXPECT_LT(report.arms[0].cues, 3);
+}
+
+TEST_F(TestChoreography, IsCueForUnknownArmRejected)
+{
+    Choreography choreography(dispatch, roundtrips.size());
+    EXPECT_THROW(choreography.run({{0ms, 2, cuetype::led, "{}"}}),
+                 std::runtime_error);
+}
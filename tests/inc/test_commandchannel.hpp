@@ -0,0 +1,122 @@
+#include "robot/commandchannel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Stand-in for robot http endpoint, answers after fixed latency
+class HttpStandIn : public http::HttpIf
+{
+  public:
+    explicit HttpStandIn(std::chrono::milliseconds latency) : latency{latency}
+    {}
+
+    bool get(const http::inputtype&, http::outputtype&) override
+    {
+        std::this_thread::sleep_for(latency);
+        return true;
+    }
+
+    bool get(const http::inputtype& in, std::string& out) override
+    {
+        std::this_thread::sleep_for(latency);
+        std::lock_guard lock(mtx);
+        received.push_back(std::get<int32_t>(in.at("seq")));
+        out = "{}";
+        return true;
+    }
+
+    bool get(const std::string&, std::string& out) override
+    {
+        std::this_thread::sleep_for(latency);
+        out = "{}";
+        return true;
+    }
+
+    std::string info() override
+    {
+        return "stand-in";
+    }
+
+    std::vector<int32_t> getreceived()
+    {
+        std::lock_guard lock(mtx);
+        return received;
+    }
+
+  private:
+    const std::chrono::milliseconds latency;
+    std::mutex mtx;
+    std::vector<int32_t> received;
+};
+
+class TestCommandChannel : public testing::Test
+{
+  public:
+    static constexpr int32_t commands{40};
+    static constexpr auto latency = std::chrono::milliseconds(5);
+    std::shared_ptr<HttpStandIn> standin{
+        std::make_shared<HttpStandIn>(latency)};
+
+    template <typename F>
+    std::chrono::milliseconds measure(F&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+};
+
+TEST_F(TestCommandChannel, IsOrderPreservedForSameKey)
+{
+    robot::CommandChannel channel(standin, 4);
+    for (int32_t seq{}; seq < commands; seq++)
+    {
+        channel.send({{"T", 114}, {"seq", seq}}, 1, nullptr);
+    }
+    channel.flush();
+
+    auto received = standin->getreceived();
+    ASSERT_EQ(received.size(), (size_t)commands);
+    EXPECT_TRUE(std::ranges::is_sorted(received));
+}
+
+TEST_F(TestCommandChannel, IsResponseDeliveredByFuture)
+{
+    robot::CommandChannel channel(standin, 2);
+    auto resp = channel.send({{"T", 105}, {"seq", 0}}).get();
+    EXPECT_TRUE(resp.ok);
+    EXPECT_EQ(resp.body, "{}");
+}
+
+TEST_F(TestCommandChannel, IsPipelinedFasterThanSerial)
+{
+    auto serial = measure([this]() {
+        for (int32_t seq{}; seq < commands; seq++)
+        {
+            std::string resp;
+            standin->get({{"T", 114}, {"seq", seq}}, resp);
+        }
+    });
+
+    robot::CommandChannel channel(standin, 4);
+    std::vector<std::future<robot::response_t>> responses;
+    auto pipelined = measure([&]() {
+        for (int32_t seq{}; seq < commands; seq++)
+        {
+            responses.push_back(channel.send({{"T", 114}, {"seq", seq}}));
+        }
+        std::ranges::for_each(responses, [](auto& resp) { resp.wait(); });
+    });
+
+    std::cout << "[ INFO     ] " << commands << " commands, serial "
+              << serial.count() << " ms, pipelined " << pipelined.count()
+              << " ms\n";
+    EXPECT_LT(pipelined * 2, serial);
+}
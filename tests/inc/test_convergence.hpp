@@ -0,0 +1,109 @@
+#include "robot/convergence.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestConvergence : public testing::Test
+{
+  public:
+    static constexpr convparams_t params{.deadline = 500ms,
+                                         .margin = 2.,
+                                         .mininterval = 5ms,
+                                         .maxinterval = 20ms,
+                                         .backoff = 1.5,
+                                         .stallvelocity = 5.,
+                                         .stallsamples = 3,
+                                         .startgrace = 0ms};
+    const std::chrono::steady_clock::time_point start{
+        std::chrono::steady_clock::now()};
+
+    // position moving with given speed per second until it stops at end,
+    // arm may start moving only after delay
+    double travel(double speed, double end,
+                  std::chrono::milliseconds delay = {}) const
+    {
+        auto elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start - delay)
+                           .count();
+        return std::clamp(speed * elapsed, 0., end);
+    }
+};
+
+TEST_F(TestConvergence, IsSetpointReached)
+{
+    auto result = waitconverged([this]() { return travel(1000., 100.); },
+                                100., params);
+    EXPECT_EQ(result.status, convergence::reached);
+    EXPECT_EQ(result.position, 100.);
+    EXPECT_GE(result.elapsed, 90ms);
+    EXPECT_LT(result.elapsed, 300ms);
+    EXPECT_GT(result.polls, 1);
+}
+
+TEST_F(TestConvergence, IsPositionWithinMarginAccepted)
+{
+    auto result = waitconverged([this]() { return travel(1000., 99.); },
+                                100., params);
+    EXPECT_EQ(result.status, convergence::withinmargin);
+    EXPECT_EQ(result.position, 99.);
+}
+
+TEST_F(TestConvergence, IsStalledMovementReported)
+{
+    auto result = waitconverged([this]() { return travel(1000., 50.); },
+                                100., params);
+    EXPECT_EQ(result.status, convergence::stalled);
+    EXPECT_EQ(result.position, 50.);
+    EXPECT_LT(result.elapsed, params.deadline);
+}
+
+TEST_F(TestConvergence, IsDeadlineKept)
+{
+    // still moving, but too slowly to arrive in time
+    auto result = waitconverged([this]() { return travel(100., 100.); },
+                                100., params);
+    EXPECT_EQ(result.status, convergence::timedout);
+    EXPECT_LT(result.position, 100.);
+    EXPECT_GE(result.elapsed, params.deadline);
+    EXPECT_LT(result.elapsed, params.deadline + 50ms);
+}
+
+TEST_F(TestConvergence, IsLateStartNotTakenAsStall)
+{
+    // command queued behind others, arm stands still before it moves
+    auto late = [this]() { return travel(1000., 100., 150ms); };
+    auto stalled = waitconverged(late, 100., params);
+    EXPECT_EQ(stalled.status, convergence::stalled);
+    EXPECT_LT(stalled.elapsed, 150ms);
+
+    auto graced = params;
+    graced.startgrace = 300ms;
+    auto result = waitconverged(late, 100., graced);
+    EXPECT_EQ(result.status, convergence::reached);
+    EXPECT_EQ(result.position, 100.);
+    EXPECT_GT(result.elapsed, 100ms);
+}
+
+TEST_F(TestConvergence, IsStallReportedAfterMotionOrGrace)
+{
+    auto graced = params;
+    graced.startgrace = graced.deadline;
+    // arm that moved and got stuck is stalled without waiting for grace
+    auto stuck = waitconverged([this]() { return travel(1000., 50.); }, 100.,
+                               graced);
+    EXPECT_EQ(stuck.status, convergence::stalled);
+    EXPECT_EQ(stuck.position, 50.);
+    EXPECT_LT(stuck.elapsed, graced.deadline);
+
+    // arm never moving is stalled once grace is over
+    graced.startgrace = 100ms;
+    auto still = waitconverged([]() { return 0.; }, 100., graced);
+    EXPECT_EQ(still.status, convergence::stalled);
+    EXPECT_GE(still.elapsed, graced.startgrace);
+    EXPECT_LT(still.elapsed, graced.deadline);
+}
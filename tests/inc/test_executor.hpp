@@ -0,0 +1,94 @@
+#include "robot/executor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestExecutor : public testing::Test
+{
+  public:
+    static constexpr std::array<queueconfig_t, 2> configs{
+        {{.name = workqueue::motion, .workers = 1, .depth = 2},
+         {.name = workqueue::telemetry, .workers = 4, .depth = 16}}};
+};
+
+TEST_F(TestExecutor, AreJobsOfSingleWorkerExecutedInOrder)
+{
+    Executor executor(configs);
+    std::vector<uint32_t> order;
+    std::vector<std::future<void>> jobs;
+    for (uint32_t num{}; num < 2; num++)
+    {
+        jobs.push_back(executor.submit(workqueue::motion, [&order, num]() {
+            std::this_thread::sleep_for(10ms);
+            order.push_back(num);
+        }));
+    }
+    std::ranges::for_each(jobs, [](auto& job) { job.get(); });
+    EXPECT_EQ(order, (std::vector<uint32_t>{0, 1}));
+}
+
+TEST_F(TestExecutor, IsResultReturned)
+{
+    Executor executor(configs);
+    auto result = executor.submit(workqueue::motion, []() { return 42; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST_F(TestExecutor, IsJobOverDepthRejected)
+{
+    Executor executor(configs);
+    std::promise<void> release;
+    auto blocker = release.get_future().share();
+    auto running = executor.submit(workqueue::motion,
+                                   [blocker]() { blocker.wait(); });
+    while (executor.getstats(workqueue::motion).executed == 0)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    auto first = executor.submit(workqueue::motion, []() {});
+    auto second = executor.submit(workqueue::motion, []() {});
+    auto rejected = executor.submit(workqueue::motion, []() {});
+    EXPECT_THROW(rejected.get(), std::runtime_error);
+    EXPECT_FALSE(executor.post(workqueue::motion, []() {}));
+
+    release.set_value();
+    EXPECT_NO_THROW(first.get());
+    EXPECT_NO_THROW(second.get());
+    auto stats = executor.getstats(workqueue::motion);
+    EXPECT_EQ(stats.executed, 3);
+    EXPECT_EQ(stats.rejected, 2);
+    EXPECT_EQ(stats.maxpending, 2);
+    EXPECT_GE(stats.maxlatency, stats.sumlatency / 3);
+}
+
+TEST_F(TestExecutor, AreJobsSpreadOverWorkers)
+{
+    Executor executor(configs);
+    std::vector<std::future<void>> jobs;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t num{}; num < 4; num++)
+    {
+        jobs.push_back(executor.submit(
+            workqueue::telemetry, []() { std::this_thread::sleep_for(50ms); }));
+    }
+    std::ranges::for_each(jobs, [](auto& job) { job.get(); });
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+}
+
+TEST_F(TestExecutor, IsUnknownQueueRejected)
+{
+    Executor executor(configs);
+    EXPECT_FALSE(executor.post(workqueue::sensing, []() {}));
+    EXPECT_THROW(executor.submit(workqueue::lighting, []() {}).get(),
+                 std::runtime_error);
+}
@@ -0,0 +1,99 @@
+#include "robot/feedback.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestFeedback : public testing::Test
+{
+  public:
+    std::atomic<uint32_t> reads{};
+    std::atomic<bool> failing{};
+
+    Feedback feedback{[this](roarmm2::servofeedback_t& data) {
+                          data.x = (double)++reads;
+                          return !failing.load();
+                      },
+                      10ms};
+};
+
+TEST_F(TestFeedback, IsFreshSnapshotShared)
+{
+    auto first = feedback.get(0ms);
+    ASSERT_TRUE(first);
+    auto shared = feedback.get(100ms);
+    ASSERT_TRUE(shared);
+    EXPECT_EQ(shared->version, first->version);
+    EXPECT_EQ(shared.get(), first.get());
+
+    std::this_thread::sleep_for(15ms);
+    auto fresh = feedback.get(0ms);
+    ASSERT_TRUE(fresh);
+    EXPECT_GT(fresh->version, first->version);
+    EXPECT_GT(fresh->data.x, first->data.x);
+    EXPECT_EQ(feedback.getlatest()->version, fresh->version);
+}
+
+TEST_F(TestFeedback, IsPollerIdleWithoutReaders)
+{
+    ASSERT_TRUE(feedback.get(0ms));
+    auto idle = reads.load();
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(reads.load(), idle);
+
+    // waiting reader wakes it up
+    auto woken = feedback.get(0ms);
+    ASSERT_TRUE(woken);
+    EXPECT_GT(reads.load(), idle);
+}
+
+TEST_F(TestFeedback, IsReaderServedWithoutWaitingForPeriod)
+{
+    Feedback slow{[this](roarmm2::servofeedback_t&) {
+                      reads++;
+                      return true;
+                  },
+                  500ms};
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t num{}; num < 5; num++)
+    {
+        ASSERT_TRUE(slow.get(0ms));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 100ms);
+    EXPECT_EQ(reads.load(), 5);
+}
+
+TEST_F(TestFeedback, AreConcurrentReadersSharingSample)
+{
+    Feedback slow{[this](roarmm2::servofeedback_t&) {
+                      reads++;
+                      std::this_thread::sleep_for(30ms);
+                      return true;
+                  },
+                  100ms};
+    std::vector<std::jthread> readers;
+    for (uint32_t num{}; num < 8; num++)
+    {
+        readers.emplace_back([&slow]() { EXPECT_TRUE(slow.get(0ms)); });
+    }
+    readers.clear();
+    // one sample in flight when readers arrive and at most one after it
+    EXPECT_LE(reads.load(), 2);
+}
+
+TEST_F(TestFeedback, IsFailedReadNotReturned)
+{
+    ASSERT_TRUE(feedback.get(0ms));
+    failing = true;
+    EXPECT_FALSE(feedback.get(0ms));
+    // last valid sample is kept
+    EXPECT_TRUE(feedback.getlatest());
+    failing = false;
+    EXPECT_TRUE(feedback.get(0ms));
+}
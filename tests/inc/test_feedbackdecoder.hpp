@@ -0,0 +1,75 @@
+#include "robot/feedbackdecoder.hpp"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace robot::roarmm2;
+
+class TestFeedbackDecoder : public testing::Test
+{
+  public:
+    // response body as returned by robot for T=105
+    const std::string response{
+        "{\"T\":1051,\"x\":309.6,\"y\":-0.57,\"z\":239.34,"
+        "\"b\":-0.0015,\"s\":-0.0046,\"e\":1.5661,\"t\":3.1416,"
+        "\"torB\":0,\"torS\":-64,\"torE\":12,\"torH\":0}"};
+};
+
+TEST_F(TestFeedbackDecoder, IsResponseDecodedIntoFields)
+{
+    servofeedback_t feedback{};
+    ASSERT_EQ(decode(response, feedback), decodeerror::none);
+    EXPECT_DOUBLE_EQ(feedback.x, 309.6);
+    EXPECT_DOUBLE_EQ(feedback.y, -0.57);
+    EXPECT_DOUBLE_EQ(feedback.z, 239.34);
+    EXPECT_DOUBLE_EQ(feedback.b, -0.0015);
+    EXPECT_DOUBLE_EQ(feedback.s, -0.0046);
+    EXPECT_DOUBLE_EQ(feedback.e, 1.5661);
+    EXPECT_DOUBLE_EQ(feedback.t, 3.1416);
+    EXPECT_DOUBLE_EQ(feedback.torb, 0);
+    EXPECT_DOUBLE_EQ(feedback.tors, -64);
+    EXPECT_DOUBLE_EQ(feedback.tore, 12);
+    EXPECT_DOUBLE_EQ(feedback.torh, 0);
+}
+
+TEST_F(TestFeedbackDecoder, IsWhitespaceAccepted)
+{
+    servofeedback_t feedback{};
+    std::string spaced{"{ \"x\" : 1, \"y\": 2,\n\"z\":3, \"b\":4, \"s\":5, "
+                       "\"e\":6, \"t\":7 }\r\n"};
+    ASSERT_EQ(decode(spaced, feedback), decodeerror::none);
+    EXPECT_DOUBLE_EQ(feedback.x, 1);
+    EXPECT_DOUBLE_EQ(feedback.t, 7);
+}
+
+TEST_F(TestFeedbackDecoder, IsEmptyResponseReported)
+{
+    servofeedback_t feedback{};
+    EXPECT_EQ(decode("", feedback), decodeerror::empty);
+    EXPECT_EQ(decode("  \n", feedback), decodeerror::empty);
+}
+
+TEST_F(TestFeedbackDecoder, IsMalformedResponseReported)
+{
+    servofeedback_t feedback{};
+    EXPECT_EQ(decode("[]", feedback), decodeerror::malformed);
+    EXPECT_EQ(decode(response.substr(0, response.size() - 1), feedback),
+              decodeerror::malformed);
+    EXPECT_EQ(decode("{\"x:1}", feedback), decodeerror::malformed);
+    EXPECT_EQ(decode("{\"x\" 1}", feedback), decodeerror::malformed);
+}
+
+TEST_F(TestFeedbackDecoder, IsBadValueReported)
+{
+    servofeedback_t feedback{};
+    EXPECT_EQ(decode("{\"x\":\"abc\"}", feedback), decodeerror::badvalue);
+    EXPECT_EQ(decode("{\"x\":}", feedback), decodeerror::badvalue);
+}
+
+TEST_F(TestFeedbackDecoder, IsMissingFieldReported)
+{
+    servofeedback_t feedback{};
+    EXPECT_EQ(decode("{\"T\":1051,\"x\":1,\"y\":2,\"z\":3}", feedback),
+              decodeerror::missingfield);
+}
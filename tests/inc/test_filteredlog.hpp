@@ -0,0 +1,103 @@
+#include "robot/filteredlog.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+
+class TestFilteredLog : public testing::Test
+{
+  public:
+    // stand-in sink, writing lasts until released when blocking
+    class Sink : public logging::LogIf
+    {
+      public:
+        void log(logging::type, const std::string&,
+                 const std::string& msg) override
+        {
+            std::unique_lock lock(mtx);
+            entered = true;
+            cv.notify_all();
+            cv.wait(lock, [this]() { return !blocking; });
+            messages.push_back(msg);
+        }
+
+        void waitentered()
+        {
+            std::unique_lock lock(mtx);
+            cv.wait(lock, [this]() { return entered; });
+        }
+
+        void release()
+        {
+            std::lock_guard lock(mtx);
+            blocking = false;
+            cv.notify_all();
+        }
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool blocking{};
+        bool entered{};
+        std::vector<std::string> messages;
+    };
+
+    std::shared_ptr<Sink> sink{std::make_shared<Sink>()};
+};
+
+TEST_F(TestFilteredLog, AreMessagesFilteredByLevel)
+{
+    FilteredLog log(sink, logging::type::warning, 0);
+    EXPECT_TRUE(log.isenabled(logging::type::error));
+    EXPECT_TRUE(log.isenabled(logging::type::warning));
+    EXPECT_FALSE(log.isenabled(logging::type::info));
+
+    log.log(logging::type::error, "ut", "first");
+    log.log(logging::type::debug, "ut", "second");
+    log.log(logging::type::warning, "ut", "third");
+    EXPECT_EQ(sink->messages, (std::vector<std::string>{"first", "third"}));
+    auto stats = log.getstats();
+    EXPECT_EQ(stats.written, 2);
+    EXPECT_EQ(stats.filtered, 1);
+    EXPECT_EQ(stats.dropped, 0);
+}
+
+TEST_F(TestFilteredLog, AreQueuedMessagesWrittenInOrder)
+{
+    std::vector<std::string> expected;
+    {
+        FilteredLog log(sink, logging::type::debug, 100);
+        for (int32_t num{}; num < 50; num++)
+        {
+            expected.push_back("message " + std::to_string(num));
+            log.log(logging::type::info, "ut", expected.back());
+        }
+    }
+    EXPECT_EQ(sink->messages, expected);
+}
+
+TEST_F(TestFilteredLog, AreMessagesDroppedWhenQueueIsFull)
+{
+    sink->blocking = true;
+    logstats_t stats{};
+    {
+        FilteredLog log(sink, logging::type::debug, 2);
+        log.log(logging::type::info, "ut", "first");
+        sink->waitentered();
+        // writer is held by sink, so callers must not wait for it
+        log.log(logging::type::info, "ut", "second");
+        log.log(logging::type::info, "ut", "third");
+        log.log(logging::type::info, "ut", "fourth");
+        sink->release();
+        stats = log.getstats();
+    }
+    EXPECT_EQ(stats.dropped, 1);
+    EXPECT_EQ(sink->messages, (std::vector<std::string>{
+                                  "first", "second", "third",
+                                  "Log queue full, dropped messages: 1"}));
+}
@@ -0,0 +1,213 @@
+#include "robot/fleet.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+
+// Stand-in for arm controller, records received commands
+class ArmStandIn : public http::HttpIf
+{
+  public:
+    explicit ArmStandIn(bool reachable = true) : reachable{reachable}
+    {}
+
+    bool get(const http::inputtype&, http::outputtype&) override
+    {
+        return false;
+    }
+
+    bool get(const http::inputtype&, std::string&) override
+    {
+        return false;
+    }
+
+    bool get(const std::string& in, std::string& out) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard lock(mtx);
+        received.push_back(in);
+        caller = std::this_thread::get_id();
+        out = in == "{\"T\":105}"
+                  ? "{\"T\":1051,\"x\":100,\"y\":200,\"z\":300,\"b\":0,"
+                    "\"s\":0,\"e\":1.57,\"t\":3.14}"
+                  : "{}";
+        return reachable;
+    }
+
+    std::string info() override
+    {
+        return "stand-in";
+    }
+
+    std::vector<std::string> getreceived()
+    {
+        std::lock_guard lock(mtx);
+        return received;
+    }
+
+    std::thread::id getcaller()
+    {
+        std::lock_guard lock(mtx);
+        return caller;
+    }
+
+  private:
+    const bool reachable;
+    std::mutex mtx;
+    std::vector<std::string> received;
+    std::thread::id caller;
+};
+
+class TestFleet : public testing::Test
+{
+  public:
+    std::vector<std::shared_ptr<ArmStandIn>> standins{
+        std::make_shared<ArmStandIn>(), std::make_shared<ArmStandIn>(),
+        std::make_shared<ArmStandIn>(false)};
+
+    std::vector<arm_t> getarms() const
+    {
+        return {{"left", standins[0]},
+                {"right", standins[1]},
+                {"offline", standins[2]}};
+    }
+};
+
+TEST_F(TestFleet, AreArmCommandsKeptInOrder)
+{
+    Fleet fleet(getarms(), 4);
+    std::vector<std::future<response_t>> responses;
+    std::vector<std::string> sent;
+    for (uint32_t num{}; num < 20; num++)
+    {
+        sent.push_back("{\"T\":114,\"led\":" + std::to_string(num) + "}");
+        responses.push_back(fleet.send(0, sent.back()));
+    }
+    std::ranges::for_each(responses, [](auto& resp) { resp.wait(); });
+    EXPECT_EQ(standins[0]->getreceived(), sent);
+    EXPECT_TRUE(standins[1]->getreceived().empty());
+}
+
+TEST_F(TestFleet, IsBroadcastSentToAllArms)
+{
+    Fleet fleet(getarms(), 1);
+    auto responses = fleet.broadcast("{\"T\":100}");
+    ASSERT_EQ(responses.size(), fleet.size());
+    EXPECT_TRUE(responses[0].get().ok);
+    EXPECT_TRUE(responses[1].get().ok);
+    EXPECT_FALSE(responses[2].get().ok);
+    for (const auto& standin : standins)
+    {
+        EXPECT_EQ(standin->getreceived(),
+                  std::vector<std::string>{"{\"T\":100}"});
+    }
+}
+
+TEST_F(TestFleet, IsTelemetryAggregated)
+{
+    Fleet fleet(getarms(), 2);
+    EXPECT_EQ(fleet.sampletelemetry(), 2);
+    auto telemetry = fleet.gettelemetry();
+    ASSERT_EQ(telemetry.size(), 3);
+    EXPECT_EQ(telemetry[0].name, "left");
+    ASSERT_TRUE(telemetry[0].feedback);
+    EXPECT_DOUBLE_EQ(telemetry[0].feedback->z, 300);
+    EXPECT_EQ(telemetry[0].requests, 1);
+    EXPECT_GT(telemetry[0].maxlatency.count(), 0);
+    EXPECT_FALSE(telemetry[2].feedback);
+    EXPECT_EQ(telemetry[2].failures, 1);
+}
+
+TEST_F(TestFleet, IsUnknownArmRejected)
+{
+    Fleet fleet(getarms(), 1);
+    EXPECT_THROW(fleet.send(3, "{\"T\":100}"), std::runtime_error);
+    EXPECT_THROW(fleet.getrobot(0), std::runtime_error);
+}
+
+TEST_F(TestFleet, IsRobotServedByFleetWorkers)
+{
+    uint32_t created{};
+    std::shared_ptr<http::HttpIf> link;
+    Fleet fleet(getarms(), 2, [&](std::shared_ptr<http::HttpIf> httpIf) {
+        created++;
+        link = httpIf;
+        return nullptr;
+    });
+    fleet.getrobot(0);
+    fleet.getrobot(0);
+    EXPECT_EQ(created, 1);
+    ASSERT_TRUE(link);
+    EXPECT_NE(link, standins[0]);
+
+    // requests of robot are queued after commands already sent to its arm
+    auto sent = fleet.send(0, "{\"T\":100}");
+    std::string out;
+    EXPECT_TRUE(link->get("{\"T\":105}", out));
+    EXPECT_EQ(out.substr(0, 11), "{\"T\":1051,\"");
+    EXPECT_TRUE(sent.get().ok);
+    EXPECT_EQ(standins[0]->getreceived(),
+              (std::vector<std::string>{"{\"T\":100}", "{\"T\":105}"}));
+    EXPECT_EQ(fleet.gettelemetry()[0].requests, 2);
+
+    fleet.getrobot(2);
+    EXPECT_FALSE(link->get("{\"T\":105}", out));
+    EXPECT_EQ(fleet.gettelemetry()[2].failures, 1);
+}
+
+TEST_F(TestFleet, IsIdleArmServedOnRobotThread)
+{
+    std::shared_ptr<http::HttpIf> link;
+    Fleet fleet(getarms(), 1, [&](std::shared_ptr<http::HttpIf> httpIf) {
+        link = httpIf;
+        return nullptr;
+    });
+    fleet.getrobot(1);
+    ASSERT_TRUE(link);
+    // worker is held by other arm, idle one needs none
+    auto busy = fleet.send(0, "{\"T\":100}");
+    std::string out;
+    EXPECT_TRUE(link->get("{\"T\":105}", out));
+    EXPECT_EQ(standins[1]->getcaller(), std::this_thread::get_id());
+    EXPECT_TRUE(busy.get().ok);
+    EXPECT_NE(standins[0]->getcaller(), std::this_thread::get_id());
+    EXPECT_EQ(fleet.gettelemetry()[1].requests, 1);
+}
+
+TEST_F(TestFleet, IsShowPlayedOnArms)
+{
+    using namespace std::chrono_literals;
+    Fleet fleet(getarms(), 2);
+    fleet.calibrate(2);
+    std::mutex mtx;
+    std::vector<std::string> spoken;
+    auto report = fleet.play(
+        {{0ms, 0, cuetype::motion, "{\"T\":104}"},
+         {0ms, 1, cuetype::led, "{\"T\":114}"},
+         {10ms, 1, cuetype::speech, "hello"},
+         {10ms, 2, cuetype::motion, "{\"T\":104}"}},
+        [&mtx, &spoken](size_t arm, const std::string& text) {
+            std::lock_guard lock(mtx);
+            spoken.push_back(std::to_string(arm) + text);
+            return true;
+        });
+
+    ASSERT_EQ(report.arms.size(), 3u);
+    EXPECT_EQ(report.arms[0].cues, 1u);
+    EXPECT_EQ(report.arms[1].cues, 2u);
+    EXPECT_EQ(report.arms[1].failed, 0u);
+    EXPECT_EQ(report.arms[2].failed, 1u);
+    EXPECT_GT(report.arms[0].latencies[(size_t)cuetype::motion], 0us);
+    EXPECT_EQ(spoken, std::vector<std::string>{"1hello"});
+    EXPECT_EQ(standins[0]->getreceived().back(), "{\"T\":104}");
+    EXPECT_EQ(standins[1]->getreceived().back(), "{\"T\":114}");
+}
@@ -0,0 +1,103 @@
+#include "robot/kinematics.hpp"
+
+#include <numbers>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot::roarmm2;
+
+class TestKinematics : public testing::Test
+{
+  public:
+    static constexpr double tolerance{1e-6};
+
+    static constexpr double dgrtorad(double dgr)
+    {
+        return dgr * std::numbers::pi / 180.;
+    }
+
+    // poses used by robot: parked, handshake base and handshake moves
+    const std::vector<robot::waypoint_t> knownposes{
+        {80, 0, 455, dgrtorad(180 - 35)},
+        {175, 235, 325, dgrtorad(180 - 35)},
+        {245, 310, 215, dgrtorad(180)},
+        {215, 280, 335, dgrtorad(180)},
+        {424, 75, 168, dgrtorad(180)}};
+
+    void expectnear(const robot::waypoint_t& a, const robot::waypoint_t& b)
+    {
+        for (size_t i{}; i < a.size(); i++)
+        {
+            EXPECT_NEAR(a[i], b[i], tolerance);
+        }
+    }
+};
+
+TEST_F(TestKinematics, IsHomePoseAtExpectedJoints)
+{
+    auto pose = forward({0, 0, std::numbers::pi / 2, std::numbers::pi});
+    EXPECT_NEAR(pose[0], 30. + 280.15, tolerance);
+    EXPECT_NEAR(pose[1], 0., tolerance);
+    EXPECT_NEAR(pose[2], 236.82, tolerance);
+}
+
+TEST_F(TestKinematics, AreKnownPosesReachable)
+{
+    for (const auto& pose : knownposes)
+    {
+        joints_t joints{};
+        ASSERT_TRUE(inverse(pose, joints));
+        EXPECT_TRUE(iswithinlimits(joints));
+        expectnear(forward(joints), pose);
+    }
+}
+
+TEST_F(TestKinematics, IsParkedPoseInArmPlane)
+{
+    joints_t joints{};
+    ASSERT_TRUE(inverse(knownposes.front(), joints));
+    EXPECT_NEAR(joints[0], 0., tolerance);
+    EXPECT_NEAR(joints[3], dgrtorad(145), tolerance);
+}
+
+TEST_F(TestKinematics, IsUnreachablePoseRejected)
+{
+    joints_t joints{};
+    EXPECT_FALSE(inverse({1000, 0, 0, std::numbers::pi}, joints));
+    EXPECT_FALSE(inverse({200, 0, 200, 0}, joints));
+}
+
+TEST_F(TestKinematics, IsBatchEqualToSinglePoses)
+{
+    posebatch_t poses;
+    for (const auto& pose : knownposes)
+    {
+        poses.x.push_back(pose[0]);
+        poses.y.push_back(pose[1]);
+        poses.z.push_back(pose[2]);
+        poses.t.push_back(pose[3]);
+    }
+    poses.x.push_back(1000);
+    poses.y.push_back(0);
+    poses.z.push_back(0);
+    poses.t.push_back(std::numbers::pi);
+
+    jointbatch_t joints;
+    std::vector<uint8_t> valid;
+    EXPECT_EQ(inverse(poses, joints, valid), knownposes.size());
+    EXPECT_FALSE(valid.back());
+
+    posebatch_t backposes;
+    forward(joints, backposes);
+    for (size_t i{}; i < knownposes.size(); i++)
+    {
+        joints_t single{};
+        inverse(knownposes[i], single);
+        EXPECT_NEAR(joints.shoulder[i], single[1], tolerance);
+        EXPECT_NEAR(joints.elbow[i], single[2], tolerance);
+        expectnear({backposes.x[i], backposes.y[i], backposes.z[i],
+                    backposes.t[i]},
+                   knownposes[i]);
+    }
+}
@@ -0,0 +1,123 @@
+#include "robot/ledeffects.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestLedEffects : public testing::Test
+{
+  public:
+    std::vector<uint8_t> levels;
+    // write is taken only once previous one has been sent for that long
+    std::chrono::milliseconds sending{};
+    std::chrono::steady_clock::time_point sent;
+    std::mutex mtx;
+    std::vector<LedEngine::tickfunc> ticks;
+    uint32_t attached{};
+
+    // levels are written from tick thread only, read once effect is done
+    LedEngine engine{[this](uint8_t lvl) {
+                         auto now = std::chrono::steady_clock::now();
+                         if (now < sent + sending)
+                         {
+                             return false;
+                         }
+                         sent = now;
+                         levels.push_back(lvl);
+                         return true;
+                     },
+                     10ms,
+                     [this](LedEngine::tickfunc tick) {
+                         std::lock_guard lock(mtx);
+                         ticks.push_back(std::move(tick));
+                         attached++;
+                     }};
+
+    // stands in for scheduler thread shared by engines
+    std::jthread ticker{[this](std::stop_token stoken) {
+        while (!stoken.stop_requested())
+        {
+            {
+                std::lock_guard lock(mtx);
+                std::erase_if(ticks, [](const auto& tick) { return !tick(); });
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+    }};
+};
+
+TEST_F(TestLedEffects, AreEffectLevelsFollowed)
+{
+    auto fade = ledeffect::fade(0, 100, 100ms);
+    EXPECT_EQ(fade(0ms), 0);
+    EXPECT_EQ(fade(50ms), 50);
+    EXPECT_EQ(fade(100ms), 100);
+    EXPECT_FALSE(fade(110ms));
+
+    auto pulse = ledeffect::pulse(10, 110, 100ms);
+    EXPECT_EQ(pulse(0ms), 10);
+    EXPECT_EQ(pulse(50ms), 110);
+    EXPECT_EQ(pulse(150ms), 110);
+    auto breathe = ledeffect::breathe(10, 110, 100ms);
+    EXPECT_EQ(breathe(0ms), 10);
+    EXPECT_EQ(breathe(50ms), 110);
+}
+
+TEST_F(TestLedEffects, AreRepeatedLevelsNotWritten)
+{
+    engine.run(ledeffect::fade(50, 50, 100ms));
+    engine.wait();
+    auto stats = engine.getstats();
+    EXPECT_GE(stats.frames, 10);
+    EXPECT_EQ(stats.writes, 1);
+    EXPECT_EQ(levels, std::vector<uint8_t>{50});
+}
+
+TEST_F(TestLedEffects, AreFramesDroppedWhileWriting)
+{
+    sending = 25ms;
+    auto start = std::chrono::steady_clock::now();
+    engine.run(ledeffect::fade(0, 200, 200ms));
+    engine.wait();
+    auto stats = engine.getstats();
+    EXPECT_GT(stats.dropped, 0);
+    EXPECT_LT(stats.writes, stats.frames);
+    // effect keeps its duration instead of being stretched by slow writes
+    EXPECT_LE(stats.frames, 21);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 300ms);
+    // and its last level is still written
+    EXPECT_EQ(levels.back(), 200);
+}
+
+TEST_F(TestLedEffects, IsEndlessEffectStopped)
+{
+    engine.run(ledeffect::pulse(0, 100, 100ms));
+    EXPECT_FALSE(engine.wait(50ms));
+    engine.stop();
+    EXPECT_TRUE(engine.wait(0ms));
+    auto frames = engine.getstats().frames;
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(engine.getstats().frames, frames);
+    // engine is detached from tick once effect is gone
+    std::lock_guard lock(mtx);
+    EXPECT_TRUE(ticks.empty());
+}
+
+TEST_F(TestLedEffects, IsEngineAttachedOncePerRun)
+{
+    engine.run(ledeffect::pulse(0, 100, 100ms));
+    engine.run(ledeffect::breathe(0, 100, 100ms));
+    EXPECT_EQ(attached, 1u);
+    engine.stop();
+    std::this_thread::sleep_for(10ms);
+    engine.run(ledeffect::fade(0, 100, 50ms));
+    engine.wait();
+    EXPECT_EQ(attached, 2u);
+    EXPECT_EQ(levels.back(), 100);
+}
@@ -0,0 +1,66 @@
+#include "robot/motiondetect.hpp"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestMotionDetect : public testing::Test
+{
+  public:
+    static constexpr motionparams_t params{
+        .period = 10ms, .deadband = 5., .latencytarget = 30ms};
+    const std::chrono::steady_clock::time_point start{
+        std::chrono::steady_clock::now()};
+    uint32_t reads{};
+
+    std::chrono::steady_clock::duration elapsed() const
+    {
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    // alternating offset as from noisy feedback of still arm
+    position_t jitter(double amplitude)
+    {
+        auto offset = (reads++ % 2) ? amplitude : -amplitude;
+        return {100. + offset, 200., 300.};
+    }
+};
+
+TEST_F(TestMotionDetect, IsJitterInDeadbandIgnored)
+{
+    auto result = detectmotion([this]() { return jitter(2.); },
+                               [this]() { return elapsed() > 300ms; },
+                               params);
+    EXPECT_FALSE(result.detected);
+    EXPECT_GT(result.samples, 20);
+    EXPECT_EQ(result.samples, reads);
+}
+
+TEST_F(TestMotionDetect, IsSingleSpikeIgnored)
+{
+    auto result = detectmotion(
+        [this]() {
+            // one outlier sample is averaged out by the window
+            return reads++ == 10 ? position_t{112., 200., 300.}
+                                 : position_t{100., 200., 300.};
+        },
+        [this]() { return elapsed() > 300ms; }, params);
+    EXPECT_FALSE(result.detected);
+}
+
+TEST_F(TestMotionDetect, IsHandMoveDetected)
+{
+    auto result = detectmotion(
+        [this]() {
+            reads++;
+            return elapsed() > 100ms ? position_t{100., 220., 300.}
+                                     : position_t{100., 200., 300.};
+        },
+        [this]() { return elapsed() > 1s; }, params);
+    EXPECT_TRUE(result.detected);
+    EXPECT_LE(result.latency, params.latencytarget + params.period);
+    EXPECT_LT(elapsed(), 300ms);
+}
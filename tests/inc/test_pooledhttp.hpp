@@ -0,0 +1,125 @@
+#include "robot/commandchannel.hpp"
+#include "robot/pooledhttp.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Client that cannot serve two requests at once, overlapping ones are
+// counted instead of being corrupted
+class SingleUseClient : public http::HttpIf
+{
+  public:
+    explicit SingleUseClient(std::atomic<uint32_t>& overlaps) :
+        overlaps{overlaps}
+    {}
+
+    bool get(const http::inputtype&, http::outputtype&) override
+    {
+        return use();
+    }
+
+    bool get(const http::inputtype&, std::string& out) override
+    {
+        out = "{}";
+        return use();
+    }
+
+    bool get(const std::string&, std::string& out) override
+    {
+        out = "{}";
+        return use();
+    }
+
+    std::string info() override
+    {
+        return "single use";
+    }
+
+  private:
+    std::atomic<uint32_t>& overlaps;
+    std::atomic<bool> busy{};
+
+    bool use()
+    {
+        if (busy.exchange(true))
+        {
+            overlaps++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        busy = false;
+        return true;
+    }
+};
+
+class TestPooledHttp : public testing::Test
+{
+  public:
+    static constexpr int32_t commands{40};
+    std::atomic<uint32_t> overlaps{};
+
+    std::shared_ptr<robot::PooledHttp> getpool(uint32_t size)
+    {
+        return std::make_shared<robot::PooledHttp>(
+            [this]() { return std::make_shared<SingleUseClient>(overlaps); },
+            size);
+    }
+
+    void sendall(robot::CommandChannel& channel)
+    {
+        std::vector<std::future<robot::response_t>> responses;
+        for (int32_t seq{}; seq < commands; seq++)
+        {
+            responses.push_back(channel.send({{"T", 114}, {"seq", seq}}));
+        }
+        std::ranges::for_each(responses,
+                              [](auto& resp) { EXPECT_TRUE(resp.get().ok); });
+    }
+};
+
+TEST_F(TestPooledHttp, AreLanesGivenClientsOfTheirOwn)
+{
+    auto pool = getpool(4);
+    robot::CommandChannel channel(pool, 4);
+    auto start = std::chrono::steady_clock::now();
+    sendall(channel);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(overlaps.load(), 0u);
+    EXPECT_GT(pool->getclients(), 1u);
+    EXPECT_LE(pool->getclients(), 4u);
+    // requests still run in parallel on separate clients
+    EXPECT_LT(elapsed, std::chrono::milliseconds(5 * commands / 2));
+}
+
+TEST_F(TestPooledHttp, AreRequestsWaitingForFullPool)
+{
+    auto pool = getpool(2);
+    robot::CommandChannel channel(pool, 4);
+    sendall(channel);
+    EXPECT_EQ(overlaps.load(), 0u);
+    EXPECT_LE(pool->getclients(), 2u);
+}
+
+TEST_F(TestPooledHttp, IsFailedClientCreationReported)
+{
+    EXPECT_THROW(robot::PooledHttp({}, 1), std::runtime_error);
+    EXPECT_THROW(robot::PooledHttp(
+                     [this]() {
+                         return std::make_shared<SingleUseClient>(overlaps);
+                     },
+                     0),
+                 std::runtime_error);
+
+    robot::PooledHttp pool([]() { return nullptr; }, 1);
+    std::string resp;
+    EXPECT_THROW(pool.get("{\"T\":105}", resp), std::runtime_error);
+    // slot of client that failed is free again
+    EXPECT_EQ(pool.getclients(), 0u);
+}
@@ -0,0 +1,142 @@
+#include "robot/requeststats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+
+// Arm answering feedback requests only
+class FeedbackArm : public http::HttpIf
+{
+  public:
+    bool get(const http::inputtype&, http::outputtype& out) override
+    {
+        out = {{"ip", std::string{"192.168.4.1"}}};
+        return true;
+    }
+
+    bool get(const http::inputtype&, std::string&) override
+    {
+        return false;
+    }
+
+    bool get(const std::string& in, std::string& out) override
+    {
+        out = in == "{\"T\":105}" ? "{\"T\":1051,\"x\":1}" : "";
+        return !out.empty();
+    }
+
+    std::string info() override
+    {
+        return "feedback arm";
+    }
+};
+
+TEST(TestRequestStats, AreLatencyPercentilesWithinBucketError)
+{
+    using namespace std::chrono_literals;
+    LatencyHistogram histogram;
+    for (int64_t value{1}; value <= 1000; value++)
+    {
+        histogram.record(std::chrono::microseconds{value});
+    }
+    EXPECT_EQ(histogram.count(), 1000);
+    EXPECT_EQ(histogram.mean(), 500us);
+    EXPECT_EQ(histogram.max(), 1000us);
+    EXPECT_EQ(histogram.percentile(100.), 1000us);
+    EXPECT_GE(histogram.percentile(50.), 500us);
+    EXPECT_LE(histogram.percentile(50.), 500us * 33 / 32);
+    EXPECT_GE(histogram.percentile(99.), 990us);
+    EXPECT_LE(histogram.percentile(99.), 1000us);
+    EXPECT_EQ(histogram.percentile(0.), 1us);
+}
+
+TEST(TestRequestStats, IsEmptyHistogramReportingZero)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0);
+    EXPECT_EQ(histogram.percentile(99.).count(), 0);
+    EXPECT_EQ(histogram.mean().count(), 0);
+}
+
+TEST(TestRequestStats, AreRequestsAccountedByTypeAndActivity)
+{
+    MeteredHttp metered(std::make_shared<FeedbackArm>());
+    std::string resp;
+    EXPECT_TRUE(metered.get("{\"T\":105}", resp));
+    EXPECT_TRUE(metered.get("{\"T\":105}", resp));
+    {
+        ActivityScope scope(activity::dance);
+        EXPECT_EQ(getactivity(), activity::dance);
+        EXPECT_FALSE(
+            metered.get("{\"T\":1041,\"x\":1,\"y\":2,\"z\":3}", resp));
+        EXPECT_FALSE(metered.get("{\"T\":7}", resp));
+    }
+    EXPECT_EQ(getactivity(), activity::other);
+    http::outputtype out;
+    EXPECT_TRUE(metered.get({{"T", 405}}, out));
+
+    auto report = metered.getreport();
+    auto getcommand = [&report](int32_t type) {
+        return *std::ranges::find(report.commands, type,
+                                  &commandstats_t::type);
+    };
+    ASSERT_EQ(report.commands.size(), 4);
+    EXPECT_EQ(getcommand(105).requests, 2);
+    EXPECT_EQ(getcommand(105).failures, 0);
+    EXPECT_EQ(getcommand(105).bytessent, 18);
+    EXPECT_EQ(getcommand(105).bytesreceived, 32);
+    EXPECT_EQ(getcommand(1041).failures, 1);
+    EXPECT_EQ(getcommand(-1).requests, 1);
+    EXPECT_GT(getcommand(405).bytesreceived, 0);
+    EXPECT_EQ(report.activities[(size_t)activity::other], 3);
+    EXPECT_EQ(report.activities[(size_t)activity::dance], 2);
+}
+
+TEST(TestRequestStats, AreActivitiesKeptPerThread)
+{
+    MeteredHttp metered(std::make_shared<FeedbackArm>());
+    auto send = [&metered](activity current, uint32_t requests) {
+        ActivityScope scope(current);
+        // nested scope keeps running activity and restores it on leaving
+        {
+            ActivityScope nested(activity::gripper);
+            EXPECT_EQ(getactivity(), current);
+        }
+        std::string resp;
+        for (uint32_t num{}; num < requests; num++)
+        {
+            metered.get("{\"T\":105}", resp);
+        }
+    };
+    {
+        // overlapping scopes of other threads do not affect each other
+        std::jthread dance(send, activity::dance, 100);
+        std::jthread enlight(send, activity::enlight, 50);
+    }
+    EXPECT_EQ(getactivity(), activity::other);
+
+    // work handed over to other thread is accounted to its sender
+    std::function<void()> handover;
+    {
+        ActivityScope scope(activity::shakehand);
+        handover = withactivity([&metered]() {
+            std::string resp;
+            metered.get("{\"T\":105}", resp);
+        });
+    }
+    std::jthread(handover).join();
+
+    auto report = metered.getreport();
+    EXPECT_EQ(report.activities[(size_t)activity::dance], 100);
+    EXPECT_EQ(report.activities[(size_t)activity::enlight], 50);
+    EXPECT_EQ(report.activities[(size_t)activity::shakehand], 1);
+    EXPECT_EQ(report.activities[(size_t)activity::gripper], 0);
+    EXPECT_EQ(report.activities[(size_t)activity::other], 0);
+}
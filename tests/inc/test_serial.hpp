@@ -0,0 +1,156 @@
+#include "robot/serial.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestSerial : public testing::Test
+{
+  public:
+    static constexpr serialconfig_t config{115200, 200ms, 20ms};
+    static constexpr std::string_view feedback{
+        "{\"T\":1051,\"x\":235.5,\"y\":0,\"z\":234}"};
+    static constexpr std::string_view wifiinfo{
+        "{\"ip\":\"192.168.4.1\",\"ap\":true,\"sta\":false,\"rssi\":null}"};
+
+    int master{-1};
+    std::string device;
+    std::jthread arm;
+
+    TestSerial()
+    {
+        master = ::posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || ::grantpt(master) || ::unlockpt(master))
+        {
+            throw std::runtime_error("Cannot create pseudo terminal");
+        }
+        device = ::ptsname(master);
+    }
+
+    ~TestSerial()
+    {
+        arm.request_stop();
+        if (arm.joinable())
+        {
+            arm.join();
+        }
+        ::close(master);
+    }
+
+    // stub device echoing commands and answering feedback requests,
+    // silent one takes commands without any response
+    void startarm(bool silent = false)
+    {
+        arm = std::jthread([this, silent](std::stop_token stoken) {
+            std::string received;
+            while (!stoken.stop_requested())
+            {
+                pollfd pfd{master, POLLIN, 0};
+                if (::poll(&pfd, 1, 10) <= 0)
+                {
+                    continue;
+                }
+                std::array<char, 256> chunk;
+                auto num = ::read(master, chunk.data(), chunk.size());
+                if (num <= 0)
+                {
+                    continue;
+                }
+                received.append(chunk.data(), (size_t)num);
+                for (auto end = received.find('\n');
+                     end != std::string::npos; end = received.find('\n'))
+                {
+                    auto line = received.substr(0, end);
+                    received.erase(0, end + 1);
+                    if (!silent)
+                    {
+                        respond(line);
+                    }
+                }
+            }
+        });
+    }
+
+    void respond(const std::string& line)
+    {
+        auto resp = line + "\r\n";
+        if (line.find("\"T\":105") != std::string::npos)
+        {
+            resp += std::string{feedback} + "\r\n";
+        }
+        else if (line.find("\"T\":405") != std::string::npos)
+        {
+            resp += std::string{wifiinfo} + "\r\n";
+        }
+        ::write(master, resp.data(), resp.size());
+    }
+};
+
+TEST_F(TestSerial, IsDataResponseTakenAfterEcho)
+{
+    startarm();
+    SerialHttp serial(device, config);
+    std::string resp;
+    EXPECT_TRUE(serial.get("{\"T\":105}", resp));
+    EXPECT_EQ(resp, feedback);
+
+    http::outputtype out;
+    EXPECT_TRUE(serial.get({{"T", 105}}, out));
+    EXPECT_EQ(std::get<int64_t>(out.at("T")), 1051);
+    EXPECT_EQ(std::get<double>(out.at("x")), 235.5);
+    EXPECT_EQ(std::get<int64_t>(out.at("z")), 234);
+
+    out.clear();
+    EXPECT_TRUE(serial.get({{"T", 405}}, out));
+    EXPECT_EQ(std::get<std::string>(out.at("ip")), "192.168.4.1");
+    EXPECT_EQ(std::get<int64_t>(out.at("ap")), 1);
+    EXPECT_EQ(std::get<int64_t>(out.at("sta")), 0);
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(out.at("rssi")));
+}
+
+TEST_F(TestSerial, IsCommandAcknowledgedByEcho)
+{
+    startarm();
+    SerialHttp serial(device, {config.baud, config.timeout, 150ms});
+    std::string resp;
+    // known command without data ends on echo, not after reply gap
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(serial.get({{"T", 114}, {"led", 255}}, resp));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 100ms);
+    EXPECT_EQ(resp, "{\"T\":114,\"led\":255}");
+
+    // unknown one may still bring data, so reply gap is waited for
+    start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(serial.get("{\"T\":999}", resp));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 150ms);
+    EXPECT_EQ(resp, "{\"T\":999}");
+}
+
+TEST_F(TestSerial, IsRequestFailedWhenArmIsSilent)
+{
+    startarm(true);
+    SerialHttp serial(device, config);
+    std::string resp;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(serial.get("{\"T\":105}", resp));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, config.timeout);
+}
+
+TEST_F(TestSerial, IsUnsupportedSpeedRejected)
+{
+    EXPECT_THROW(SerialHttp(device, {12345, 200ms, 20ms}), std::runtime_error);
+    EXPECT_THROW(SerialHttp("/nonexistent/tty", config), std::runtime_error);
+}
@@ -0,0 +1,152 @@
+#include "robot/shadowstate.hpp"
+
+#include <chrono>
+#include <numbers>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestShadowState : public testing::Test
+{
+  public:
+    static constexpr double tolerance{std::numbers::pi / 90};
+    static constexpr auto settle{20ms};
+    static constexpr roarmm2::joints_t base{0., 0., std::numbers::pi / 2,
+                                            std::numbers::pi};
+
+    ShadowState shadow{tolerance, settle};
+
+    static roarmm2::servofeedback_t getfeedback(const roarmm2::joints_t& at)
+    {
+        roarmm2::servofeedback_t data{};
+        data.b = at[0];
+        data.s = at[1];
+        data.e = at[2];
+        data.t = at[3];
+        return data;
+    }
+};
+
+TEST_F(TestShadowState, AreRepeatedLedAndTorqueCommandsElided)
+{
+    EXPECT_FALSE(shadow.getled());
+    EXPECT_TRUE(shadow.setled(0));
+    EXPECT_FALSE(shadow.setled(0));
+    EXPECT_TRUE(shadow.setled(128));
+    EXPECT_EQ(shadow.getled(), 128);
+    EXPECT_TRUE(shadow.settorque(true));
+    EXPECT_FALSE(shadow.settorque(true));
+
+    shadow.invalidate();
+    EXPECT_TRUE(shadow.setled(128));
+    EXPECT_TRUE(shadow.settorque(true));
+
+    auto stats = shadow.getstats();
+    EXPECT_EQ(stats.sent, 5);
+    EXPECT_EQ(stats.elided, 2);
+}
+
+TEST_F(TestShadowState, AreJointTargetsKeptWhileConfirmed)
+{
+    EXPECT_TRUE(shadow.setjoints(base));
+    EXPECT_FALSE(shadow.setjoints(base));
+    EXPECT_FALSE(shadow.setpose(roarmm2::forward(base)));
+    EXPECT_FALSE(shadow.setjoint(3, base[3] + tolerance / 2));
+
+    auto nearby = base;
+    nearby[0] += tolerance / 2;
+    shadow.confirm(getfeedback(nearby));
+    EXPECT_FALSE(shadow.setjoints(base));
+
+    // arm moved away from target, e.g. by collision, and stays there
+    auto pushed = base;
+    pushed[1] += 0.3;
+    std::this_thread::sleep_for(settle);
+    shadow.confirm(getfeedback(pushed));
+    EXPECT_FALSE(shadow.setjoints(base));
+    shadow.confirm(getfeedback(pushed));
+    EXPECT_TRUE(shadow.setjoints(base));
+    EXPECT_FALSE(shadow.setjoint(0, base[0]));
+    EXPECT_TRUE(shadow.setjoint(0, 1.));
+
+    auto stats = shadow.getstats();
+    EXPECT_EQ(stats.sent, 3);
+    EXPECT_EQ(stats.elided, 6);
+    EXPECT_EQ(stats.dropped, 1);
+}
+
+TEST_F(TestShadowState, AreTargetsKeptWhileArmMoves)
+{
+    auto start = base;
+    start[0] = 1.;
+    EXPECT_TRUE(shadow.setjoints(start));
+    EXPECT_TRUE(shadow.setjoints(base));
+    // arm stays at previous target until command takes effect
+    shadow.confirm(getfeedback(start));
+    shadow.confirm(getfeedback(start));
+    EXPECT_FALSE(shadow.setjoints(base));
+
+    // then travels to the target, each sample further away from start
+    std::this_thread::sleep_for(settle);
+    auto moving = start;
+    for (uint32_t num{}; num < 9; num++)
+    {
+        moving[0] -= 0.1;
+        shadow.confirm(getfeedback(moving));
+        EXPECT_FALSE(shadow.setjoints(base));
+    }
+    EXPECT_EQ(shadow.getstats().dropped, 0);
+}
+
+TEST_F(TestShadowState, AreStreamedPosesAlwaysSent)
+{
+    auto pose = roarmm2::forward(base);
+    shadow.trackpose(pose);
+    shadow.trackpose(pose);
+    EXPECT_FALSE(shadow.setpose(pose));
+    // out of reach pose is left to firmware
+    shadow.trackpose({10000., 0., 0., 0.});
+    EXPECT_TRUE(shadow.setpose(pose));
+
+    auto stats = shadow.getstats();
+    EXPECT_EQ(stats.sent, 4);
+    EXPECT_EQ(stats.elided, 1);
+}
+
+TEST_F(TestShadowState, AreJointsNotTrackedWhenUnlocked)
+{
+    EXPECT_TRUE(shadow.setjoints(base));
+    EXPECT_TRUE(shadow.settorque(false));
+    EXPECT_TRUE(shadow.setjoints(base));
+    // motion may engage servos, so lock is sent again
+    EXPECT_TRUE(shadow.settorque(true));
+    EXPECT_TRUE(shadow.setjoints(base));
+    EXPECT_FALSE(shadow.setjoints(base));
+}
+
+TEST_F(TestShadowState, IsOnlyTouchedStateInvalidated)
+{
+    EXPECT_TRUE(shadow.setled(128));
+    EXPECT_TRUE(shadow.settorque(true));
+    EXPECT_TRUE(shadow.setjoints(base));
+
+    // failed gripper command leaves other joints, led and torque known
+    shadow.invalidatejoint(3);
+    EXPECT_TRUE(shadow.setjoint(3, base[3]));
+    EXPECT_FALSE(shadow.setjoint(0, base[0]));
+    EXPECT_FALSE(shadow.setled(128));
+    EXPECT_FALSE(shadow.settorque(true));
+
+    shadow.invalidate(shadowpart::led);
+    EXPECT_TRUE(shadow.setled(128));
+    EXPECT_FALSE(shadow.setjoints(base));
+
+    shadow.invalidate(shadowpart::joints);
+    EXPECT_FALSE(shadow.settorque(true));
+    EXPECT_TRUE(shadow.setjoints(base));
+    EXPECT_THROW(shadow.invalidatejoint(4), std::runtime_error);
+}
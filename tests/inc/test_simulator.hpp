@@ -0,0 +1,121 @@
+#include "armmodel.hpp"
+#include "controller.hpp"
+#include "robot/feedbackdecoder.hpp"
+#include "server.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+class TestSimulator : public testing::Test
+{
+  public:
+    static constexpr sim::dynamics_t dynamics{.maxspeed = {2., 2., 2., 4.},
+                                              .maxaccel = {20., 20., 20., 40.},
+                                              .step = 1ms};
+    static constexpr sim::joints_t initial{0., 0., std::numbers::pi / 2,
+                                           std::numbers::pi};
+    std::shared_ptr<sim::ArmModel> arm{
+        std::make_shared<sim::ArmModel>(dynamics, initial)};
+    sim::Controller controller{arm};
+
+    static std::string exchange(uint16_t port, const std::string& request)
+    {
+        auto sock = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        std::string response;
+        if (!::connect(sock, (sockaddr*)&addr, sizeof(addr)) &&
+            ::send(sock, request.data(), request.size(), 0) > 0)
+        {
+            std::array<char, 1024> chunk;
+            for (auto size = ::recv(sock, chunk.data(), chunk.size(), 0);
+                 size > 0; size = ::recv(sock, chunk.data(), chunk.size(), 0))
+            {
+                response.append(chunk.data(), (size_t)size);
+            }
+        }
+        ::close(sock);
+        return response;
+    }
+};
+
+TEST_F(TestSimulator, IsJointMovedWithinSpeedLimit)
+{
+    arm->move(3, std::numbers::pi / 2, 0., 0.);
+    std::this_thread::sleep_for(100ms);
+    auto state = arm->getstate();
+    EXPECT_LT(state.position[3], initial[3]);
+    EXPECT_GT(state.position[3], std::numbers::pi / 2);
+    EXPECT_LE(std::abs(state.velocity[3]), dynamics.maxspeed[3] + 1e-9);
+
+    std::this_thread::sleep_for(600ms);
+    state = arm->getstate();
+    EXPECT_DOUBLE_EQ(state.position[3], std::numbers::pi / 2);
+    EXPECT_DOUBLE_EQ(state.velocity[3], 0.);
+}
+
+TEST_F(TestSimulator, IsArmNotMovedWithTorqueReleased)
+{
+    ASSERT_TRUE(controller.handle("{\"T\":210,\"cmd\":0}"));
+    ASSERT_TRUE(
+        controller.handle("{\"T\":121,\"joint\":1,\"angle\":45,\"spd\":0}"));
+    std::this_thread::sleep_for(20ms);
+    auto state = arm->getstate();
+    EXPECT_FALSE(state.locked);
+    EXPECT_DOUBLE_EQ(state.position[0], initial[0]);
+}
+
+TEST_F(TestSimulator, IsFeedbackDecodableAfterMove)
+{
+    ASSERT_TRUE(controller.handle(
+        "{\"T\":104,\"x\":245,\"y\":310,\"z\":215,\"t\":3.14,\"spd\":100}"));
+    std::this_thread::sleep_for(1500ms);
+    auto response = controller.handle("{\"T\":105}");
+    ASSERT_TRUE(response);
+
+    robot::roarmm2::servofeedback_t feedback{};
+    ASSERT_EQ(robot::roarmm2::decode(*response, feedback),
+              robot::roarmm2::decodeerror::none);
+    EXPECT_NEAR(feedback.x, 245., 0.01);
+    EXPECT_NEAR(feedback.y, 310., 0.01);
+    EXPECT_NEAR(feedback.z, 215., 0.01);
+    EXPECT_NEAR(feedback.t, 3.14, 0.0001);
+    EXPECT_FALSE(controller.handle("{\"T\":999}"));
+    EXPECT_FALSE(controller.handle("{\"T\":121,\"joint\":5,\"angle\":1}"));
+}
+
+TEST_F(TestSimulator, IsCommandServedOverHttpWithLatency)
+{
+    sim::Server server({"127.0.0.1", 0, 20ms, 5ms},
+                       [this](std::string_view json) {
+                           return controller.handle(json);
+                       });
+    auto start = std::chrono::steady_clock::now();
+    auto response = exchange(server.getport(),
+                             "GET /js?json=%7B%22T%22%3A302%7D HTTP/1.1\r\n"
+                             "Host: localhost\r\nConnection: close\r\n\r\n");
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK"));
+    EXPECT_NE(response.find("\"mac\""), std::string::npos);
+    EXPECT_GE(elapsed, 15ms);
+
+    response = exchange(server.getport(),
+                        "POST /js HTTP/1.1\r\nContent-Length: 9\r\n"
+                        "Connection: close\r\n\r\n{\"T\":999}");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 400"));
+}
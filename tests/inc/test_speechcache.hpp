@@ -0,0 +1,192 @@
+#include "robot/speechcache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestSpeechCache : public testing::Test
+{
+  public:
+    const std::filesystem::path path{std::filesystem::temp_directory_path() /
+                                     "robot-speechcache-ut.bin"};
+    const tts::voice_t voice{tts::language::english, tts::gender::female, 1};
+    std::atomic<uint32_t> synthesized{};
+    std::mutex mtx;
+    std::vector<std::string> played;
+
+    // stand-in synthesizer, audio is text itself prefixed with marker
+    SpeechCache::synthfunc synth = [this](const phrase_t& phrase,
+                                          std::vector<char>& audio) {
+        synthesized++;
+        std::string data{"pcm:" + phrase.text};
+        audio.assign(data.begin(), data.end());
+        return true;
+    };
+
+    SpeechCache::playfunc play = [this](std::span<const char> audio,
+                                        std::stop_token) {
+        std::lock_guard lock(mtx);
+        played.emplace_back(audio.begin(), audio.end());
+        return true;
+    };
+
+    void SetUp() override
+    {
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove(path);
+    }
+};
+
+TEST_F(TestSpeechCache, IsPhraseSynthesizedOnlyOnce)
+{
+    SpeechCache cache(path, synth, play);
+    EXPECT_TRUE(cache.speak({"ready for action", voice}));
+    EXPECT_TRUE(cache.speak({"ready for action", voice}));
+    EXPECT_EQ(synthesized, 1);
+    ASSERT_EQ(played.size(), 2);
+    EXPECT_EQ(played[0], "pcm:ready for action");
+    EXPECT_EQ(played[1], "pcm:ready for action");
+
+    auto stats = cache.getstats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.entries, 1);
+}
+
+TEST_F(TestSpeechCache, IsVoicePartOfKey)
+{
+    SpeechCache cache(path, synth, play);
+    cache.speak({"robot parked", voice});
+    cache.speak({"robot parked", {tts::language::english, tts::gender::male,
+                                  1}});
+    cache.speak({"robot parked", {tts::language::english,
+                                  tts::gender::female, 1.5}});
+    EXPECT_EQ(synthesized, 3);
+    EXPECT_EQ(cache.getstats().entries, 3);
+}
+
+TEST_F(TestSpeechCache, IsCatalogFilledInParallel)
+{
+    std::vector<phrase_t> phrases;
+    for (uint32_t num{}; num < 50; num++)
+    {
+        phrases.push_back({"phrase " + std::to_string(num), voice});
+    }
+    SpeechCache cache(path, synth, play);
+    EXPECT_EQ(cache.fill(phrases, 4), phrases.size());
+    EXPECT_EQ(cache.fill(phrases, 4), 0);
+    EXPECT_EQ(synthesized, phrases.size());
+    for (const auto& phrase : phrases)
+    {
+        EXPECT_TRUE(cache.contains(phrase));
+    }
+}
+
+TEST_F(TestSpeechCache, IsSingleWorkerFillingOnCallingThread)
+{
+    std::thread::id worker;
+    SpeechCache cache(
+        path,
+        [&worker](const phrase_t&, std::vector<char>& audio) {
+            worker = std::this_thread::get_id();
+            audio.assign({'p', 'c', 'm'});
+            return true;
+        },
+        play);
+    EXPECT_EQ(cache.fill({{"ready for action", voice}}, 1), 1);
+    EXPECT_EQ(worker, std::this_thread::get_id());
+}
+
+TEST_F(TestSpeechCache, IsCachePersistent)
+{
+    {
+        SpeechCache cache(path, synth, play);
+        cache.fill({{"initializing", voice}, {"robot parked", voice}}, 2);
+    }
+    SpeechCache cache(path, synth, play);
+    EXPECT_EQ(cache.getstats().entries, 2);
+    EXPECT_TRUE(cache.speak({"robot parked", voice}));
+    EXPECT_EQ(synthesized, 2);
+    ASSERT_EQ(played.size(), 1);
+    EXPECT_EQ(played[0], "pcm:robot parked");
+}
+
+TEST_F(TestSpeechCache, IsPartialEntryDropped)
+{
+    {
+        SpeechCache cache(path, synth, play);
+        cache.fill({{"initializing", voice}, {"robot parked", voice}}, 1);
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+    SpeechCache cache(path, synth, play);
+    EXPECT_EQ(cache.getstats().entries, 1);
+    EXPECT_TRUE(cache.speak({"robot parked", voice}));
+    ASSERT_EQ(played.size(), 1);
+    EXPECT_EQ(played[0], "pcm:robot parked");
+}
+
+TEST_F(TestSpeechCache, IsFailedSynthesisNotCached)
+{
+    SpeechCache cache(
+        path, [](const phrase_t&, std::vector<char>&) { return false; },
+        play);
+    EXPECT_FALSE(cache.speak({"ready for action", voice}));
+    EXPECT_FALSE(cache.contains({"ready for action", voice}));
+    EXPECT_TRUE(played.empty());
+}
+
+TEST_F(TestSpeechCache, IsPlaybackStoppedByOwnToken)
+{
+    std::atomic<bool> started{};
+    SpeechCache cache(path, synth,
+                      [&started](std::span<const char>,
+                                 std::stop_token stoken) {
+                          started = true;
+                          std::mutex waiting;
+                          std::unique_lock lock(waiting);
+                          std::condition_variable_any().wait(
+                              lock, stoken, []() { return false; });
+                          return !stoken.stop_requested();
+                      });
+    std::stop_source stop;
+    auto spoken = std::async(std::launch::async, [&cache, &stop, this]() {
+        return cache.speak({"dance with me", voice}, stop.get_token());
+    });
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+    stop.request_stop();
+    ASSERT_EQ(spoken.wait_for(1s), std::future_status::ready);
+    EXPECT_FALSE(spoken.get());
+
+    // stopped token does not start playing at all
+    started = false;
+    EXPECT_FALSE(cache.speak({"dance with me", voice}, stop.get_token()));
+    EXPECT_FALSE(started);
+}
+
+TEST_F(TestSpeechCache, IsInvalidFileRejected)
+{
+    {
+        std::ofstream file(path);
+        file << "not a cache";
+    }
+    EXPECT_THROW(SpeechCache(path, synth, play), std::runtime_error);
+}
@@ -0,0 +1,127 @@
+#include "robot/speechqueue.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestSpeechQueue : public testing::Test
+{
+  public:
+    static constexpr auto playtime = 60ms;
+    static constexpr auto preparetime = 40ms;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool killed{};
+    std::vector<std::string> prepared, spoken;
+    uint32_t kills{};
+
+    // stand-in synthesis backend, speaking lasts until killed
+    SpeechQueue::preparefunc prepare = [this](const std::string& text) {
+        std::this_thread::sleep_for(preparetime);
+        std::lock_guard lock(mtx);
+        prepared.push_back(text);
+    };
+
+    SpeechQueue::speakfunc speak = [this](const std::string& text) {
+        std::unique_lock lock(mtx);
+        bool isprepared = std::ranges::find(prepared, text) != prepared.end();
+        lock.unlock();
+        if (!isprepared)
+        {
+            std::this_thread::sleep_for(preparetime);
+        }
+        lock.lock();
+        spoken.push_back(text);
+        cv.notify_all();
+        cv.wait_for(lock, playtime, [this]() { return killed; });
+        killed = false;
+    };
+
+    SpeechQueue::stopfunc stop = [this]() {
+        std::lock_guard lock(mtx);
+        killed = true;
+        kills++;
+        cv.notify_all();
+    };
+
+    void waitspeaking()
+    {
+        std::unique_lock lock(mtx);
+        cv.wait(lock, [this]() { return !spoken.empty(); });
+    }
+};
+
+TEST_F(TestSpeechQueue, AreUtterancesSpokenInOrder)
+{
+    SpeechQueue queue(prepare, speak, stop, 2);
+    auto first = queue.push("first", speechpriority::song);
+    auto second = queue.push("second", speechpriority::song);
+    auto third = queue.push("third", speechpriority::song);
+    queue.wait();
+    EXPECT_TRUE(first.get());
+    EXPECT_TRUE(second.get());
+    EXPECT_TRUE(third.get());
+    EXPECT_EQ(spoken, (std::vector<std::string>{"first", "second", "third"}));
+    EXPECT_EQ(kills, 0);
+}
+
+TEST_F(TestSpeechQueue, AreNextUtterancesPreparedAhead)
+{
+    SpeechQueue queue(prepare, speak, stop, 2);
+    for (const auto* text : {"one", "two", "three", "four", "five"})
+    {
+        queue.push(text, speechpriority::song);
+    }
+    queue.wait();
+    auto stats = queue.getstats();
+    EXPECT_EQ(stats.spoken, 5);
+    EXPECT_LE(stats.unprepared, 1);
+    EXPECT_EQ(stats.gaps, 4);
+    EXPECT_LT(stats.maxgap, preparetime);
+}
+
+TEST_F(TestSpeechQueue, IsSongPreemptedByStatus)
+{
+    SpeechQueue queue(prepare, speak, stop, 1);
+    auto song = queue.push("song", speechpriority::song);
+    auto nextsong = queue.push("next song", speechpriority::song);
+    waitspeaking();
+    auto status = queue.push("status", speechpriority::status);
+    queue.wait();
+    EXPECT_FALSE(song.get());
+    EXPECT_TRUE(status.get());
+    EXPECT_TRUE(nextsong.get());
+    EXPECT_EQ(spoken,
+              (std::vector<std::string>{"song", "status", "next song"}));
+    EXPECT_EQ(queue.getstats().preempted, 1);
+}
+
+TEST_F(TestSpeechQueue, AreSongsCancelled)
+{
+    SpeechQueue queue(prepare, speak, stop, 2);
+    std::vector<std::future<bool>> songs;
+    for (const auto* text : {"one", "two", "three"})
+    {
+        songs.push_back(queue.push(text, speechpriority::song));
+    }
+    waitspeaking();
+    queue.cancel(speechpriority::song);
+    queue.wait();
+    for (auto& song : songs)
+    {
+        EXPECT_FALSE(song.get());
+    }
+    EXPECT_EQ(spoken, std::vector<std::string>{"one"});
+    EXPECT_EQ(queue.getstats().cancelled, 3);
+    EXPECT_EQ(kills, 1);
+}
@@ -0,0 +1,155 @@
+#include "robot/teach.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestTeach : public testing::Test
+{
+  public:
+    const std::filesystem::path path{std::filesystem::temp_directory_path() /
+                                     "robot-ut-teach.trj"};
+    static constexpr double quantum{1e-4};
+
+    ~TestTeach()
+    {
+        std::filesystem::remove(path);
+    }
+
+    // slow wave on every joint, as arm moved by hand
+    static roarmm2::joints_t getjoints(size_t num)
+    {
+        auto phase = (double)num / 50.;
+        return {std::sin(phase), 0.5 * std::cos(phase),
+                1.5 + 0.3 * std::sin(phase), 3. - 0.2 * phase};
+    }
+
+    static void expectnear(const roarmm2::joints_t& a,
+                           const roarmm2::joints_t& b, double tolerance)
+    {
+        for (size_t joint{}; joint < a.size(); joint++)
+        {
+            EXPECT_NEAR(a[joint], b[joint], tolerance);
+        }
+    }
+};
+
+TEST_F(TestTeach, IsRecordingRestoredFromFile)
+{
+    static constexpr size_t samples{500};
+    Recording recording(10ms);
+    for (size_t num{}; num < samples; num++)
+    {
+        recording.append(getjoints(num));
+    }
+    recording.save(path);
+
+    Recording loaded(path);
+    EXPECT_EQ(loaded.period(), 10ms);
+    ASSERT_EQ(loaded.size(), samples);
+    EXPECT_EQ(loaded.bytes(), std::filesystem::file_size(path));
+    // deltas of slowly moving joints take a few bytes per sample
+    EXPECT_LT(loaded.bytes(), samples * 4 * 2);
+    auto decoded = loaded.decode();
+    for (size_t num{}; num < samples; num++)
+    {
+        expectnear(decoded[num], getjoints(num), quantum);
+    }
+    EXPECT_THROW(loaded.append(getjoints(0)), std::runtime_error);
+}
+
+TEST_F(TestTeach, IsInvalidRecordingRejected)
+{
+    std::filesystem::remove(path);
+    EXPECT_THROW(Recording{path}, std::runtime_error);
+    {
+        Recording recording(10ms);
+        recording.append(getjoints(0));
+        recording.save(path);
+    }
+    std::filesystem::resize_file(path, 4);
+    EXPECT_THROW(Recording{path}, std::runtime_error);
+
+    // header is intact but deltas are cut, which shows up when decoding
+    {
+        Recording recording(10ms);
+        for (size_t num{}; num < 100; num++)
+        {
+            recording.append(getjoints(num));
+        }
+        recording.save(path);
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    Recording truncated(path);
+    EXPECT_THROW(truncated.decode(), std::runtime_error);
+    EXPECT_THROW(resample(truncated, 50ms, 1.), std::runtime_error);
+}
+
+TEST_F(TestTeach, AreSamplesRecordedAtFixedRate)
+{
+    std::atomic<size_t> reads{};
+    Recorder recorder(
+        [&reads](roarmm2::joints_t& joints) {
+            joints = getjoints(reads++);
+            return true;
+        },
+        5ms);
+    recorder.start();
+    EXPECT_THROW(recorder.start(), std::runtime_error);
+    std::this_thread::sleep_for(300ms);
+    auto recording = recorder.stop();
+    EXPECT_THROW(recorder.stop(), std::runtime_error);
+
+    auto stats = recorder.getstats();
+    EXPECT_EQ(recording.period(), 5ms);
+    EXPECT_EQ(recording.size(), stats.samples);
+    EXPECT_EQ(stats.overruns, 0);
+    EXPECT_GT(recording.size(), 30);
+    auto decoded = recording.decode();
+    expectnear(decoded.front(), getjoints(0), quantum);
+}
+
+TEST_F(TestTeach, IsReplayResampledAndScaled)
+{
+    Recording recording(10ms);
+    for (size_t num{}; num <= 200; num++)
+    {
+        recording.append(getjoints(num));
+    }
+    // 2 s of motion streamed with 50 ms steps
+    auto normal = resample(recording, 50ms, 1.);
+    auto fast = resample(recording, 50ms, 2.);
+    auto slow = resample(recording, 50ms, 0.5);
+    EXPECT_EQ(normal.size(), 41);
+    EXPECT_EQ(fast.size(), 21);
+    EXPECT_EQ(slow.size(), 81);
+
+    auto first = roarmm2::forward(recording.decode().front());
+    auto last = roarmm2::forward(recording.decode().back());
+    for (size_t axis{}; axis < first.size(); axis++)
+    {
+        EXPECT_NEAR(normal.front()[axis], first[axis], 1e-6);
+        EXPECT_NEAR(fast.back()[axis], last[axis], 1e-6);
+        EXPECT_NEAR(slow[2][axis], normal[1][axis], 1e-6);
+    }
+    EXPECT_THROW(resample(recording, 50ms, 3.), std::runtime_error);
+}
+
+TEST_F(TestTeach, IsLinearTrajectoryPassingWaypoints)
+{
+    Trajectory trajectory({{0., 0., 0., 0.}, {10., 20., 30., 1.}}, 100ms,
+                          interpolation::linear);
+    auto point = trajectory.sample(25ms);
+    EXPECT_NEAR(point[0], 2.5, 1e-9);
+    EXPECT_NEAR(point[1], 5., 1e-9);
+    EXPECT_NEAR(point[2], 7.5, 1e-9);
+    EXPECT_NEAR(point[3], 0.25, 1e-9);
+}
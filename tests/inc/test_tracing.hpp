@@ -0,0 +1,81 @@
+#include "robot/tracing.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+
+class TestTracing : public testing::Test
+{
+  public:
+    const std::filesystem::path path{std::filesystem::temp_directory_path() /
+                                     "robot-ut-trace.json"};
+
+    ~TestTracing()
+    {
+        std::filesystem::remove(path);
+    }
+
+    std::string readtrace() const
+    {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    static size_t countof(const std::string& text, const std::string& what)
+    {
+        size_t num{};
+        for (auto pos = text.find(what); pos != std::string::npos;
+             pos = text.find(what, pos + 1))
+        {
+            num++;
+        }
+        return num;
+    }
+};
+
+TEST_F(TestTracing, AreSpansWrittenPerThread)
+{
+    ASSERT_TRUE(tracing::start(path));
+    EXPECT_FALSE(tracing::start(path));
+    {
+        std::jthread worker([]() {
+            tracing::setthreadname("worker");
+            for (int32_t num{}; num < 3; num++)
+            {
+                tracing::Span span("work", "test", num);
+            }
+        });
+        tracing::Span span("main", "test");
+    }
+    auto stats = tracing::stop();
+    EXPECT_EQ(stats.events, 4);
+    EXPECT_EQ(stats.dropped, 0);
+
+    auto trace = readtrace();
+    EXPECT_TRUE(trace.starts_with("{\"displayTimeUnit\":\"ms\","
+                                  "\"traceEvents\":["));
+    EXPECT_TRUE(trace.ends_with("]}\n"));
+    EXPECT_EQ(countof(trace, "\"name\":\"work\",\"cat\":\"test\""), 3);
+    EXPECT_EQ(countof(trace, "\"name\":\"main\""), 1);
+    EXPECT_EQ(countof(trace, "\"args\":{\"value\":2}"), 1);
+    EXPECT_EQ(countof(trace, "\"args\":{\"name\":\"worker\"}"), 1);
+}
+
+TEST_F(TestTracing, IsNothingRecordedWhenNotActive)
+{
+    {
+        tracing::Span span("idle", "test");
+    }
+    ASSERT_TRUE(tracing::start(path));
+    auto stats = tracing::stop();
+    EXPECT_EQ(stats.events, 0);
+    EXPECT_EQ(readtrace(), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}\n");
+}
@@ -0,0 +1,94 @@
+#include "robot/trajectory.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace robot;
+using namespace std::chrono_literals;
+
+class TestTrajectory : public testing::Test
+{
+  public:
+    // setpoints are sent from streamer thread only, read once stream is done
+    std::vector<waypoint_t> setpoints;
+    std::chrono::milliseconds delay{};
+
+    Streamer streamer{[this](const waypoint_t& point) {
+                          setpoints.push_back(point);
+                          std::this_thread::sleep_for(delay);
+                      },
+                      10ms};
+};
+
+TEST_F(TestTrajectory, IsMinimumJerkProfileFollowed)
+{
+    Trajectory trajectory({{0., 0., 0., 0.}, {100., -100., 50., 1.}, {}},
+                          100ms);
+    EXPECT_EQ(trajectory.duration(), 200ms);
+    auto start = trajectory.sample(0ms);
+    auto middle = trajectory.sample(50ms);
+    auto waypoint = trajectory.sample(100ms);
+    EXPECT_NEAR(start[0], 0., 1e-9);
+    EXPECT_NEAR(middle[0], 50., 1e-9);
+    EXPECT_NEAR(middle[1], -50., 1e-9);
+    EXPECT_NEAR(middle[3], 0.5, 1e-9);
+    EXPECT_NEAR(waypoint[0], 100., 1e-9);
+    EXPECT_EQ(trajectory.sample(1s), waypoint_t{});
+
+    // comes to rest at waypoints and is symmetric around midpoint
+    EXPECT_LT(trajectory.sample(1ms)[0], 0.01);
+    EXPECT_GT(trajectory.sample(99ms)[0], 99.99);
+    EXPECT_GT(trajectory.sample(101ms)[0], 99.99);
+    EXPECT_NEAR(trajectory.sample(20ms)[0] + trajectory.sample(80ms)[0], 100.,
+                1e-9);
+    // and moves faster than linear one in the middle of segment
+    EXPECT_GT(trajectory.sample(60ms)[0] - trajectory.sample(40ms)[0], 20.);
+
+    EXPECT_THROW(Trajectory({}, 100ms), std::runtime_error);
+    EXPECT_THROW(Trajectory({{}}, 0ms), std::runtime_error);
+}
+
+TEST_F(TestTrajectory, IsTrajectoryStreamedAtRate)
+{
+    Trajectory trajectory({{0., 0., 0., 0.}, {100., 0., 0., 0.}}, 100ms);
+    auto done = streamer.run(trajectory, {});
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    auto stats = done.get();
+    EXPECT_EQ(stats.missed, 0);
+    EXPECT_EQ(stats.setpoints, 11);
+    ASSERT_EQ(setpoints.size(), stats.setpoints);
+    EXPECT_EQ(setpoints.back(), (waypoint_t{100., 0., 0., 0.}));
+    EXPECT_LE(stats.maxjitter, 10ms);
+}
+
+TEST_F(TestTrajectory, AreMissedDeadlinesSkipped)
+{
+    delay = 25ms;
+    Trajectory trajectory({{0., 0., 0., 0.}, {100., 0., 0., 0.}}, 200ms);
+    auto started = std::chrono::steady_clock::now();
+    auto done = streamer.run(trajectory, {});
+    ASSERT_EQ(done.wait_for(1s), std::future_status::ready);
+    auto stats = done.get();
+    EXPECT_GT(stats.missed, 0);
+    EXPECT_LT(stats.setpoints, 21);
+    EXPECT_GE(stats.setpoints + stats.missed, 21);
+    // stream keeps its duration instead of being stretched by slow sends
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 300ms);
+    EXPECT_EQ(setpoints.back(), (waypoint_t{100., 0., 0., 0.}));
+}
+
+TEST_F(TestTrajectory, IsStoppedStreamEnded)
+{
+    std::stop_source stop;
+    Trajectory trajectory({{0., 0., 0., 0.}, {100., 0., 0., 0.}}, 1s);
+    auto done = streamer.run(trajectory, stop.get_token());
+    std::this_thread::sleep_for(50ms);
+    stop.request_stop();
+    ASSERT_EQ(done.wait_for(100ms), std::future_status::ready);
+    EXPECT_LT(done.get().setpoints, 10);
+    EXPECT_LT(setpoints.back()[0], 100.);
+}
@@ -1,4 +1,27 @@
+#include "test_behavior.hpp"
+#include "test_callqueue.hpp"
+#include "test_choreography.hpp"
+#include "test_commandchannel.hpp"
 #include "test_common.hpp"
+#include "test_convergence.hpp"
+#include "test_executor.hpp"
+#include "test_feedback.hpp"
+#include "test_feedbackdecoder.hpp"
+#include "test_filteredlog.hpp"
+#include "test_fleet.hpp"
+#include "test_kinematics.hpp"
+#include "test_ledeffects.hpp"
+#include "test_motiondetect.hpp"
+#include "test_pooledhttp.hpp"
+#include "test_requeststats.hpp"
+#include "test_serial.hpp"
+#include "test_shadowstate.hpp"
+#include "test_simulator.hpp"
+#include "test_speechcache.hpp"
+#include "test_speechqueue.hpp"
+#include "test_teach.hpp"
+#include "test_trajectory.hpp"
+#include "test_tracing.hpp"
 
 #include "gtest/gtest.h"
 